@@ -0,0 +1,24 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D screenTexture;
+uniform vec2 direction; // one texel of the target along the blur axis
+
+// One axis of a separable Gaussian (PostChain::BlurTaps): the center texel, then bilinear
+// taps on both sides that each cover two texels
+const int MAX_TAPS = 8;
+uniform int taps;
+uniform float weights[MAX_TAPS];
+uniform float offsets[MAX_TAPS];
+
+void main()
+{
+    vec3 sum = texture(screenTexture, TexCoords).rgb * weights[0];
+    for (int i = 1; i < taps; i++) {
+        sum += texture(screenTexture, TexCoords + direction * offsets[i]).rgb * weights[i];
+        sum += texture(screenTexture, TexCoords - direction * offsets[i]).rgb * weights[i];
+    }
+    FragColor = vec4(sum, 1.0);
+}
@@ -0,0 +1,80 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D screenTexture;
+uniform vec2 texelSize;
+
+// Fast approximate anti-aliasing after FXAA 3.11's quality preset: find the local edge from luma
+// contrast, walk along it both ways to where it ends, and blend across it by how far the pixel is
+// from the nearer end (plus a subpixel term for single-pixel features).
+
+const float EDGE_THRESHOLD = 0.125;    // contrast relative to the local maximum
+const float EDGE_THRESHOLD_MIN = 0.0312; // ignore darks below this absolute contrast
+const float SUBPIXEL = 0.75;
+const int SEARCH_STEPS = 10;
+const float STEP_SIZES[SEARCH_STEPS] = float[](1.0, 1.0, 1.0, 1.0, 1.5, 2.0, 2.0, 2.0, 4.0, 8.0);
+
+float luma(vec3 c) { return dot(c, vec3(0.299, 0.587, 0.114)); }
+float lumaAt(vec2 uv) { return luma(texture(screenTexture, uv).rgb); }
+float lumaOffset(float x, float y) { return lumaAt(TexCoords + vec2(x, y) * texelSize); }
+
+void main()
+{
+    vec3 color = texture(screenTexture, TexCoords).rgb;
+    float m = luma(color);
+    float n = lumaOffset(0.0, 1.0), s = lumaOffset(0.0, -1.0), e = lumaOffset(1.0, 0.0), w = lumaOffset(-1.0, 0.0);
+    float hi = max(max(max(n, s), max(e, w)), m), lo = min(min(min(n, s), min(e, w)), m);
+    float range = hi - lo;
+    if (range < max(EDGE_THRESHOLD_MIN, hi * EDGE_THRESHOLD)) { FragColor = vec4(color, 1.0); return; }
+
+    float ne = lumaOffset(1.0, 1.0), nw = lumaOffset(-1.0, 1.0), se = lumaOffset(1.0, -1.0), sw = lumaOffset(-1.0, -1.0);
+
+    // Subpixel aliasing: how much the pixel stands out from its 3x3 average
+    float average = (2.0 * (n + s + e + w) + ne + nw + se + sw) / 12.0;
+    float subpixel = clamp(abs(average - m) / range, 0.0, 1.0);
+    subpixel = smoothstep(0.0, 1.0, subpixel);
+    subpixel = subpixel * subpixel * SUBPIXEL;
+
+    // Horizontal edge (luma changes vertically) or vertical edge
+    float horizontal = abs(nw + sw - 2.0 * w) + 2.0 * abs(n + s - 2.0 * m) + abs(ne + se - 2.0 * e);
+    float vertical = abs(nw + ne - 2.0 * n) + 2.0 * abs(w + e - 2.0 * m) + abs(sw + se - 2.0 * s);
+    bool isHorizontal = horizontal >= vertical;
+
+    // Which side of the pixel the edge is on
+    float positive = isHorizontal ? n : e, negative = isHorizontal ? s : w;
+    float gradientPositive = abs(positive - m), gradientNegative = abs(negative - m);
+    float stepLength = isHorizontal ? texelSize.y : texelSize.x;
+    float opposite = positive;
+    float gradient = gradientPositive;
+    if (gradientNegative > gradientPositive) { stepLength = -stepLength; opposite = negative; gradient = gradientNegative; }
+
+    // Walk along the edge, half a texel over, until the luma pair differs from the start
+    vec2 uv = TexCoords;
+    if (isHorizontal) uv.y += stepLength * 0.5; else uv.x += stepLength * 0.5;
+    vec2 along = isHorizontal ? vec2(texelSize.x, 0.0) : vec2(0.0, texelSize.y);
+    float edgeLuma = 0.5 * (m + opposite);
+    float threshold = gradient * 0.25;
+    vec2 uvP = uv + along, uvN = uv - along;
+    float endP = lumaAt(uvP) - edgeLuma, endN = lumaAt(uvN) - edgeLuma;
+    bool doneP = abs(endP) >= threshold, doneN = abs(endN) >= threshold;
+    for (int i = 1; i < SEARCH_STEPS && !(doneP && doneN); i++) {
+        if (!doneP) { uvP += along * STEP_SIZES[i]; endP = lumaAt(uvP) - edgeLuma; doneP = abs(endP) >= threshold; }
+        if (!doneN) { uvN -= along * STEP_SIZES[i]; endN = lumaAt(uvN) - edgeLuma; doneN = abs(endN) >= threshold; }
+    }
+
+    // Blend toward the opposite side by the distance to the nearer end of the edge, if that end
+    // is the one the pixel's side of the edge runs into
+    float distP = isHorizontal ? uvP.x - TexCoords.x : uvP.y - TexCoords.y;
+    float distN = isHorizontal ? TexCoords.x - uvN.x : TexCoords.y - uvN.y;
+    bool nearerP = distP < distN;
+    float nearestEnd = nearerP ? endP : endN;
+    bool centerBelow = m - edgeLuma < 0.0;
+    float offset = (nearestEnd < 0.0) != centerBelow ? 0.5 - min(distP, distN) / (distP + distN) : 0.0;
+    offset = max(offset, subpixel);
+
+    vec2 finalUv = TexCoords;
+    if (isHorizontal) finalUv.y += offset * stepLength; else finalUv.x += offset * stepLength;
+    FragColor = vec4(texture(screenTexture, finalUv).rgb, 1.0);
+}
@@ -0,0 +1,85 @@
+#ifndef ALLOCTRACKER_H
+#define ALLOCTRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Heap allocation counters fed by the global operator new/delete replacements in
+// src/alloc_tracker.cpp; only include this header in executables that link that file.
+// malloc/free are not hooked, so C libraries and ImGui (which allocates through malloc) do not
+// show up; every C++ container and std::string does.
+struct AllocCounters {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0; // requested by the allocations
+};
+
+// Whole process / the calling thread only, since startup
+AllocCounters AllocProcessCounters();
+AllocCounters AllocThreadCounters();
+
+// Call-site sampling: every Nth operator new on any thread stores its return address in a fixed
+// ring (the hook must not allocate itself). 0 turns it off.
+void AllocSetSampleRate(uint32_t everyN);
+uint32_t AllocSampleRate();
+// Copies out and clears the samples taken since the last call; returns how many were dropped
+// because the ring was full
+struct AllocSample { const void *address; size_t size; };
+size_t AllocTakeSamples(std::vector<AllocSample> &out);
+
+// Per-frame view for the frame loop's thread: BeginFrame()/EndFrame() bracket a frame, the
+// numbers of the last closed frame are in LastFrame(). Sampled sites accumulate until ClearSites().
+class AllocTracker {
+public:
+    struct Site {
+        const void *address;
+        uint64_t samples = 0, bytes = 0;
+        std::string symbol; // filled in by Symbolize()
+    };
+
+    static AllocTracker& Get() {
+        static AllocTracker instance;
+        return instance;
+    }
+
+    void BeginFrame() { frameStart = AllocThreadCounters(); }
+
+    void EndFrame() {
+        AllocCounters now = AllocThreadCounters();
+        last.allocations = now.allocations - frameStart.allocations;
+        last.frees = now.frees - frameStart.frees;
+        last.bytes = now.bytes - frameStart.bytes;
+        if (last.allocations > peakAllocations) peakAllocations = last.allocations;
+        // Done after the counters were read: whatever this allocates is not charged to a frame
+        if (AllocSampleRate() == 0) return;
+        samples.clear();
+        AllocTakeSamples(samples);
+        for (const AllocSample &s : samples) {
+            size_t i = 0;
+            while (i < sites.size() && sites[i].address != s.address) i++;
+            if (i == sites.size()) { Site site; site.address = s.address; sites.push_back(site); }
+            sites[i].samples++;
+            sites[i].bytes += s.size;
+        }
+    }
+
+    const AllocCounters& LastFrame() const { return last; }
+    uint64_t PeakFrameAllocations() const { return peakAllocations; }
+    void ResetPeak() { peakAllocations = 0; }
+
+    const std::vector<Site>& Sites() const { return sites; }
+    void ClearSites() { sites.clear(); }
+    // Resolves Site::symbol for sites that do not have one yet (outside the frame, it allocates)
+    void Symbolize();
+
+private:
+    AllocCounters frameStart, last;
+    uint64_t peakAllocations = 0;
+    std::vector<AllocSample> samples;
+    std::vector<Site> sites;
+
+    AllocTracker() {}
+};
+#endif
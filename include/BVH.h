@@ -0,0 +1,365 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define BVH_USE_SSE 1
+#endif
+
+// Result of a ray query against a mesh or model
+struct RayHit {
+    float distance = FLT_MAX;   // ray parameter of the hit (world units when the world ray is normalized)
+    unsigned int triangle = 0;  // triangle index, i.e. indices[3 * triangle ...]
+    unsigned int mesh = 0;      // index of the mesh inside its Model
+    glm::vec2 barycentric = glm::vec2(0.0f); // weights of the triangle's 2nd and 3rd vertex
+};
+
+// Triangle BVH built once per mesh at import time.
+// Built as a binary tree with binned SAH and then collapsed into 4-wide nodes whose
+// child bounds are stored SoA, so one SIMD slab test checks all four children at once.
+// Only a triangle permutation is stored; vertex data stays in the owning Mesh.
+class MeshBVH {
+public:
+    struct alignas(16) Node {
+        float minX[4], minY[4], minZ[4];
+        float maxX[4], maxY[4], maxZ[4];
+        int32_t  child[4]; // inner: node index, leaf: first entry in triIndices, empty: -1
+        uint32_t count[4]; // leaf: triangle count, inner/empty: 0
+    };
+
+    std::vector<Node>     nodes;
+    std::vector<uint32_t> triIndices;
+    uint32_t              depth = 0; // levels of 4-wide nodes, bounds the traversal stack
+
+    template <typename VertexT>
+    void Build(const std::vector<VertexT> &vertices, const std::vector<unsigned int> &indices) {
+        nodes.clear();
+        triIndices.clear();
+        depth = 0;
+        size_t triCount = indices.size() / 3;
+        if (triCount == 0) return;
+
+        std::vector<PrimRef> prims(triCount);
+        for (size_t i = 0; i < triCount; i++) {
+            const glm::vec3 &a = vertices[indices[3 * i + 0]].Position;
+            const glm::vec3 &b = vertices[indices[3 * i + 1]].Position;
+            const glm::vec3 &c = vertices[indices[3 * i + 2]].Position;
+            prims[i].bmin = glm::min(a, glm::min(b, c));
+            prims[i].bmax = glm::max(a, glm::max(b, c));
+            prims[i].centroid = (prims[i].bmin + prims[i].bmax) * 0.5f;
+        }
+
+        triIndices.resize(triCount);
+        for (size_t i = 0; i < triCount; i++) triIndices[i] = static_cast<uint32_t>(i);
+
+        std::vector<BuildNode> tree;
+        tree.reserve(triCount * 2 / MAX_LEAF_SIZE + 1);
+        buildBinary(tree, prims, 0, static_cast<uint32_t>(triCount), 0);
+
+        nodes.reserve(tree.size() / 2 + 1);
+        if (tree[0].count > 0) {
+            // Whole mesh fits in one leaf: still emit a root node so traversal has a single shape
+            nodes.emplace_back();
+            clearNode(nodes[0]);
+            setSlot(nodes[0], 0, tree[0]);
+            depth = 1;
+        } else {
+            collapse(tree, 0, 1);
+        }
+    }
+
+    // Returns true and fills 'hit' when the ray hits a triangle closer than hit.distance.
+    // The ray must be in the mesh's local space; dir does not need to be normalized.
+    template <typename VertexT>
+    bool Intersect(const glm::vec3 &origin, const glm::vec3 &dir,
+                   const std::vector<VertexT> &vertices, const std::vector<unsigned int> &indices,
+                   RayHit &hit) const {
+        if (nodes.empty()) return false;
+
+        glm::vec3 invDir;
+        for (int a = 0; a < 3; a++) {
+            float d = dir[a];
+            if (std::fabs(d) < 1e-20f) d = std::copysign(1e-20f, d);
+            invDir[a] = 1.0f / d;
+        }
+
+        // Each level leaves at most three siblings behind, so 3 * depth + 1 entries always suffice;
+        // trees too deep for the inline stack (see MAX_SAH_DEPTH) get one on the heap
+        struct StackEntry { int32_t index; uint32_t count; float tNear; };
+        StackEntry inlineStack[STACK_SIZE];
+        std::vector<StackEntry> heapStack;
+        StackEntry *stack = inlineStack;
+        if (3 * depth + 1 > STACK_SIZE) { heapStack.resize(3 * depth + 1); stack = heapStack.data(); }
+        int stackSize = 0;
+        stack[stackSize++] = { 0, 0, 0.0f };
+
+        bool found = false;
+        while (stackSize > 0) {
+            StackEntry entry = stack[--stackSize];
+            if (entry.tNear > hit.distance) continue;
+
+            if (entry.count > 0) {
+                for (uint32_t i = entry.index; i < entry.index + entry.count; i++) {
+                    uint32_t tri = triIndices[i];
+                    float t, u, v;
+                    if (intersectTriangle(origin, dir,
+                                          vertices[indices[3 * tri + 0]].Position,
+                                          vertices[indices[3 * tri + 1]].Position,
+                                          vertices[indices[3 * tri + 2]].Position, t, u, v)
+                        && t < hit.distance) {
+                        hit.distance = t;
+                        hit.triangle = tri;
+                        hit.barycentric = glm::vec2(u, v);
+                        found = true;
+                    }
+                }
+                continue;
+            }
+
+            const Node &node = nodes[entry.index];
+            float tNear[4];
+            int hitMask = intersectChildren(node, origin, invDir, hit.distance, tNear);
+            if (!hitMask) continue;
+
+            // Push hit children far-to-near so the nearest one is popped first
+            int order[4], n = 0;
+            for (int i = 0; i < 4; i++) {
+                if (!(hitMask & (1 << i)) || node.child[i] < 0) continue;
+                int j = n++;
+                while (j > 0 && tNear[order[j - 1]] < tNear[i]) { order[j] = order[j - 1]; j--; }
+                order[j] = i;
+            }
+            for (int k = 0; k < n; k++) {
+                int i = order[k];
+                stack[stackSize++] = { node.child[i], node.count[i], tNear[i] };
+            }
+        }
+        return found;
+    }
+
+private:
+    static const uint32_t MAX_LEAF_SIZE = 4;
+    static const int SAH_BINS = 16;
+    static const uint32_t STACK_SIZE = 128;
+    // Binned SAH past this depth gives way to median splits by count, which halve the range each
+    // level: unevenly spaced geometry can otherwise make SAH peel off a few triangles at a time
+    static const int MAX_SAH_DEPTH = 40;
+
+    struct PrimRef {
+        glm::vec3 bmin, bmax, centroid;
+    };
+
+    struct BuildNode {
+        glm::vec3 bmin, bmax;
+        uint32_t left, right;  // children in the binary tree (inner nodes)
+        uint32_t first, count; // range in triIndices (leaves, count > 0)
+    };
+
+    static float surfaceArea(const glm::vec3 &bmin, const glm::vec3 &bmax) {
+        glm::vec3 e = glm::max(bmax - bmin, glm::vec3(0.0f));
+        return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+    }
+
+    uint32_t buildBinary(std::vector<BuildNode> &tree, const std::vector<PrimRef> &prims, uint32_t first, uint32_t count, int level) {
+        uint32_t index = static_cast<uint32_t>(tree.size());
+        tree.emplace_back();
+
+        glm::vec3 bmin(FLT_MAX), bmax(-FLT_MAX), cmin(FLT_MAX), cmax(-FLT_MAX);
+        for (uint32_t i = first; i < first + count; i++) {
+            const PrimRef &p = prims[triIndices[i]];
+            bmin = glm::min(bmin, p.bmin); bmax = glm::max(bmax, p.bmax);
+            cmin = glm::min(cmin, p.centroid); cmax = glm::max(cmax, p.centroid);
+        }
+        tree[index].bmin = bmin;
+        tree[index].bmax = bmax;
+        tree[index].first = first;
+        tree[index].count = count;
+
+        if (count <= 1) return index;
+
+        // Binned SAH over all three axes
+        int bestAxis = -1, bestSplit = 0;
+        float bestCost = FLT_MAX;
+        for (int axis = 0; axis < 3 && level < MAX_SAH_DEPTH; axis++) {
+            float extent = cmax[axis] - cmin[axis];
+            if (extent <= 0.0f) continue;
+            float scale = SAH_BINS / extent;
+
+            uint32_t binCount[SAH_BINS] = {};
+            glm::vec3 binMin[SAH_BINS], binMax[SAH_BINS];
+            for (int b = 0; b < SAH_BINS; b++) { binMin[b] = glm::vec3(FLT_MAX); binMax[b] = glm::vec3(-FLT_MAX); }
+            for (uint32_t i = first; i < first + count; i++) {
+                const PrimRef &p = prims[triIndices[i]];
+                int b = std::min(SAH_BINS - 1, static_cast<int>((p.centroid[axis] - cmin[axis]) * scale));
+                binCount[b]++;
+                binMin[b] = glm::min(binMin[b], p.bmin);
+                binMax[b] = glm::max(binMax[b], p.bmax);
+            }
+
+            // Sweep from the right to get the area/count of every right partition
+            float rightArea[SAH_BINS];
+            uint32_t rightCount[SAH_BINS];
+            glm::vec3 rmin(FLT_MAX), rmax(-FLT_MAX);
+            uint32_t rc = 0;
+            for (int b = SAH_BINS - 1; b > 0; b--) {
+                rmin = glm::min(rmin, binMin[b]); rmax = glm::max(rmax, binMax[b]);
+                rc += binCount[b];
+                rightArea[b] = surfaceArea(rmin, rmax);
+                rightCount[b] = rc;
+            }
+            glm::vec3 lmin(FLT_MAX), lmax(-FLT_MAX);
+            uint32_t lc = 0;
+            for (int b = 0; b < SAH_BINS - 1; b++) {
+                lmin = glm::min(lmin, binMin[b]); lmax = glm::max(lmax, binMax[b]);
+                lc += binCount[b];
+                if (lc == 0 || rightCount[b + 1] == 0) continue;
+                float cost = lc * surfaceArea(lmin, lmax) + rightCount[b + 1] * rightArea[b + 1];
+                if (cost < bestCost) { bestCost = cost; bestAxis = axis; bestSplit = b; }
+            }
+        }
+
+        uint32_t mid;
+        if (bestAxis >= 0) {
+            float leafCost = count * surfaceArea(bmin, bmax);
+            if (count <= MAX_LEAF_SIZE && leafCost <= bestCost) return index;
+
+            float scale = SAH_BINS / (cmax[bestAxis] - cmin[bestAxis]);
+            uint32_t *begin = triIndices.data() + first;
+            uint32_t *split = std::partition(begin, begin + count, [&](uint32_t t) {
+                int b = std::min(SAH_BINS - 1, static_cast<int>((prims[t].centroid[bestAxis] - cmin[bestAxis]) * scale));
+                return b <= bestSplit;
+            });
+            mid = static_cast<uint32_t>(split - triIndices.data());
+        } else {
+            // Too deep, or all centroids coincide: median split by count along the widest axis
+            if (count <= MAX_LEAF_SIZE) return index;
+            glm::vec3 extent = cmax - cmin;
+            int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+            uint32_t *begin = triIndices.data() + first;
+            std::nth_element(begin, begin + count / 2, begin + count, [&](uint32_t a, uint32_t b) {
+                return prims[a].centroid[axis] < prims[b].centroid[axis];
+            });
+            mid = first + count / 2;
+        }
+
+        tree[index].count = 0;
+        uint32_t left = buildBinary(tree, prims, first, mid - first, level + 1);
+        uint32_t right = buildBinary(tree, prims, mid, first + count - mid, level + 1);
+        tree[index].left = left;
+        tree[index].right = right;
+        return index;
+    }
+
+    static void clearNode(Node &node) {
+        for (int i = 0; i < 4; i++) {
+            node.minX[i] = node.minY[i] = node.minZ[i] = FLT_MAX;
+            node.maxX[i] = node.maxY[i] = node.maxZ[i] = -FLT_MAX;
+            node.child[i] = -1;
+            node.count[i] = 0;
+        }
+    }
+
+    static void setSlot(Node &node, int slot, const BuildNode &b) {
+        node.minX[slot] = b.bmin.x; node.minY[slot] = b.bmin.y; node.minZ[slot] = b.bmin.z;
+        node.maxX[slot] = b.bmax.x; node.maxY[slot] = b.bmax.y; node.maxZ[slot] = b.bmax.z;
+        if (b.count > 0) {
+            node.child[slot] = static_cast<int32_t>(b.first);
+            node.count[slot] = b.count;
+        }
+    }
+
+    // Pulls grandchildren up until each 4-wide node holds up to four binary subtrees
+    uint32_t collapse(const std::vector<BuildNode> &tree, uint32_t binaryIndex, uint32_t level) {
+        depth = std::max(depth, level);
+        uint32_t children[4] = { tree[binaryIndex].left, tree[binaryIndex].right };
+        int n = 2;
+        while (n < 4) {
+            int best = -1;
+            float bestArea = -1.0f;
+            for (int i = 0; i < n; i++) {
+                const BuildNode &c = tree[children[i]];
+                if (c.count > 0) continue;
+                float area = surfaceArea(c.bmin, c.bmax);
+                if (area > bestArea) { bestArea = area; best = i; }
+            }
+            if (best < 0) break;
+            uint32_t expanded = children[best];
+            children[best] = tree[expanded].left;
+            children[n++] = tree[expanded].right;
+        }
+
+        uint32_t index = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+        clearNode(nodes[index]);
+        for (int i = 0; i < n; i++) {
+            const BuildNode &c = tree[children[i]];
+            setSlot(nodes[index], i, c);
+            if (c.count == 0) {
+                uint32_t childNode = collapse(tree, children[i], level + 1);
+                nodes[index].child[i] = static_cast<int32_t>(childNode);
+            }
+        }
+        return index;
+    }
+
+    // Slab test of the ray against all four child boxes; returns a bit mask of hits
+    static int intersectChildren(const Node &node, const glm::vec3 &o, const glm::vec3 &invDir, float tMax, float tNear[4]) {
+#ifdef BVH_USE_SSE
+        __m128 ox = _mm_set1_ps(o.x), oy = _mm_set1_ps(o.y), oz = _mm_set1_ps(o.z);
+        __m128 ix = _mm_set1_ps(invDir.x), iy = _mm_set1_ps(invDir.y), iz = _mm_set1_ps(invDir.z);
+        __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minX), ox), ix);
+        __m128 t2x = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxX), ox), ix);
+        __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minY), oy), iy);
+        __m128 t2y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxY), oy), iy);
+        __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minZ), oz), iz);
+        __m128 t2z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxZ), oz), iz);
+        __m128 tmin = _mm_max_ps(_mm_max_ps(_mm_min_ps(t1x, t2x), _mm_min_ps(t1y, t2y)),
+                                 _mm_max_ps(_mm_min_ps(t1z, t2z), _mm_setzero_ps()));
+        __m128 tmax = _mm_min_ps(_mm_min_ps(_mm_max_ps(t1x, t2x), _mm_max_ps(t1y, t2y)),
+                                 _mm_min_ps(_mm_max_ps(t1z, t2z), _mm_set1_ps(tMax)));
+        _mm_storeu_ps(tNear, tmin);
+        return _mm_movemask_ps(_mm_cmple_ps(tmin, tmax));
+#else
+        int mask = 0;
+        for (int i = 0; i < 4; i++) {
+            float t1x = (node.minX[i] - o.x) * invDir.x, t2x = (node.maxX[i] - o.x) * invDir.x;
+            float t1y = (node.minY[i] - o.y) * invDir.y, t2y = (node.maxY[i] - o.y) * invDir.y;
+            float t1z = (node.minZ[i] - o.z) * invDir.z, t2z = (node.maxZ[i] - o.z) * invDir.z;
+            float tmin = std::max(std::max(std::min(t1x, t2x), std::min(t1y, t2y)), std::max(std::min(t1z, t2z), 0.0f));
+            float tmax = std::min(std::min(std::max(t1x, t2x), std::max(t1y, t2y)), std::min(std::max(t1z, t2z), tMax));
+            tNear[i] = tmin;
+            if (tmin <= tmax) mask |= 1 << i;
+        }
+        return mask;
+#endif
+    }
+
+    // Moller-Trumbore, two-sided
+    static bool intersectTriangle(const glm::vec3 &o, const glm::vec3 &d,
+                                  const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2,
+                                  float &t, float &u, float &v) {
+        glm::vec3 e1 = v1 - v0;
+        glm::vec3 e2 = v2 - v0;
+        glm::vec3 p = glm::cross(d, e2);
+        float det = glm::dot(e1, p);
+        if (std::fabs(det) < 1e-12f) return false;
+        float invDet = 1.0f / det;
+        glm::vec3 s = o - v0;
+        u = glm::dot(s, p) * invDet;
+        if (u < 0.0f || u > 1.0f) return false;
+        glm::vec3 q = glm::cross(s, e1);
+        v = glm::dot(d, q) * invDet;
+        if (v < 0.0f || u + v > 1.0f) return false;
+        t = glm::dot(e2, q) * invDet;
+        return t > 0.0f;
+    }
+};
+#endif
@@ -84,6 +84,13 @@ public:
         updateCameraVectors();
     }
 
+    // Sets the Euler angles directly (camera path playback)
+    void SetOrientation(float yaw, float pitch) {
+        Yaw = yaw;
+        Pitch = pitch;
+        updateCameraVectors();
+    }
+
 private:
     // Calculates the front vector from the Camera's (updated) Euler Angles
     void updateCameraVectors() {
@@ -0,0 +1,76 @@
+#ifndef CAMERAPATH_H
+#define CAMERAPATH_H
+
+#include "Camera.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <string>
+#include <fstream>
+
+// A recorded camera flythrough: timestamped position/orientation keys, linearly interpolated.
+// The editor records one while flying; the benchmark plays it back at a fixed rate.
+//
+//   CAMERA_PATH 1
+//   <keyCount>
+//   <time> <px> <py> <pz> <yaw> <pitch> <zoom>     one line per key
+struct CameraKey {
+    float time;
+    glm::vec3 position;
+    float yaw, pitch, zoom;
+};
+
+class CameraPath {
+public:
+    std::vector<CameraKey> keys;
+
+    float Duration() const { return keys.empty() ? 0.0f : keys.back().time; }
+
+    void Clear() { keys.clear(); }
+
+    void Record(float time, const Camera &camera) {
+        CameraKey key = { time, camera.Position, camera.Yaw, camera.Pitch, camera.Zoom };
+        keys.push_back(key);
+    }
+
+    // Places the camera at time t (clamped to the path)
+    void Sample(float t, Camera &camera) const {
+        if (keys.empty()) return;
+        size_t i = 0;
+        while (i + 1 < keys.size() && keys[i + 1].time <= t) i++;
+        const CameraKey &a = keys[i];
+        const CameraKey &b = keys[i + 1 < keys.size() ? i + 1 : i];
+        float span = b.time - a.time;
+        float f = span > 0.0f ? glm::clamp((t - a.time) / span, 0.0f, 1.0f) : 0.0f;
+        camera.Position = glm::mix(a.position, b.position, f);
+        camera.Zoom = glm::mix(a.zoom, b.zoom, f);
+        camera.SetOrientation(glm::mix(a.yaw, b.yaw, f), glm::mix(a.pitch, b.pitch, f));
+    }
+
+    bool Save(const std::string &path) const {
+        std::ofstream out(path);
+        if (!out.is_open()) return false;
+        out << "CAMERA_PATH 1\n" << keys.size() << "\n";
+        for (const CameraKey &k : keys)
+            out << k.time << " " << k.position.x << " " << k.position.y << " " << k.position.z << " " << k.yaw << " " << k.pitch << " " << k.zoom << "\n";
+        return out.good();
+    }
+
+    bool Load(const std::string &path) {
+        std::ifstream in(path);
+        if (!in.is_open()) return false;
+        std::string tag; int version = 0; size_t count = 0;
+        in >> tag >> version >> count;
+        if (tag != "CAMERA_PATH" || version != 1 || !in) return false;
+        keys.clear();
+        keys.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            CameraKey k;
+            if (!(in >> k.time >> k.position.x >> k.position.y >> k.position.z >> k.yaw >> k.pitch >> k.zoom)) return false;
+            keys.push_back(k);
+        }
+        return true;
+    }
+};
+#endif
@@ -0,0 +1,67 @@
+#ifndef COLORLUT_H
+#define COLORLUT_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "PostChain.h"
+#include "Profiler.h"
+#include "Log.h"
+
+#include <vector>
+
+// 3D texture holding what a run of per-pixel post effects does to every color, sampled with
+// trilinear filtering by screen.frag. Bake() re-evaluates the effects on the CPU only when their
+// settings changed (PostChain::ColorHash); otherwise it is a hash and a compare.
+// Like the rest of the renderer's GL objects, the texture lives as long as the context.
+class ColorLut {
+public:
+    static const int SIZE = 32; // texels per axis; the effects are smooth enough for 32^3
+
+    GLuint Texture() const { return texture; }
+
+    // Makes the LUT hold effects[begin, end) of 'chain'; true if it had to be rebaked
+    bool Bake(const PostChain &chain, int begin, int end) {
+        uint32_t hash = chain.ColorHash(begin, end);
+        if (texture && hash == bakedHash) return false;
+        PROFILE_SCOPE("Bake color LUT");
+        uint64_t start = Profiler::Now();
+        texels.resize((size_t)SIZE * SIZE * SIZE * 3);
+        unsigned char *out = texels.data();
+        for (int b = 0; b < SIZE; b++)
+            for (int g = 0; g < SIZE; g++)
+                for (int r = 0; r < SIZE; r++) {
+                    glm::vec3 c = glm::vec3((float)r, (float)g, (float)b) / (float)(SIZE - 1);
+                    for (int i = begin; i < end; i++) {
+                        const PostEffect &e = chain.effects[i];
+                        if (e.enabled && PostEffectPerPixel(e.type)) c = ApplyPostColor(e, c);
+                    }
+                    *out++ = (unsigned char)(c.r * 255.0f + 0.5f);
+                    *out++ = (unsigned char)(c.g * 255.0f + 0.5f);
+                    *out++ = (unsigned char)(c.b * 255.0f + 0.5f);
+                }
+        if (!texture) {
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_3D, texture);
+            glTexImage3D(GL_TEXTURE_3D, 0, GL_RGB8, SIZE, SIZE, SIZE, 0, GL_RGB, GL_UNSIGNED_BYTE, texels.data());
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        } else {
+            glBindTexture(GL_TEXTURE_3D, texture);
+            glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, SIZE, SIZE, SIZE, GL_RGB, GL_UNSIGNED_BYTE, texels.data());
+        }
+        glBindTexture(GL_TEXTURE_3D, 0);
+        bakedHash = hash;
+        LOG_DEBUG("Baked %d^3 color LUT in %.2f ms", SIZE, (Profiler::Now() - start) / 1e6);
+        return true;
+    }
+
+private:
+    GLuint texture = 0;
+    uint32_t bakedHash = 0;
+    std::vector<unsigned char> texels; // kept, so a rebake does not allocate
+};
+#endif
@@ -0,0 +1,63 @@
+#ifndef DYNAMICRESOLUTION_H
+#define DYNAMICRESOLUTION_H
+
+#include <algorithm>
+#include <cmath>
+
+// Chooses the scene's render scale from measured GPU frame time.
+//  - GPU time is smoothed (the timer results are two frames old and noisy anyway) and compared
+//    with the budget. GPU cost is taken to follow the pixel count, i.e. the square of the scale.
+//  - Hysteresis: the scale drops as soon as the smoothed time is over budget, but only rises once
+//    it is below RAISE_BELOW of it, and then aims at that level, so it does not oscillate around
+//    the budget. After a change, and after being enabled, it waits COOLDOWN frames for the new
+//    cost to show up in the average.
+//  - A sample counts as at most MAX_OVER times the budget, so a hitch (or a bogus timer result)
+//    reads as one bad frame rather than as a hundred.
+//  - The scale moves in STEP increments, so the render size changes a few times, not every frame.
+// The renderer keeps its targets at full size and draws the scene into a corner of them, so a
+// scale change never reallocates anything.
+class DynamicResolution {
+public:
+    static constexpr float STEP = 0.05f;
+    static constexpr float RAISE_BELOW = 0.85f;
+    static const int COOLDOWN = 6;
+    static constexpr float MAX_OVER = 4.0f;
+
+    bool enabled = false;
+    float budgetMs = 16.0f;               // GPU time to aim for
+    float minScale = 0.5f, maxScale = 1.0f;
+    float sharpness = 0.2f;               // upscale sharpening in stops: 0 = strongest
+
+    float Scale() const { return enabled ? scale : 1.0f; }
+    float SmoothedGpuMs() const { return smoothed; }
+
+    // Feeds the GPU time of a finished frame (0 = no result) and returns the scale for the next one
+    float Update(float gpuMs) {
+        minScale = std::min(std::max(minScale, 0.25f), 1.0f);
+        maxScale = std::min(std::max(maxScale, minScale), 1.0f);
+        if (!enabled) { scale = maxScale; smoothed = 0.0f; cooldown = COOLDOWN; return 1.0f; }
+        scale = std::min(std::max(scale, minScale), maxScale);
+        if (gpuMs <= 0.0f) return scale;
+        gpuMs = std::min(gpuMs, budgetMs * MAX_OVER);
+        smoothed = smoothed > 0.0f ? smoothed + (gpuMs - smoothed) * 0.25f : gpuMs;
+        if (cooldown > 0) { cooldown--; return scale; }
+
+        float target = scale;
+        if (smoothed > budgetMs) target = scale * std::sqrt(budgetMs / smoothed);
+        else if (smoothed < budgetMs * RAISE_BELOW) target = std::min(scale * std::sqrt(budgetMs * RAISE_BELOW / smoothed), scale + 2.0f * STEP);
+        // Rounded down either way: never above what the estimate allows
+        target = std::floor(target / STEP + 1e-3f) * STEP;
+        target = std::min(std::max(target, minScale), maxScale);
+        if (std::fabs(target - scale) >= STEP * 0.5f) {
+            scale = target;
+            cooldown = COOLDOWN;
+        }
+        return scale;
+    }
+
+private:
+    float scale = 1.0f;
+    float smoothed = 0.0f;
+    int cooldown = 0;
+};
+#endif
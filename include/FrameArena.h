@@ -0,0 +1,110 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// Linear allocator for data that lives for one frame: labels, uniform names, scratch arrays.
+// Alloc() bumps a pointer; Reset() at the start of the next frame releases everything at once.
+// A frame that runs out of space spills into extra blocks; the next Reset() replaces them with
+// one block big enough for the whole frame, so a steady-state frame never touches the heap.
+// Not thread-safe: one arena per thread that needs one (FrameArena::Get() is the frame loop's).
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity = 256 * 1024) { grow(capacity); }
+    ~FrameArena() { for (Block &b : blocks) std::free(b.data); }
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    static FrameArena& Get() {
+        static FrameArena instance;
+        return instance;
+    }
+
+    void* Alloc(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        Block *b = &blocks.back();
+        size_t at = (b->used + alignment - 1) & ~(alignment - 1);
+        if (at + size > b->size) {
+            grow(std::max(b->size * 2, size + alignment));
+            b = &blocks.back();
+            at = (b->used + alignment - 1) & ~(alignment - 1);
+        }
+        b->used = at + size;
+        used += size;
+        return b->data + at;
+    }
+
+    // Uninitialized storage for n objects of a trivially destructible type
+    template <typename T> T* AllocArray(size_t n) { return static_cast<T*>(Alloc(n * sizeof(T), alignof(T))); }
+
+    // printf into the arena; the string is valid until the next Reset()
+    const char* Format(const char *format, ...) {
+        va_list args, copy;
+        va_start(args, format);
+        va_copy(copy, args);
+        int length = std::vsnprintf(nullptr, 0, format, copy);
+        va_end(copy);
+        char *text = static_cast<char*>(Alloc(length > 0 ? (size_t)length + 1 : 1, 1));
+        if (length > 0) std::vsnprintf(text, (size_t)length + 1, format, args);
+        else text[0] = '\0';
+        va_end(args);
+        return text;
+    }
+
+    void Reset() {
+        if (used > highWater) highWater = used;
+        if (blocks.size() > 1) {
+            // Last frame overflowed: one block with room for all of it
+            size_t total = 0;
+            for (Block &b : blocks) { total += b.size; std::free(b.data); }
+            blocks.clear();
+            grow(total);
+        }
+        blocks.back().used = 0;
+        used = 0;
+    }
+
+    size_t Used() const { return used; }
+    size_t HighWater() const { return used > highWater ? used : highWater; }
+    size_t Capacity() const { size_t total = 0; for (const Block &b : blocks) total += b.size; return total; }
+
+private:
+    struct Block {
+        char *data;
+        size_t size, used;
+    };
+    std::vector<Block> blocks;
+    size_t used = 0, highWater = 0;
+
+    void grow(size_t size) {
+        Block b = { static_cast<char*>(std::malloc(size)), size, 0 };
+        if (!b.data) throw std::bad_alloc();
+        blocks.reserve(8);
+        blocks.push_back(b);
+    }
+};
+
+// Standard allocator over an arena, for containers that only live for the frame:
+//   std::vector<int, FrameAllocator<int>> ids{FrameAllocator<int>(arena)};
+// deallocate() is a no-op, memory comes back with the arena's Reset().
+template <typename T>
+struct FrameAllocator {
+    typedef T value_type;
+    FrameArena *arena;
+
+    explicit FrameAllocator(FrameArena &arena = FrameArena::Get()) : arena(&arena) {}
+    template <typename U> FrameAllocator(const FrameAllocator<U> &other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return arena->AllocArray<T>(n); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U> bool operator==(const FrameAllocator<U> &other) const { return arena == other.arena; }
+    template <typename U> bool operator!=(const FrameAllocator<U> &other) const { return arena != other.arena; }
+};
+#endif
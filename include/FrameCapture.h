@@ -0,0 +1,712 @@
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include "GLCapture.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+#include <fstream>
+
+// Records one frame of GL calls into a .glcap file for MyGraphicsEngineReplay.
+//  - Request() arms the capture; the next BeginFrame()/EndFrame() pair is recorded.
+//  - While recording, the glad entry points in FRAME_CAPTURE_CALLS point at the wrappers below
+//    (on top of the ENGINE_GL_STATS wrappers, if those are installed). Outside a capture nothing
+//    is wrapped, so the feature costs nothing until it is used.
+//  - Objects are snapshotted the first time the frame references them (see GLCapture.h).
+// Calls made through other loaders (ImGui's backend) and the profilers' queries are not recorded.
+#define FRAME_CAPTURE_CALLS(X) \
+    X(BindFramebuffer) X(Viewport) X(ClearColor) X(Clear) X(ClearBufferfv) X(ClearBufferuiv) \
+    X(Enable) X(Disable) X(DepthFunc) X(DepthMask) X(CullFace) X(BlendFunc) X(ColorMask) X(PolygonMode) \
+    X(UseProgram) X(ActiveTexture) X(BindTexture) X(BindVertexArray) X(BindBuffer) \
+    X(DrawBuffer) X(DrawBuffers) X(ReadBuffer) X(GetUniformLocation) \
+    X(Uniform1i) X(Uniform1ui) X(Uniform1f) X(Uniform2f) X(Uniform3f) X(Uniform4f) \
+    X(Uniform1iv) X(Uniform1fv) X(Uniform2fv) X(Uniform3fv) X(Uniform4fv) X(UniformMatrix3fv) X(UniformMatrix4fv) \
+    X(DrawArrays) X(DrawElements) X(DrawArraysInstanced) X(DrawElementsInstanced) \
+    X(BufferData) X(BufferSubData) X(TexImage2D) X(TexSubImage2D) X(TexParameteri) X(GenerateMipmap) \
+    X(ReadPixels) X(FenceSync) X(ClientWaitSync) X(DeleteSync) X(MapBufferRange) X(UnmapBuffer) \
+    X(BlitFramebuffer) X(Scissor)
+
+class FrameCapture {
+public:
+    static FrameCapture& Get() {
+        static FrameCapture instance;
+        return instance;
+    }
+
+    // Captures the next frame into 'path'; width/height describe the window framebuffer (0)
+    void Request(const std::string &path, int width, int height) {
+        requestPath = path;
+        requestWidth = width; requestHeight = height;
+    }
+    bool Pending() const { return !requestPath.empty(); }
+    bool Active() const { return active; }
+    size_t LastCallCount() const { return lastCalls; }
+
+    void BeginFrame() {
+        if (requestPath.empty() || active) return;
+        path = requestPath; requestPath.clear();
+        width = requestWidth; height = requestHeight;
+        out.data.clear();
+        textures.clear(); buffers.clear(); vertexArrays.clear(); programs.clear(); renderbuffers.clear(); framebuffers.clear();
+        for (int i = 0; i < MAP_TARGETS; i++) maps[i] = Mapping();
+        calls = 0;
+#define FRAME_CAPTURE_INSTALL(name) real.name = glad_gl##name; glad_gl##name = capture_##name;
+        FRAME_CAPTURE_CALLS(FRAME_CAPTURE_INSTALL)
+#undef FRAME_CAPTURE_INSTALL
+        active = true;
+        writeState();
+    }
+
+    // Restores the entry points and writes the file; true if a capture was written
+    bool EndFrame() {
+        if (!active) return false;
+#define FRAME_CAPTURE_RESTORE(name) glad_gl##name = real.name;
+        FRAME_CAPTURE_CALLS(FRAME_CAPTURE_RESTORE)
+#undef FRAME_CAPTURE_RESTORE
+        active = false;
+        lastCalls = calls;
+
+        std::ofstream file(path, std::ios::binary);
+        CaptureWriter header;
+        header.raw(GL_CAPTURE_MAGIC, 4);
+        header.u32(GL_CAPTURE_VERSION);
+        header.u32((uint32_t)width); header.u32((uint32_t)height);
+        const GLubyte *renderer = glGetString(GL_RENDERER);
+        header.str(renderer ? (const char*)renderer : "");
+        file.write((const char*)header.data.data(), header.data.size());
+        file.write((const char*)out.data.data(), out.data.size());
+        bool ok = file.good();
+        if (ok) LOG_INFO("Captured %zu GL calls (%.1f MB) to %s", calls, (header.data.size() + out.data.size()) / (1024.0 * 1024.0), path.c_str());
+        else LOG_ERROR("Failed to write frame capture %s", path.c_str());
+        out.data.clear();
+        out.data.shrink_to_fit();
+        return ok;
+    }
+
+private:
+    struct RealCalls {
+#define FRAME_CAPTURE_POINTER(name) decltype(glad_gl##name) name;
+        FRAME_CAPTURE_CALLS(FRAME_CAPTURE_POINTER)
+#undef FRAME_CAPTURE_POINTER
+    };
+    // Write mappings are recorded with their contents at glUnmapBuffer
+    struct Mapping {
+        void *pointer = nullptr;
+        GLsizeiptr length = 0;
+        GLbitfield access = 0;
+    };
+    static const int MAP_TARGETS = 4;
+
+    // The snapshot code below calls 'real' for wrapped entry points so it never records itself
+    RealCalls real;
+    std::string requestPath, path;
+    int requestWidth = 0, requestHeight = 0, width = 0, height = 0;
+    bool active = false;
+    size_t calls = 0, lastCalls = 0;
+    CaptureWriter out;
+    std::set<GLuint> textures, buffers, vertexArrays, programs, renderbuffers, framebuffers;
+    Mapping maps[MAP_TARGETS];
+
+    FrameCapture() {}
+
+    static int mapSlot(GLenum target) {
+        switch (target) {
+        case GL_ARRAY_BUFFER: return 0;
+        case GL_ELEMENT_ARRAY_BUFFER: return 1;
+        case GL_PIXEL_PACK_BUFFER: return 2;
+        case GL_PIXEL_UNPACK_BUFFER: return 3;
+        default: return -1;
+        }
+    }
+
+    static GLint getInt(GLenum pname) { GLint v = 0; glGetIntegerv(pname, &v); return v; }
+
+    // --- Snapshots, written the first time an object is referenced ---
+
+    void touchTexture(GLenum target, GLuint name) {
+        if (name == 0 || !textures.insert(name).second) return;
+        if (target != GL_TEXTURE_2D && target != GL_TEXTURE_CUBE_MAP && target != GL_TEXTURE_3D) return; // not used by the engine, replayed as unknown
+        GLint previous = getInt(target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_BINDING_CUBE_MAP : target == GL_TEXTURE_3D ? GL_TEXTURE_BINDING_3D : GL_TEXTURE_BINDING_2D);
+        GLint packBuffer = getInt(GL_PIXEL_PACK_BUFFER_BINDING), packAlignment = getInt(GL_PACK_ALIGNMENT);
+        real.BindTexture(target, name);
+        real.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+        GLenum face0 = target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : target;
+        GLint internalFormat = 0, w = 0, h = 0, depth = 1;
+        glGetTexLevelParameteriv(face0, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+        glGetTexLevelParameteriv(face0, 0, GL_TEXTURE_WIDTH, &w);
+        glGetTexLevelParameteriv(face0, 0, GL_TEXTURE_HEIGHT, &h);
+        if (target == GL_TEXTURE_3D) glGetTexLevelParameteriv(face0, 0, GL_TEXTURE_DEPTH, &depth);
+        const GLenum params[] = { GL_TEXTURE_MIN_FILTER, GL_TEXTURE_MAG_FILTER, GL_TEXTURE_WRAP_S, GL_TEXTURE_WRAP_T, GL_TEXTURE_WRAP_R,
+                                  GL_TEXTURE_COMPARE_MODE, GL_TEXTURE_COMPARE_FUNC };
+        GLint values[7];
+        for (int i = 0; i < 7; i++) glGetTexParameteriv(target, params[i], &values[i]);
+        GLfloat border[4];
+        glGetTexParameterfv(target, GL_TEXTURE_BORDER_COLOR, border);
+
+        size_t at = out.Begin(CAP_TEXTURE);
+        out.u32(name); out.u32(target);
+        out.i32(internalFormat); out.i32(w); out.i32(h);
+        for (int i = 0; i < 7; i++) out.i32(values[i]);
+        for (int i = 0; i < 4; i++) out.f32(border[i]);
+        GLenum format, type; int bytesPerPixel;
+        CaptureTextureTransfer(internalFormat, format, type, bytesPerPixel);
+        int faces = target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+        std::vector<uint8_t> pixels;
+        if (target == GL_TEXTURE_3D) {
+            // One "face" per slice
+            size_t slice = w > 0 && h > 0 ? CaptureImageBytes(w, h, format, type, 1) : 0;
+            pixels.resize(slice * depth);
+            if (!pixels.empty()) glGetTexImage(GL_TEXTURE_3D, 0, format, type, pixels.data());
+            out.u32(depth);
+            for (int z = 0; z < depth; z++) out.blob(pixels.data() + slice * z, slice);
+            faces = 0;
+        } else out.u32(faces);
+        for (int f = 0; f < faces; f++) {
+            pixels.resize(w > 0 && h > 0 ? CaptureImageBytes(w, h, format, type, 1) : 0);
+            if (!pixels.empty()) glGetTexImage(target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + f : GL_TEXTURE_2D, 0, format, type, pixels.data());
+            out.blob(pixels.data(), pixels.size());
+        }
+        out.End(at);
+
+        glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+        real.BindBuffer(GL_PIXEL_PACK_BUFFER, packBuffer);
+        real.BindTexture(target, previous);
+    }
+
+    void touchBuffer(GLuint name) {
+        if (name == 0 || !buffers.insert(name).second) return;
+        GLint previous = getInt(GL_COPY_READ_BUFFER); // doubles as its binding query in 3.3
+        real.BindBuffer(GL_COPY_READ_BUFFER, name);
+        GLint size = 0, usage = GL_STATIC_DRAW, mapped = 0;
+        glGetBufferParameteriv(GL_COPY_READ_BUFFER, GL_BUFFER_SIZE, &size);
+        glGetBufferParameteriv(GL_COPY_READ_BUFFER, GL_BUFFER_USAGE, &usage);
+        glGetBufferParameteriv(GL_COPY_READ_BUFFER, GL_BUFFER_MAPPED, &mapped);
+        std::vector<uint8_t> data((size_t)size);
+        if (size > 0 && !mapped) glGetBufferSubData(GL_COPY_READ_BUFFER, 0, size, data.data()); // mapped buffers can't be read: zeros
+        real.BindBuffer(GL_COPY_READ_BUFFER, previous);
+
+        size_t at = out.Begin(CAP_BUFFER);
+        out.u32(name); out.i32(usage);
+        out.blob(data.data(), data.size());
+        out.End(at);
+    }
+
+    void touchVertexArray(GLuint name) {
+        if (name == 0 || !vertexArrays.insert(name).second) return;
+        GLint previous = getInt(GL_VERTEX_ARRAY_BINDING);
+        real.BindVertexArray(name);
+        GLint attribCount = std::min(getInt(GL_MAX_VERTEX_ATTRIBS), 16);
+        GLint elementBuffer = getInt(GL_ELEMENT_ARRAY_BUFFER_BINDING);
+        const GLenum params[] = { GL_VERTEX_ATTRIB_ARRAY_ENABLED, GL_VERTEX_ATTRIB_ARRAY_SIZE, GL_VERTEX_ATTRIB_ARRAY_TYPE, GL_VERTEX_ATTRIB_ARRAY_NORMALIZED,
+                                  GL_VERTEX_ATTRIB_ARRAY_INTEGER, GL_VERTEX_ATTRIB_ARRAY_STRIDE, GL_VERTEX_ATTRIB_ARRAY_DIVISOR, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING };
+        struct Attrib { GLint index, values[8]; void *offset; };
+        std::vector<Attrib> attribs;
+        for (GLint i = 0; i < attribCount; i++) {
+            Attrib a;
+            a.index = i;
+            for (int p = 0; p < 8; p++) glGetVertexAttribiv(i, params[p], &a.values[p]);
+            glGetVertexAttribPointerv(i, GL_VERTEX_ATTRIB_ARRAY_POINTER, &a.offset);
+            if (a.values[0] || a.values[7]) attribs.push_back(a);
+        }
+        real.BindVertexArray(previous);
+
+        touchBuffer(elementBuffer);
+        for (const Attrib &a : attribs) touchBuffer(a.values[7]);
+        size_t at = out.Begin(CAP_VERTEX_ARRAY);
+        out.u32(name); out.u32(elementBuffer);
+        out.u32((uint32_t)attribs.size());
+        for (const Attrib &a : attribs) {
+            out.u32(a.index);
+            for (int p = 0; p < 8; p++) out.i32(a.values[p]);
+            out.u64((uint64_t)(uintptr_t)a.offset);
+        }
+        out.End(at);
+    }
+
+    // Components and scalar kind (0 float, 1 int, 2 uint) of a uniform type
+    static int uniformComponents(GLenum type, int &kind) {
+        kind = 0;
+        switch (type) {
+        case GL_FLOAT: return 1;
+        case GL_FLOAT_VEC2: return 2;
+        case GL_FLOAT_VEC3: return 3;
+        case GL_FLOAT_VEC4: case GL_FLOAT_MAT2: return 4;
+        case GL_FLOAT_MAT3: return 9;
+        case GL_FLOAT_MAT4: return 16;
+        case GL_UNSIGNED_INT: kind = 2; return 1;
+        case GL_INT_VEC2: case GL_BOOL_VEC2: kind = 1; return 2;
+        case GL_INT_VEC3: case GL_BOOL_VEC3: kind = 1; return 3;
+        case GL_INT_VEC4: case GL_BOOL_VEC4: kind = 1; return 4;
+        default: kind = 1; return 1; // int, bool and samplers
+        }
+    }
+
+    void touchProgram(GLuint name) {
+        if (name == 0 || !programs.insert(name).second) return;
+        size_t at = out.Begin(CAP_PROGRAM);
+        out.u32(name);
+        // Shaders stay attached after glDeleteShader, so their sources are still there
+        GLuint shaders[8]; GLsizei shaderCount = 0;
+        glGetAttachedShaders(name, 8, &shaderCount, shaders);
+        out.u32((uint32_t)shaderCount);
+        for (GLsizei i = 0; i < shaderCount; i++) {
+            GLint type = 0, length = 0;
+            glGetShaderiv(shaders[i], GL_SHADER_TYPE, &type);
+            glGetShaderiv(shaders[i], GL_SHADER_SOURCE_LENGTH, &length);
+            std::string source(length > 0 ? (size_t)length : 1, '\0');
+            glGetShaderSource(shaders[i], (GLsizei)source.size(), NULL, &source[0]);
+            source.resize(std::strlen(source.c_str()));
+            out.u32((uint32_t)type);
+            out.str(source);
+        }
+        // Current uniform values, array elements one by one
+        GLint uniformCount = 0, maxLength = 0;
+        glGetProgramiv(name, GL_ACTIVE_UNIFORMS, &uniformCount);
+        glGetProgramiv(name, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::vector<char> buffer((size_t)maxLength + 1);
+        CaptureWriter uniforms;
+        uint32_t written = 0;
+        for (GLint u = 0; u < uniformCount; u++) {
+            GLint size = 0; GLenum type = 0;
+            glGetActiveUniform(name, (GLuint)u, (GLsizei)buffer.size(), NULL, &size, &type, buffer.data());
+            std::string base = buffer.data();
+            if (size > 1 && base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0) base.resize(base.size() - 3);
+            for (GLint e = 0; e < size; e++) {
+                std::string element = size > 1 ? base + "[" + std::to_string(e) + "]" : base;
+                GLint location = real.GetUniformLocation(name, element.c_str());
+                if (location < 0) continue; // uniform block member
+                int kind;
+                int components = uniformComponents(type, kind);
+                uint32_t words[16] = {};
+                if (kind == 0) glGetUniformfv(name, location, (GLfloat*)words);
+                else if (kind == 1) glGetUniformiv(name, location, (GLint*)words);
+                else glGetUniformuiv(name, location, (GLuint*)words);
+                uniforms.str(element); uniforms.u32(type); uniforms.i32(location);
+                uniforms.u32((uint32_t)components);
+                uniforms.raw(words, components * 4);
+                written++;
+            }
+        }
+        out.u32(written);
+        out.raw(uniforms.data.data(), uniforms.data.size());
+        out.End(at);
+    }
+
+    void touchRenderbuffer(GLuint name) {
+        if (name == 0 || !renderbuffers.insert(name).second) return;
+        GLint previous = getInt(GL_RENDERBUFFER_BINDING);
+        glBindRenderbuffer(GL_RENDERBUFFER, name);
+        GLint format = 0, w = 0, h = 0, samples = 0;
+        glGetRenderbufferParameteriv(GL_RENDERBUFFER, GL_RENDERBUFFER_INTERNAL_FORMAT, &format);
+        glGetRenderbufferParameteriv(GL_RENDERBUFFER, GL_RENDERBUFFER_WIDTH, &w);
+        glGetRenderbufferParameteriv(GL_RENDERBUFFER, GL_RENDERBUFFER_HEIGHT, &h);
+        glGetRenderbufferParameteriv(GL_RENDERBUFFER, GL_RENDERBUFFER_SAMPLES, &samples);
+        glBindRenderbuffer(GL_RENDERBUFFER, previous);
+
+        size_t at = out.Begin(CAP_RENDERBUFFER);
+        out.u32(name); out.i32(format); out.i32(w); out.i32(h); out.i32(samples);
+        out.End(at);
+    }
+
+    void touchFramebuffer(GLuint name) {
+        if (name == 0 || !framebuffers.insert(name).second) return;
+        GLint previousDraw = getInt(GL_DRAW_FRAMEBUFFER_BINDING), previousRead = getInt(GL_READ_FRAMEBUFFER_BINDING);
+        real.BindFramebuffer(GL_FRAMEBUFFER, name);
+        struct Attachment { GLenum attachment; GLint type, object, level, face; };
+        std::vector<Attachment> attachments;
+        GLenum points[CAPTURE_COLOR_ATTACHMENTS + 2];
+        for (int i = 0; i < CAPTURE_COLOR_ATTACHMENTS; i++) points[i] = GL_COLOR_ATTACHMENT0 + i;
+        points[CAPTURE_COLOR_ATTACHMENTS] = GL_DEPTH_ATTACHMENT;
+        points[CAPTURE_COLOR_ATTACHMENTS + 1] = GL_STENCIL_ATTACHMENT;
+        for (GLenum point : points) {
+            Attachment a = { point, GL_NONE, 0, 0, 0 };
+            glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, point, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &a.type);
+            if (a.type == GL_NONE) continue;
+            glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, point, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME, &a.object);
+            if (a.type == GL_TEXTURE) {
+                glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, point, GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_LEVEL, &a.level);
+                glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, point, GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_CUBE_MAP_FACE, &a.face);
+            }
+            attachments.push_back(a);
+        }
+        GLint drawBuffers[CAPTURE_COLOR_ATTACHMENTS];
+        for (int i = 0; i < CAPTURE_COLOR_ATTACHMENTS; i++) drawBuffers[i] = getInt(GL_DRAW_BUFFER0 + i);
+        GLint readBuffer = getInt(GL_READ_BUFFER);
+        real.BindFramebuffer(GL_DRAW_FRAMEBUFFER, previousDraw);
+        real.BindFramebuffer(GL_READ_FRAMEBUFFER, previousRead);
+
+        for (const Attachment &a : attachments) {
+            if (a.type == GL_TEXTURE) touchTexture(a.face ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D, a.object);
+            else touchRenderbuffer(a.object);
+        }
+        size_t at = out.Begin(CAP_FRAMEBUFFER);
+        out.u32(name);
+        out.u32((uint32_t)attachments.size());
+        for (const Attachment &a : attachments) {
+            out.u32(a.attachment); out.u32(a.type); out.u32(a.object); out.i32(a.level);
+            out.u32(a.face ? a.face : GL_TEXTURE_2D);
+        }
+        for (int i = 0; i < CAPTURE_COLOR_ATTACHMENTS; i++) out.u32(drawBuffers[i]);
+        out.u32(readBuffer);
+        out.End(at);
+    }
+
+    // Frame-start state, plus snapshots of everything it binds
+    void writeState() {
+        GLint viewport[4]; glGetIntegerv(GL_VIEWPORT, viewport);
+        GLfloat clearColor[4]; glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+        const GLenum caps[] = { GL_DEPTH_TEST, GL_CULL_FACE, GL_BLEND, GL_SCISSOR_TEST, GL_STENCIL_TEST, GL_POLYGON_OFFSET_FILL, GL_FRAMEBUFFER_SRGB };
+        GLboolean colorMask[4]; glGetBooleanv(GL_COLOR_WRITEMASK, colorMask);
+        GLint polygonMode[2]; glGetIntegerv(GL_POLYGON_MODE, polygonMode);
+        GLint activeTexture = getInt(GL_ACTIVE_TEXTURE);
+        GLint units[CAPTURE_TEXTURE_UNITS][2];
+        for (int i = 0; i < CAPTURE_TEXTURE_UNITS; i++) {
+            real.ActiveTexture(GL_TEXTURE0 + i);
+            units[i][0] = getInt(GL_TEXTURE_BINDING_2D);
+            units[i][1] = getInt(GL_TEXTURE_BINDING_CUBE_MAP);
+        }
+        real.ActiveTexture(activeTexture);
+        GLint program = getInt(GL_CURRENT_PROGRAM), vertexArray = getInt(GL_VERTEX_ARRAY_BINDING);
+        GLint drawFramebuffer = getInt(GL_DRAW_FRAMEBUFFER_BINDING), readFramebuffer = getInt(GL_READ_FRAMEBUFFER_BINDING);
+        GLint arrayBuffer = getInt(GL_ARRAY_BUFFER_BINDING), packBuffer = getInt(GL_PIXEL_PACK_BUFFER_BINDING), unpackBuffer = getInt(GL_PIXEL_UNPACK_BUFFER_BINDING);
+
+        for (int i = 0; i < CAPTURE_TEXTURE_UNITS; i++) { touchTexture(GL_TEXTURE_2D, units[i][0]); touchTexture(GL_TEXTURE_CUBE_MAP, units[i][1]); }
+        touchProgram(program); touchVertexArray(vertexArray);
+        touchFramebuffer(drawFramebuffer); touchFramebuffer(readFramebuffer);
+        touchBuffer(arrayBuffer); touchBuffer(packBuffer); touchBuffer(unpackBuffer);
+
+        size_t at = out.Begin(CAP_STATE);
+        for (int i = 0; i < 4; i++) out.i32(viewport[i]);
+        for (int i = 0; i < 4; i++) out.f32(clearColor[i]);
+        out.u32(7);
+        for (GLenum cap : caps) { out.u32(cap); out.u32(glIsEnabled(cap)); }
+        out.i32(getInt(GL_DEPTH_FUNC)); out.i32(getInt(GL_DEPTH_WRITEMASK));
+        out.i32(getInt(GL_CULL_FACE_MODE)); out.i32(getInt(GL_FRONT_FACE));
+        out.i32(getInt(GL_BLEND_SRC_RGB)); out.i32(getInt(GL_BLEND_DST_RGB));
+        for (int i = 0; i < 4; i++) out.u32(colorMask[i]);
+        out.i32(polygonMode[0]);
+        out.i32(getInt(GL_PACK_ALIGNMENT)); out.i32(getInt(GL_UNPACK_ALIGNMENT));
+        out.u32(program); out.u32(vertexArray); out.u32(drawFramebuffer); out.u32(readFramebuffer);
+        out.u32(arrayBuffer); out.u32(packBuffer); out.u32(unpackBuffer);
+        out.u32(activeTexture);
+        out.u32(CAPTURE_TEXTURE_UNITS);
+        for (int i = 0; i < CAPTURE_TEXTURE_UNITS; i++) { out.u32(units[i][0]); out.u32(units[i][1]); }
+        out.End(at);
+    }
+
+    // --- Call records ---
+
+    size_t beginCall(CaptureOp op) { calls++; return out.Begin(op); }
+
+    static GLint boundBuffer(GLenum binding) { GLint v = 0; glGetIntegerv(binding, &v); return v; }
+
+    static void APIENTRY capture_BindFramebuffer(GLenum target, GLuint framebuffer) {
+        FrameCapture &c = Get();
+        c.touchFramebuffer(framebuffer);
+        size_t at = c.beginCall(CAP_BindFramebuffer); c.out.u32(target); c.out.u32(framebuffer); c.out.End(at);
+        c.real.BindFramebuffer(target, framebuffer);
+    }
+    static void APIENTRY capture_Viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_Viewport); c.out.i32(x); c.out.i32(y); c.out.i32(width); c.out.i32(height); c.out.End(at);
+        c.real.Viewport(x, y, width, height);
+    }
+    static void APIENTRY capture_ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_ClearColor); c.out.f32(r); c.out.f32(g); c.out.f32(b); c.out.f32(a); c.out.End(at);
+        c.real.ClearColor(r, g, b, a);
+    }
+    static void APIENTRY capture_Clear(GLbitfield mask) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_Clear); c.out.u32(mask); c.out.End(at);
+        c.real.Clear(mask);
+    }
+    static void APIENTRY capture_ClearBufferfv(GLenum buffer, GLint drawbuffer, const GLfloat *value) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_ClearBufferfv); c.out.u32(buffer); c.out.i32(drawbuffer);
+        c.out.raw(value, (buffer == GL_COLOR ? 4 : 1) * sizeof(GLfloat)); c.out.End(at);
+        c.real.ClearBufferfv(buffer, drawbuffer, value);
+    }
+    static void APIENTRY capture_ClearBufferuiv(GLenum buffer, GLint drawbuffer, const GLuint *value) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_ClearBufferuiv); c.out.u32(buffer); c.out.i32(drawbuffer); c.out.raw(value, 4 * sizeof(GLuint)); c.out.End(at);
+        c.real.ClearBufferuiv(buffer, drawbuffer, value);
+    }
+    static void APIENTRY capture_Enable(GLenum cap) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_Enable); c.out.u32(cap); c.out.End(at);
+        c.real.Enable(cap);
+    }
+    static void APIENTRY capture_Disable(GLenum cap) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_Disable); c.out.u32(cap); c.out.End(at);
+        c.real.Disable(cap);
+    }
+    static void APIENTRY capture_DepthFunc(GLenum func) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_DepthFunc); c.out.u32(func); c.out.End(at);
+        c.real.DepthFunc(func);
+    }
+    static void APIENTRY capture_DepthMask(GLboolean flag) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_DepthMask); c.out.u32(flag); c.out.End(at);
+        c.real.DepthMask(flag);
+    }
+    static void APIENTRY capture_CullFace(GLenum mode) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_CullFace); c.out.u32(mode); c.out.End(at);
+        c.real.CullFace(mode);
+    }
+    static void APIENTRY capture_BlendFunc(GLenum sfactor, GLenum dfactor) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_BlendFunc); c.out.u32(sfactor); c.out.u32(dfactor); c.out.End(at);
+        c.real.BlendFunc(sfactor, dfactor);
+    }
+    static void APIENTRY capture_ColorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_ColorMask); c.out.u32(r); c.out.u32(g); c.out.u32(b); c.out.u32(a); c.out.End(at);
+        c.real.ColorMask(r, g, b, a);
+    }
+    static void APIENTRY capture_PolygonMode(GLenum face, GLenum mode) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_PolygonMode); c.out.u32(face); c.out.u32(mode); c.out.End(at);
+        c.real.PolygonMode(face, mode);
+    }
+    static void APIENTRY capture_UseProgram(GLuint program) {
+        FrameCapture &c = Get();
+        c.touchProgram(program);
+        size_t at = c.beginCall(CAP_UseProgram); c.out.u32(program); c.out.End(at);
+        c.real.UseProgram(program);
+    }
+    static void APIENTRY capture_ActiveTexture(GLenum texture) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_ActiveTexture); c.out.u32(texture); c.out.End(at);
+        c.real.ActiveTexture(texture);
+    }
+    static void APIENTRY capture_BindTexture(GLenum target, GLuint texture) {
+        FrameCapture &c = Get();
+        c.touchTexture(target, texture);
+        size_t at = c.beginCall(CAP_BindTexture); c.out.u32(target); c.out.u32(texture); c.out.End(at);
+        c.real.BindTexture(target, texture);
+    }
+    static void APIENTRY capture_BindVertexArray(GLuint array) {
+        FrameCapture &c = Get();
+        c.touchVertexArray(array);
+        size_t at = c.beginCall(CAP_BindVertexArray); c.out.u32(array); c.out.End(at);
+        c.real.BindVertexArray(array);
+    }
+    static void APIENTRY capture_BindBuffer(GLenum target, GLuint buffer) {
+        FrameCapture &c = Get();
+        c.touchBuffer(buffer);
+        size_t at = c.beginCall(CAP_BindBuffer); c.out.u32(target); c.out.u32(buffer); c.out.End(at);
+        c.real.BindBuffer(target, buffer);
+    }
+    static void APIENTRY capture_DrawBuffer(GLenum buf) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_DrawBuffer); c.out.u32(buf); c.out.End(at);
+        c.real.DrawBuffer(buf);
+    }
+    static void APIENTRY capture_DrawBuffers(GLsizei n, const GLenum *bufs) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_DrawBuffers); c.out.i32(n);
+        for (GLsizei i = 0; i < n; i++) c.out.u32(bufs[i]);
+        c.out.End(at);
+        c.real.DrawBuffers(n, bufs);
+    }
+    static void APIENTRY capture_ReadBuffer(GLenum src) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_ReadBuffer); c.out.u32(src); c.out.End(at);
+        c.real.ReadBuffer(src);
+    }
+    static GLint APIENTRY capture_GetUniformLocation(GLuint program, const GLchar *name) {
+        FrameCapture &c = Get();
+        c.touchProgram(program);
+        GLint location = c.real.GetUniformLocation(program, name);
+        size_t at = c.beginCall(CAP_GetUniformLocation); c.out.u32(program); c.out.str(name); c.out.i32(location); c.out.End(at);
+        return location;
+    }
+    static void APIENTRY capture_Uniform1i(GLint location, GLint v0) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_Uniform1i); c.out.i32(location); c.out.i32(v0); c.out.End(at);
+        c.real.Uniform1i(location, v0);
+    }
+    static void APIENTRY capture_Uniform1ui(GLint location, GLuint v0) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_Uniform1ui); c.out.i32(location); c.out.u32(v0); c.out.End(at);
+        c.real.Uniform1ui(location, v0);
+    }
+    static void APIENTRY capture_Uniform1f(GLint location, GLfloat v0) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_Uniform1f); c.out.i32(location); c.out.f32(v0); c.out.End(at);
+        c.real.Uniform1f(location, v0);
+    }
+    static void APIENTRY capture_Uniform2f(GLint location, GLfloat v0, GLfloat v1) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_Uniform2f); c.out.i32(location); c.out.f32(v0); c.out.f32(v1); c.out.End(at);
+        c.real.Uniform2f(location, v0, v1);
+    }
+    static void APIENTRY capture_Uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_Uniform3f); c.out.i32(location); c.out.f32(v0); c.out.f32(v1); c.out.f32(v2); c.out.End(at);
+        c.real.Uniform3f(location, v0, v1, v2);
+    }
+    static void APIENTRY capture_Uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_Uniform4f); c.out.i32(location); c.out.f32(v0); c.out.f32(v1); c.out.f32(v2); c.out.f32(v3); c.out.End(at);
+        c.real.Uniform4f(location, v0, v1, v2, v3);
+    }
+    // Vector and matrix uploads share one layout: location, count, transpose, values
+    void uniformArray(CaptureOp op, GLint location, GLsizei count, GLboolean transpose, const void *value, int components) {
+        size_t at = beginCall(op); out.i32(location); out.i32(count); out.u32(transpose);
+        out.raw(value, (size_t)(count > 0 ? count : 0) * components * 4); out.End(at);
+    }
+    static void APIENTRY capture_Uniform1iv(GLint location, GLsizei count, const GLint *value) {
+        Get().uniformArray(CAP_Uniform1iv, location, count, GL_FALSE, value, 1); Get().real.Uniform1iv(location, count, value);
+    }
+    static void APIENTRY capture_Uniform1fv(GLint location, GLsizei count, const GLfloat *value) {
+        Get().uniformArray(CAP_Uniform1fv, location, count, GL_FALSE, value, 1); Get().real.Uniform1fv(location, count, value);
+    }
+    static void APIENTRY capture_Uniform2fv(GLint location, GLsizei count, const GLfloat *value) {
+        Get().uniformArray(CAP_Uniform2fv, location, count, GL_FALSE, value, 2); Get().real.Uniform2fv(location, count, value);
+    }
+    static void APIENTRY capture_Uniform3fv(GLint location, GLsizei count, const GLfloat *value) {
+        Get().uniformArray(CAP_Uniform3fv, location, count, GL_FALSE, value, 3); Get().real.Uniform3fv(location, count, value);
+    }
+    static void APIENTRY capture_Uniform4fv(GLint location, GLsizei count, const GLfloat *value) {
+        Get().uniformArray(CAP_Uniform4fv, location, count, GL_FALSE, value, 4); Get().real.Uniform4fv(location, count, value);
+    }
+    static void APIENTRY capture_UniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) {
+        Get().uniformArray(CAP_UniformMatrix3fv, location, count, transpose, value, 9); Get().real.UniformMatrix3fv(location, count, transpose, value);
+    }
+    static void APIENTRY capture_UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) {
+        Get().uniformArray(CAP_UniformMatrix4fv, location, count, transpose, value, 16); Get().real.UniformMatrix4fv(location, count, transpose, value);
+    }
+    static void APIENTRY capture_DrawArrays(GLenum mode, GLint first, GLsizei count) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_DrawArrays); c.out.u32(mode); c.out.i32(first); c.out.i32(count); c.out.End(at);
+        c.real.DrawArrays(mode, first, count);
+    }
+    static void APIENTRY capture_DrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_DrawElements); c.out.u32(mode); c.out.i32(count); c.out.u32(type); c.out.u64((uint64_t)(uintptr_t)indices); c.out.End(at);
+        c.real.DrawElements(mode, count, type, indices);
+    }
+    static void APIENTRY capture_DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_DrawArraysInstanced); c.out.u32(mode); c.out.i32(first); c.out.i32(count); c.out.i32(instancecount); c.out.End(at);
+        c.real.DrawArraysInstanced(mode, first, count, instancecount);
+    }
+    static void APIENTRY capture_DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_DrawElementsInstanced); c.out.u32(mode); c.out.i32(count); c.out.u32(type); c.out.u64((uint64_t)(uintptr_t)indices); c.out.i32(instancecount); c.out.End(at);
+        c.real.DrawElementsInstanced(mode, count, type, indices, instancecount);
+    }
+    static void APIENTRY capture_BufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_BufferData); c.out.u32(target); c.out.u64((uint64_t)size); c.out.u32(usage);
+        c.out.blob(data, data ? (size_t)size : 0); c.out.End(at);
+        c.real.BufferData(target, size, data, usage);
+    }
+    static void APIENTRY capture_BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_BufferSubData); c.out.u32(target); c.out.u64((uint64_t)offset); c.out.blob(data, (size_t)size); c.out.End(at);
+        c.real.BufferSubData(target, offset, size, data);
+    }
+    // Pixels come from client memory, or are an offset when a pixel unpack buffer is bound
+    void pixelSource(GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels) {
+        bool fromBuffer = boundBuffer(GL_PIXEL_UNPACK_BUFFER_BINDING) != 0;
+        out.u32(fromBuffer);
+        if (fromBuffer) out.u64((uint64_t)(uintptr_t)pixels);
+        else out.blob(pixels, pixels ? CaptureImageBytes(width, height, format, type, getInt(GL_UNPACK_ALIGNMENT)) : 0);
+    }
+    static void APIENTRY capture_TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_TexImage2D);
+        c.out.u32(target); c.out.i32(level); c.out.i32(internalformat); c.out.i32(width); c.out.i32(height); c.out.i32(border); c.out.u32(format); c.out.u32(type);
+        c.pixelSource(width, height, format, type, pixels);
+        c.out.End(at);
+        c.real.TexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+    }
+    static void APIENTRY capture_TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_TexSubImage2D);
+        c.out.u32(target); c.out.i32(level); c.out.i32(xoffset); c.out.i32(yoffset); c.out.i32(width); c.out.i32(height); c.out.u32(format); c.out.u32(type);
+        c.pixelSource(width, height, format, type, pixels);
+        c.out.End(at);
+        c.real.TexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+    }
+    static void APIENTRY capture_TexParameteri(GLenum target, GLenum pname, GLint param) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_TexParameteri); c.out.u32(target); c.out.u32(pname); c.out.i32(param); c.out.End(at);
+        c.real.TexParameteri(target, pname, param);
+    }
+    static void APIENTRY capture_GenerateMipmap(GLenum target) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_GenerateMipmap); c.out.u32(target); c.out.End(at);
+        c.real.GenerateMipmap(target);
+    }
+    static void APIENTRY capture_ReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels) {
+        FrameCapture &c = Get();
+        bool toBuffer = boundBuffer(GL_PIXEL_PACK_BUFFER_BINDING) != 0;
+        size_t at = c.beginCall(CAP_ReadPixels);
+        c.out.i32(x); c.out.i32(y); c.out.i32(width); c.out.i32(height); c.out.u32(format); c.out.u32(type);
+        c.out.u32(toBuffer); c.out.u64(toBuffer ? (uint64_t)(uintptr_t)pixels : 0);
+        c.out.End(at);
+        c.real.ReadPixels(x, y, width, height, format, type, pixels);
+    }
+    static GLsync APIENTRY capture_FenceSync(GLenum condition, GLbitfield flags) {
+        FrameCapture &c = Get();
+        GLsync sync = c.real.FenceSync(condition, flags);
+        size_t at = c.beginCall(CAP_FenceSync); c.out.u32(condition); c.out.u32(flags); c.out.u64((uint64_t)(uintptr_t)sync); c.out.End(at);
+        return sync;
+    }
+    static GLenum APIENTRY capture_ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_ClientWaitSync); c.out.u64((uint64_t)(uintptr_t)sync); c.out.u32(flags); c.out.u64(timeout); c.out.End(at);
+        return c.real.ClientWaitSync(sync, flags, timeout);
+    }
+    static void APIENTRY capture_DeleteSync(GLsync sync) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_DeleteSync); c.out.u64((uint64_t)(uintptr_t)sync); c.out.End(at);
+        c.real.DeleteSync(sync);
+    }
+    static void* APIENTRY capture_MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+        FrameCapture &c = Get();
+        void *pointer = c.real.MapBufferRange(target, offset, length, access);
+        size_t at = c.beginCall(CAP_MapBufferRange); c.out.u32(target); c.out.u64((uint64_t)offset); c.out.u64((uint64_t)length); c.out.u32(access); c.out.End(at);
+        int slot = mapSlot(target);
+        if (slot >= 0) { c.maps[slot].pointer = pointer; c.maps[slot].length = length; c.maps[slot].access = access; }
+        return pointer;
+    }
+    static GLboolean APIENTRY capture_UnmapBuffer(GLenum target) {
+        FrameCapture &c = Get();
+        int slot = mapSlot(target);
+        Mapping m = slot >= 0 ? c.maps[slot] : Mapping();
+        bool written = m.pointer && (m.access & GL_MAP_WRITE_BIT);
+        size_t at = c.beginCall(CAP_UnmapBuffer); c.out.u32(target);
+        c.out.blob(m.pointer, written ? (size_t)m.length : 0); c.out.End(at);
+        if (slot >= 0) c.maps[slot] = Mapping();
+        return c.real.UnmapBuffer(target);
+    }
+    static void APIENTRY capture_BlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_BlitFramebuffer);
+        c.out.i32(srcX0); c.out.i32(srcY0); c.out.i32(srcX1); c.out.i32(srcY1);
+        c.out.i32(dstX0); c.out.i32(dstY0); c.out.i32(dstX1); c.out.i32(dstY1); c.out.u32(mask); c.out.u32(filter);
+        c.out.End(at);
+        c.real.BlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+    }
+    static void APIENTRY capture_Scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+        FrameCapture &c = Get();
+        size_t at = c.beginCall(CAP_Scissor); c.out.i32(x); c.out.i32(y); c.out.i32(width); c.out.i32(height); c.out.End(at);
+        c.real.Scissor(x, y, width, height);
+    }
+};
+#endif
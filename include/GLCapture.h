@@ -0,0 +1,195 @@
+#ifndef GLCAPTURE_H
+#define GLCAPTURE_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+
+// File format shared by FrameCapture (writer) and MyGraphicsEngineReplay (reader).
+//
+//   header: "GLCP", version, default framebuffer width/height, renderer string
+//   records: u16 op, u32 payload size, payload (little-endian, packed)
+//
+// Resource records (textures, buffers, vertex arrays, programs, renderbuffers, framebuffers and
+// the initial GL state) are snapshots taken the first time the frame references an object,
+// before the referencing call runs, so together they describe the state at frame start.
+// Call records follow in issue order; only those are re-executed by the replayer.
+
+const char GL_CAPTURE_MAGIC[4] = { 'G', 'L', 'C', 'P' };
+const uint32_t GL_CAPTURE_VERSION = 1;
+
+enum CaptureOp : uint16_t {
+    // Resources
+    CAP_TEXTURE = 1,
+    CAP_BUFFER,
+    CAP_VERTEX_ARRAY,
+    CAP_PROGRAM,
+    CAP_RENDERBUFFER,
+    CAP_FRAMEBUFFER,
+    CAP_STATE,
+
+    // Calls
+    CAP_FIRST_CALL = 32,
+    CAP_BindFramebuffer = CAP_FIRST_CALL,
+    CAP_Viewport, CAP_ClearColor, CAP_Clear, CAP_ClearBufferfv, CAP_ClearBufferuiv,
+    CAP_Enable, CAP_Disable, CAP_DepthFunc, CAP_DepthMask, CAP_CullFace, CAP_BlendFunc, CAP_ColorMask, CAP_PolygonMode,
+    CAP_UseProgram, CAP_ActiveTexture, CAP_BindTexture, CAP_BindVertexArray, CAP_BindBuffer,
+    CAP_DrawBuffer, CAP_DrawBuffers, CAP_ReadBuffer,
+    CAP_GetUniformLocation,
+    CAP_Uniform1i, CAP_Uniform1ui, CAP_Uniform1f, CAP_Uniform2f, CAP_Uniform3f, CAP_Uniform4f,
+    CAP_Uniform1iv, CAP_Uniform1fv, CAP_Uniform2fv, CAP_Uniform3fv, CAP_Uniform4fv, CAP_UniformMatrix3fv, CAP_UniformMatrix4fv,
+    CAP_DrawArrays, CAP_DrawElements, CAP_DrawArraysInstanced, CAP_DrawElementsInstanced,
+    CAP_BufferData, CAP_BufferSubData, CAP_TexImage2D, CAP_TexSubImage2D, CAP_TexParameteri, CAP_GenerateMipmap,
+    CAP_ReadPixels, CAP_FenceSync, CAP_ClientWaitSync, CAP_DeleteSync, CAP_MapBufferRange, CAP_UnmapBuffer,
+    CAP_BlitFramebuffer, CAP_Scissor,
+    CAP_OP_END
+};
+
+inline const char* CaptureOpName(uint16_t op) {
+    static const char *calls[] = {
+        "glBindFramebuffer", "glViewport", "glClearColor", "glClear", "glClearBufferfv", "glClearBufferuiv",
+        "glEnable", "glDisable", "glDepthFunc", "glDepthMask", "glCullFace", "glBlendFunc", "glColorMask", "glPolygonMode",
+        "glUseProgram", "glActiveTexture", "glBindTexture", "glBindVertexArray", "glBindBuffer",
+        "glDrawBuffer", "glDrawBuffers", "glReadBuffer",
+        "glGetUniformLocation",
+        "glUniform1i", "glUniform1ui", "glUniform1f", "glUniform2f", "glUniform3f", "glUniform4f",
+        "glUniform1iv", "glUniform1fv", "glUniform2fv", "glUniform3fv", "glUniform4fv", "glUniformMatrix3fv", "glUniformMatrix4fv",
+        "glDrawArrays", "glDrawElements", "glDrawArraysInstanced", "glDrawElementsInstanced",
+        "glBufferData", "glBufferSubData", "glTexImage2D", "glTexSubImage2D", "glTexParameteri", "glGenerateMipmap",
+        "glReadPixels", "glFenceSync", "glClientWaitSync", "glDeleteSync", "glMapBufferRange", "glUnmapBuffer",
+        "glBlitFramebuffer", "glScissor"
+    };
+    static const char *resources[] = { "texture", "buffer", "vertex array", "program", "renderbuffer", "framebuffer", "state" };
+    if (op >= CAP_FIRST_CALL && op < CAP_OP_END) return calls[op - CAP_FIRST_CALL];
+    if (op >= CAP_TEXTURE && op <= CAP_STATE) return resources[op - CAP_TEXTURE];
+    return "unknown";
+}
+
+// Texture units whose bindings are part of CAP_STATE
+const int CAPTURE_TEXTURE_UNITS = 16;
+const int CAPTURE_COLOR_ATTACHMENTS = 8;
+
+// Client format/type used to read back (and re-upload) a texture of the given internal format
+inline void CaptureTextureTransfer(GLint internalFormat, GLenum &format, GLenum &type, int &bytesPerPixel) {
+    switch (internalFormat) {
+    case GL_DEPTH_COMPONENT: case GL_DEPTH_COMPONENT16: case GL_DEPTH_COMPONENT24: case GL_DEPTH_COMPONENT32: case GL_DEPTH_COMPONENT32F:
+        format = GL_DEPTH_COMPONENT; type = GL_FLOAT; bytesPerPixel = 4; break;
+    case GL_DEPTH24_STENCIL8: case GL_DEPTH_STENCIL:
+        format = GL_DEPTH_STENCIL; type = GL_UNSIGNED_INT_24_8; bytesPerPixel = 4; break;
+    case GL_R32UI: format = GL_RED_INTEGER; type = GL_UNSIGNED_INT; bytesPerPixel = 4; break;
+    case GL_R32I: format = GL_RED_INTEGER; type = GL_INT; bytesPerPixel = 4; break;
+    case GL_R8: case GL_RED: format = GL_RED; type = GL_UNSIGNED_BYTE; bytesPerPixel = 1; break;
+    case GL_R16F: case GL_R32F: format = GL_RED; type = GL_FLOAT; bytesPerPixel = 4; break;
+    case GL_RG8: case GL_RG: format = GL_RG; type = GL_UNSIGNED_BYTE; bytesPerPixel = 2; break;
+    case GL_RGB8: case GL_RGB: case GL_SRGB8: format = GL_RGB; type = GL_UNSIGNED_BYTE; bytesPerPixel = 3; break;
+    case GL_RGB16F: case GL_RGB32F: case GL_R11F_G11F_B10F: format = GL_RGB; type = GL_FLOAT; bytesPerPixel = 12; break;
+    case GL_RGBA16F: case GL_RGBA32F: format = GL_RGBA; type = GL_FLOAT; bytesPerPixel = 16; break;
+    default: format = GL_RGBA; type = GL_UNSIGNED_BYTE; bytesPerPixel = 4; break;
+    }
+}
+
+// Bytes of a client-side image for glTex(Sub)Image2D / glReadPixels with the given row alignment
+inline size_t CaptureImageBytes(GLsizei width, GLsizei height, GLenum format, GLenum type, int alignment) {
+    int components = 4;
+    switch (format) {
+    case GL_RED: case GL_RED_INTEGER: case GL_DEPTH_COMPONENT: case GL_STENCIL_INDEX: components = 1; break;
+    case GL_RG: case GL_RG_INTEGER: components = 2; break;
+    case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: components = 3; break;
+    default: break;
+    }
+    int size = 1;
+    switch (type) {
+    case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: size = 2; break;
+    case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT: size = 4; break;
+    case GL_UNSIGNED_INT_24_8: size = 4; components = 1; break;
+    default: break;
+    }
+    size_t a = alignment > 0 ? (size_t)alignment : 1;
+    size_t row = ((size_t)width * components * size + a - 1) / a * a;
+    return row * (size_t)height;
+}
+
+struct CaptureWriter {
+    std::vector<uint8_t> data;
+
+    void raw(const void *p, size_t n) { const uint8_t *b = static_cast<const uint8_t*>(p); data.insert(data.end(), b, b + n); }
+    void u16(uint16_t v) { raw(&v, 2); }
+    void u32(uint32_t v) { raw(&v, 4); }
+    void i32(int32_t v) { raw(&v, 4); }
+    void u64(uint64_t v) { raw(&v, 8); }
+    void f32(float v) { raw(&v, 4); }
+    void str(const std::string &s) { u32((uint32_t)s.size()); raw(s.data(), s.size()); }
+    void blob(const void *p, size_t n) { u64(n); if (n) raw(p, n); }
+
+    size_t Begin(uint16_t op) { u16(op); size_t at = data.size(); u32(0); return at; }
+    void End(size_t at) { uint32_t size = (uint32_t)(data.size() - at - 4); std::memcpy(&data[at], &size, 4); }
+};
+
+struct CaptureReader {
+    const uint8_t *p = nullptr, *end = nullptr;
+    bool ok = true;
+
+    CaptureReader() {}
+    CaptureReader(const uint8_t *begin, size_t size) : p(begin), end(begin + size) {}
+
+    bool raw(void *out, size_t n) {
+        if ((size_t)(end - p) < n) { ok = false; std::memset(out, 0, n); return false; }
+        std::memcpy(out, p, n); p += n; return true;
+    }
+    uint16_t u16() { uint16_t v; raw(&v, 2); return v; }
+    uint32_t u32() { uint32_t v; raw(&v, 4); return v; }
+    int32_t i32() { int32_t v; raw(&v, 4); return v; }
+    uint64_t u64() { uint64_t v; raw(&v, 8); return v; }
+    float f32() { float v; raw(&v, 4); return v; }
+    std::string str() { uint32_t n = u32(); if ((size_t)(end - p) < n) { ok = false; return ""; } std::string s((const char*)p, n); p += n; return s; }
+    // Points into the file buffer; null when empty
+    const uint8_t* blob(uint64_t &n) {
+        n = u64();
+        if ((uint64_t)(end - p) < n) { ok = false; n = 0; return nullptr; }
+        const uint8_t *b = n ? p : nullptr; p += n; return b;
+    }
+    bool AtEnd() const { return p >= end; }
+};
+
+struct CaptureRecord {
+    uint16_t op;
+    const uint8_t *payload;
+    uint32_t size;
+};
+
+struct CaptureFile {
+    uint32_t width = 0, height = 0; // default framebuffer
+    std::string renderer;
+    std::vector<uint8_t> bytes;
+    std::vector<CaptureRecord> records;
+
+    bool Load(const std::string &path) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) return false;
+        bytes.resize((size_t)in.tellg());
+        in.seekg(0);
+        in.read((char*)bytes.data(), bytes.size());
+        CaptureReader r(bytes.data(), bytes.size());
+        char magic[4];
+        r.raw(magic, 4);
+        if (!r.ok || std::memcmp(magic, GL_CAPTURE_MAGIC, 4) != 0 || r.u32() > GL_CAPTURE_VERSION) return false;
+        width = r.u32(); height = r.u32();
+        renderer = r.str();
+        records.clear();
+        while (r.ok && !r.AtEnd()) {
+            CaptureRecord rec;
+            rec.op = r.u16();
+            rec.size = r.u32();
+            if (!r.ok || (size_t)(r.end - r.p) < rec.size) return false;
+            rec.payload = r.p;
+            r.p += rec.size;
+            records.push_back(rec);
+        }
+        return r.ok;
+    }
+};
+#endif
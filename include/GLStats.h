@@ -0,0 +1,293 @@
+#ifndef GLSTATS_H
+#define GLSTATS_H
+
+// GL call instrumentation. Build with ENGINE_GL_STATS defined and src/glad.c swaps the glad
+// entry points below for counting wrappers right after loading; without it nothing is wrapped,
+// GL_STATS_PASS() expands to nothing and GLStats is an empty shell.
+// ImGui's backend has its own GL loader, so its calls are not counted.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum GLStatsCategory {
+    GL_STATS_DRAW_CALLS,        // glDraw*
+    GL_STATS_TRIANGLES,         // primitives assembled by those draws (instances included)
+    GL_STATS_PROGRAM_BINDS,     // glUseProgram
+    GL_STATS_UNIFORM_UPLOADS,   // glUniform*
+    GL_STATS_UNIFORM_LOOKUPS,   // glGetUniformLocation
+    GL_STATS_TEXTURE_BINDS,     // glBindTexture
+    GL_STATS_BUFFER_BINDS,      // glBindBuffer, glBindVertexArray
+    GL_STATS_FRAMEBUFFER_BINDS, // glBindFramebuffer
+    GL_STATS_STATE_CHANGES,     // enable/disable, depth, blend, cull, viewport, active texture...
+    GL_STATS_BUFFER_UPLOADS,    // glBufferData, glBufferSubData
+    GL_STATS_UPLOAD_BYTES,      // bytes passed to those
+    GL_STATS_TEXTURE_UPLOADS,   // glTexImage2D, glTexSubImage2D
+    GL_STATS_CLEARS,            // glClear
+    GL_STATS_CATEGORY_COUNT
+};
+
+// Running totals since startup, written by the wrappers on the GL thread
+extern unsigned long long gladStatsCounters[GL_STATS_CATEGORY_COUNT];
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+#include <glad/glad.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+
+inline const char* GLStatsCategoryName(int category) {
+    static const char *names[GL_STATS_CATEGORY_COUNT] = {
+        "draw_calls", "triangles", "program_binds", "uniform_uploads", "uniform_lookups", "texture_binds",
+        "buffer_binds", "framebuffer_binds", "state_changes", "buffer_uploads", "upload_bytes", "texture_uploads", "clears"
+    };
+    return category >= 0 && category < GL_STATS_CATEGORY_COUNT ? names[category] : "";
+}
+
+// GL_ARB_pipeline_statistics_query (not in our 3.3 glad, but the query entry points are core)
+#define GL_STATS_VERTICES_SUBMITTED             0x82EE
+#define GL_STATS_PRIMITIVES_SUBMITTED           0x82EF
+#define GL_STATS_VERTEX_SHADER_INVOCATIONS      0x82F0
+#define GL_STATS_FRAGMENT_SHADER_INVOCATIONS    0x82F4
+#define GL_STATS_CLIPPING_OUTPUT_PRIMITIVES     0x82F7
+
+// Per-frame, per-pass view over gladStatsCounters.
+//  - BeginFrame()/EndFrame() bracket the frame; calls outside any pass are reported as "Other".
+//  - GL_STATS_PASS("name") scopes a pass; passes don't nest (same rule as GPU profiler zones).
+//  - With pipelineStatistics on (and the extension present) each pass also records vertex,
+//    primitive and shader invocation counts. Queries are read back three frames later, only
+//    when available, so the numbers lag slightly but the CPU never waits.
+//  - StartLog() appends one CSV row per frame until StopLog().
+class GLStats {
+public:
+    static const int PIPELINE_QUERIES = 5;
+    static const int QUERY_FRAMES = 3;
+
+    struct Pass {
+        const char *name;
+        unsigned long long counts[GL_STATS_CATEGORY_COUNT];
+        unsigned long long pipeline[PIPELINE_QUERIES];
+        bool hasPipeline;
+    };
+
+    static GLStats& Get() {
+        static GLStats instance;
+        return instance;
+    }
+
+    static bool Enabled() {
+#ifdef ENGINE_GL_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool pipelineStatistics = false;
+
+#ifdef ENGINE_GL_STATS
+    void BeginFrame() {
+        std::memcpy(frameStart, gladStatsCounters, sizeof(frameStart));
+        current.clear();
+        if (pipelineStatistics && !pipelineChecked) checkPipelineSupport();
+        collectQueries(queryFrame);
+    }
+
+    void EndFrame() {
+        Pass other = makePass("Other");
+        for (int c = 0; c < GL_STATS_CATEGORY_COUNT; c++) {
+            unsigned long long inPasses = 0;
+            for (const Pass &p : current) inPasses += p.counts[c];
+            other.counts[c] = gladStatsCounters[c] - frameStart[c] - inPasses;
+        }
+        current.push_back(other);
+        // Pipeline results arrive later; carry the latest per pass name forward
+        for (Pass &p : current)
+            for (const Pass &prev : last)
+                if (std::strcmp(prev.name, p.name) == 0 && prev.hasPipeline && !p.hasPipeline) { std::memcpy(p.pipeline, prev.pipeline, sizeof(p.pipeline)); p.hasPipeline = true; }
+        for (const PendingQuery &q : resolved) applyQuery(q, current);
+        resolved.clear();
+        last.swap(current);
+        if (log.is_open()) writeLogRow();
+        frameIndex++;
+        queryFrame = (queryFrame + 1) % QUERY_FRAMES;
+    }
+
+    void BeginPass(const char *name) {
+        passName = name;
+        std::memcpy(passStart, gladStatsCounters, sizeof(passStart));
+        if (pipelineStatistics && pipelineSupported) beginQueries(name);
+    }
+
+    void EndPass() {
+        if (!passName) return;
+        Pass p = makePass(passName);
+        for (int c = 0; c < GL_STATS_CATEGORY_COUNT; c++) p.counts[c] = gladStatsCounters[c] - passStart[c];
+        current.push_back(p);
+        if (queriesActive) endQueries();
+        passName = nullptr;
+    }
+#else
+    void BeginFrame() {}
+    void EndFrame() {}
+    void BeginPass(const char*) {}
+    void EndPass() {}
+#endif
+
+    // Passes of the last completed frame, "Other" last
+    const std::vector<Pass>& LastFrame() const { return last; }
+    bool PipelineSupported() const { return pipelineSupported; }
+    unsigned long long FrameIndex() const { return frameIndex; }
+
+    static const char* PipelineName(int i) {
+        static const char *names[PIPELINE_QUERIES] = { "vertices", "primitives", "vs_invocations", "fs_invocations", "clipped_primitives" };
+        return names[i];
+    }
+
+    bool StartLog(const std::string &path) {
+        log.close();
+        log.open(path, std::ios::trunc);
+        logHeader.clear();
+        return log.is_open();
+    }
+    void StopLog() { log.close(); }
+    bool Logging() const { return log.is_open(); }
+
+private:
+    struct PendingQuery {
+        const char *name;
+        GLuint ids[PIPELINE_QUERIES];
+    };
+
+    std::vector<Pass> current, last;
+    unsigned long long frameStart[GL_STATS_CATEGORY_COUNT] = {};
+    unsigned long long passStart[GL_STATS_CATEGORY_COUNT] = {};
+    const char *passName = nullptr;
+    unsigned long long frameIndex = 0;
+
+    bool pipelineChecked = false, pipelineSupported = false, queriesActive = false;
+    std::vector<GLuint> freeQueries[PIPELINE_QUERIES]; // per target: a query object keeps its first target
+    std::vector<PendingQuery> pending[QUERY_FRAMES];
+    std::vector<PendingQuery> resolved; // read back this frame, applied in EndFrame
+    int queryFrame = 0;
+
+    std::ofstream log;
+    std::vector<std::string> logHeader; // pass names, fixed by the first logged frame
+
+    static Pass makePass(const char *name) {
+        Pass p;
+        p.name = name;
+        std::memset(p.counts, 0, sizeof(p.counts));
+        std::memset(p.pipeline, 0, sizeof(p.pipeline));
+        p.hasPipeline = false;
+        return p;
+    }
+
+    static GLenum pipelineTarget(int i) {
+        static const GLenum targets[PIPELINE_QUERIES] = {
+            GL_STATS_VERTICES_SUBMITTED, GL_STATS_PRIMITIVES_SUBMITTED, GL_STATS_VERTEX_SHADER_INVOCATIONS,
+            GL_STATS_FRAGMENT_SHADER_INVOCATIONS, GL_STATS_CLIPPING_OUTPUT_PRIMITIVES
+        };
+        return targets[i];
+    }
+
+    void checkPipelineSupport() {
+        pipelineChecked = true;
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++) {
+            const char *ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+            if (ext && std::strcmp(ext, "GL_ARB_pipeline_statistics_query") == 0) pipelineSupported = true;
+        }
+    }
+
+    void beginQueries(const char *name) {
+        PendingQuery q;
+        q.name = name;
+        for (int i = 0; i < PIPELINE_QUERIES; i++) {
+            if (freeQueries[i].empty()) { GLuint id; glGenQueries(1, &id); freeQueries[i].push_back(id); }
+            q.ids[i] = freeQueries[i].back(); freeQueries[i].pop_back();
+            glBeginQuery(pipelineTarget(i), q.ids[i]);
+        }
+        pending[queryFrame].push_back(q);
+        queriesActive = true;
+    }
+
+    void endQueries() {
+        for (int i = 0; i < PIPELINE_QUERIES; i++) glEndQuery(pipelineTarget(i));
+        queriesActive = false;
+    }
+
+    // Reads the queries issued QUERY_FRAMES ago; anything not ready yet is dropped, not waited on
+    void collectQueries(int slot) {
+        resolved.clear();
+        for (const PendingQuery &q : pending[slot]) {
+            GLint available = 0;
+            glGetQueryObjectiv(q.ids[PIPELINE_QUERIES - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available) resolved.push_back(q);
+            else for (int i = 0; i < PIPELINE_QUERIES; i++) freeQueries[i].push_back(q.ids[i]);
+        }
+        pending[slot].clear();
+    }
+
+    void applyQuery(const PendingQuery &q, std::vector<Pass> &passes) {
+        for (Pass &p : passes) {
+            if (std::strcmp(p.name, q.name) != 0) continue;
+            for (int i = 0; i < PIPELINE_QUERIES; i++) {
+                GLuint64 value = 0;
+                glGetQueryObjectui64v(q.ids[i], GL_QUERY_RESULT, &value);
+                p.pipeline[i] = value;
+            }
+            p.hasPipeline = true;
+            break;
+        }
+        for (int i = 0; i < PIPELINE_QUERIES; i++) freeQueries[i].push_back(q.ids[i]);
+    }
+
+    void writeLogRow() {
+        if (logHeader.empty()) {
+            log << "frame";
+            for (int c = 0; c < GL_STATS_CATEGORY_COUNT; c++) log << "," << GLStatsCategoryName(c);
+            for (const Pass &p : last) {
+                logHeader.push_back(p.name);
+                for (int c = 0; c < GL_STATS_CATEGORY_COUNT; c++) log << "," << p.name << "." << GLStatsCategoryName(c);
+                if (pipelineSupported && pipelineStatistics)
+                    for (int i = 0; i < PIPELINE_QUERIES; i++) log << "," << p.name << "." << PipelineName(i);
+            }
+            log << "\n";
+        }
+        unsigned long long totals[GL_STATS_CATEGORY_COUNT] = {};
+        for (const Pass &p : last) for (int c = 0; c < GL_STATS_CATEGORY_COUNT; c++) totals[c] += p.counts[c];
+        log << frameIndex;
+        for (int c = 0; c < GL_STATS_CATEGORY_COUNT; c++) log << "," << totals[c];
+        // Columns follow the first frame's passes; a pass missing this frame logs zeros
+        for (const std::string &name : logHeader) {
+            const Pass *found = nullptr;
+            for (const Pass &p : last) if (name == p.name) { found = &p; break; }
+            for (int c = 0; c < GL_STATS_CATEGORY_COUNT; c++) log << "," << (found ? found->counts[c] : 0ull);
+            if (pipelineSupported && pipelineStatistics)
+                for (int i = 0; i < PIPELINE_QUERIES; i++) log << "," << (found ? found->pipeline[i] : 0ull);
+        }
+        log << "\n";
+    }
+};
+
+#ifdef ENGINE_GL_STATS
+struct GLStatsPassScope {
+    explicit GLStatsPassScope(const char *name) { GLStats::Get().BeginPass(name); }
+    ~GLStatsPassScope() { GLStats::Get().EndPass(); }
+};
+#define GL_STATS_CONCAT_INNER(a, b) a##b
+#define GL_STATS_CONCAT(a, b) GL_STATS_CONCAT_INNER(a, b)
+#define GL_STATS_PASS(name) GLStatsPassScope GL_STATS_CONCAT(glStatsPass_, __LINE__)(name)
+#else
+#define GL_STATS_PASS(name)
+#endif
+#endif // __cplusplus
+#endif
@@ -0,0 +1,149 @@
+#ifndef GLSTATSUI_H
+#define GLSTATSUI_H
+
+#include "GLStats.h"
+#include "SyncStallDetector.h"
+#include "AllocTracker.h"
+#include "FrameArena.h"
+#include "Renderer.h"
+#include "Log.h"
+#include "imgui.h"
+
+#include <algorithm>
+#include <cstdio>
+
+// ImGui "Stats" window: the renderer's own counters, heap allocations, the sync stall detector
+// and, in ENGINE_GL_STATS builds, the GL calls of the last frame per pass and category.
+class StatsWindow {
+public:
+    bool visible = false;
+    char logPath[256] = "gl_stats.csv";
+
+    void Draw(GLStats &stats, const RenderCounters &counters) {
+        if (!visible) return;
+        if (!ImGui::Begin("Stats", &visible)) { ImGui::End(); return; }
+
+        ImGui::Text("Renderer: %u draws, %u triangles, %u objects", counters.drawCalls, counters.triangles, counters.objects);
+        ImGui::Text("Binds: %u programs, %u textures, %u framebuffers", counters.programBinds, counters.textureBinds, counters.framebufferBinds);
+        ImGui::Text("Point shadow faces redrawn: %u", counters.shadowFaces);
+        ImGui::Separator();
+        drawAllocations(AllocTracker::Get());
+        ImGui::Separator();
+        drawSyncStalls(SyncStallDetector::Get());
+        ImGui::Separator();
+
+        if (!GLStats::Enabled()) {
+            ImGui::TextWrapped("GL call counting is compiled out. Configure with -DENGINE_GL_STATS=ON to enable it.");
+            ImGui::End();
+            return;
+        }
+
+        ImGui::Checkbox("Pipeline statistics", &stats.pipelineStatistics);
+        if (stats.pipelineStatistics && !stats.PipelineSupported()) { ImGui::SameLine(); ImGui::TextDisabled("(GL_ARB_pipeline_statistics_query unavailable)"); }
+        ImGui::SetNextItemWidth(200);
+        ImGui::InputText("##logpath", logPath, sizeof(logPath));
+        ImGui::SameLine();
+        if (stats.Logging()) { if (ImGui::Button("Stop CSV Log")) stats.StopLog(); }
+        else if (ImGui::Button("Start CSV Log") && !stats.StartLog(logPath)) LOG_ERROR("Failed to open %s", logPath);
+
+        const std::vector<GLStats::Pass> &passes = stats.LastFrame();
+        drawTable("GLCalls", passes, GL_STATS_CATEGORY_COUNT, false);
+        if (stats.pipelineStatistics && stats.PipelineSupported()) drawTable("Pipeline", passes, GLStats::PIPELINE_QUERIES, true);
+        ImGui::End();
+    }
+
+private:
+    static void drawAllocations(AllocTracker &tracker) {
+        const AllocCounters &last = tracker.LastFrame();
+        FrameArena &arena = FrameArena::Get();
+        ImGui::Text("Heap: %llu allocations (%.1f KB) last frame, worst %llu", (unsigned long long)last.allocations, last.bytes / 1024.0,
+            (unsigned long long)tracker.PeakFrameAllocations());
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Reset##allocs")) tracker.ResetPeak();
+        ImGui::Text("Frame arena: %.1f KB high water of %.1f KB", arena.HighWater() / 1024.0, arena.Capacity() / 1024.0);
+        bool sampling = AllocSampleRate() != 0;
+        if (ImGui::Checkbox("Sample allocation sites", &sampling)) { AllocSetSampleRate(sampling ? 1 : 0); tracker.ClearSites(); }
+        if (!sampling || tracker.Sites().empty()) return;
+        tracker.Symbolize(); // only resolves new sites
+        const std::vector<AllocTracker::Site> &sites = tracker.Sites();
+        std::vector<size_t, FrameAllocator<size_t>> order{FrameAllocator<size_t>(arena)};
+        for (size_t i = 0; i < sites.size(); i++) order.push_back(i);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sites[a].samples > sites[b].samples; });
+        if (!ImGui::BeginTable("AllocSites", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY, ImVec2(0, 160))) return;
+        ImGui::TableSetupColumn("Allocations");
+        ImGui::TableSetupColumn("KB");
+        ImGui::TableSetupColumn("Caller");
+        ImGui::TableHeadersRow();
+        for (size_t i : order) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)sites[i].samples);
+            ImGui::TableNextColumn(); ImGui::Text("%.1f", sites[i].bytes / 1024.0);
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(sites[i].symbol.c_str());
+        }
+        ImGui::EndTable();
+    }
+
+    // Sites with calls in the last frame, slowest first
+    static void drawSyncStalls(SyncStallDetector &sync) {
+        bool on = sync.Enabled();
+        if (ImGui::Checkbox("Detect GL sync stalls", &on)) sync.SetEnabled(on);
+        if (!on) return;
+        ImGui::SameLine();
+        ImGui::Text("%.3f ms blocked last frame", sync.LastFrameMs());
+        ImGui::SetNextItemWidth(120);
+        ImGui::InputFloat("Log frames above (ms)", &sync.logThresholdMs, 0.1f, 1.0f, "%.2f");
+
+        const std::vector<SyncStallDetector::Site> &sites = sync.Sites();
+        std::vector<size_t, FrameAllocator<size_t>> order{FrameAllocator<size_t>(FrameArena::Get())};
+        for (size_t i = 0; i < sites.size(); i++) if (sites[i].frameCalls) order.push_back(i);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sites[a].frameNs > sites[b].frameNs; });
+        if (order.empty()) { ImGui::TextDisabled("No sync calls last frame"); return; }
+        if (!ImGui::BeginTable("SyncStalls", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY, ImVec2(0, 200))) return;
+        ImGui::TableSetupColumn("Call");
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableSetupColumn("ms");
+        ImGui::TableSetupColumn("Max ms");
+        ImGui::TableSetupColumn("Site");
+        ImGui::TableHeadersRow();
+        for (size_t i : order) {
+            const SyncStallDetector::Site &s = sites[i];
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            if (s.level == SYNC_BLOCKING) ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f), "%s", SyncCallName(s.call));
+            else ImGui::TextUnformatted(SyncCallName(s.call));
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(s.zone ? s.zone : "-");
+            ImGui::TableNextColumn(); ImGui::Text("%u", s.frameCalls);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", s.frameNs / 1e6);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", s.frameMaxNs / 1e6);
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(s.symbol.c_str());
+        }
+        ImGui::EndTable();
+    }
+
+    static void drawTable(const char *id, const std::vector<GLStats::Pass> &passes, int rows, bool pipeline) {
+        int columns = (int)passes.size() + 2;
+        if (columns > 64 || !ImGui::BeginTable(id, columns, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollX)) return;
+        ImGui::TableSetupColumn(pipeline ? "Pipeline" : "Category");
+        for (const GLStats::Pass &p : passes) ImGui::TableSetupColumn(p.name);
+        ImGui::TableSetupColumn("Total");
+        ImGui::TableHeadersRow();
+        for (int r = 0; r < rows; r++) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(pipeline ? GLStats::PipelineName(r) : GLStatsCategoryName(r));
+            unsigned long long total = 0;
+            for (const GLStats::Pass &p : passes) {
+                unsigned long long value = pipeline ? p.pipeline[r] : p.counts[r];
+                total += value;
+                ImGui::TableNextColumn();
+                if (pipeline && !p.hasPipeline) ImGui::TextDisabled("-");
+                else ImGui::Text("%llu", value);
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", total);
+        }
+        ImGui::EndTable();
+    }
+};
+#endif
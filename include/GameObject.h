@@ -3,7 +3,9 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <string>
+#include <vector>
 #include "Model.h"
 #include "Shader.h"
 
@@ -14,41 +16,60 @@ public:
     glm::vec3 rotation; 
     glm::vec3 scale;
     Model* model; 
+    int parent = -1; // index into the same object list, always lower than our own
+    bool receiveShadows = true; // off: lit with the shader variant that skips the shadow lookup
+    glm::mat4 parentMatrix = glm::mat4(1.0f); // parent's world matrix, refreshed by UpdateHierarchy
+    glm::mat4 previousModel = glm::mat4(1.0f); // world matrix last drawn with TAA, for its velocity
+    bool motionValid = false;                   // previousModel is set
+    glm::mat4 shadowCasterModel = glm::mat4(1.0f); // world matrix the point-light shadows last saw
+    bool shadowCasterValid = false;
+
+    // World-space bounding sphere for a world matrix of this object (radius 0 without a model)
+    float BoundingSphere(const glm::mat4 &world, glm::vec3 &center) const {
+        center = glm::vec3(world[3]);
+        if (!model) return 0.0f;
+        float scale = std::max(glm::length(glm::vec3(world[0])), std::max(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
+        return model->BoundingRadius() * scale;
+    }
 
     GameObject(std::string n, Model* m) 
         : name(n), model(m), position(0.0f), rotation(0.0f), scale(1.0f) {}
 
-    void Draw(Shader &shader) {
+    glm::mat4 GetModelMatrix() const {
         glm::mat4 mat = glm::mat4(1.0f);
         mat = glm::translate(mat, position);
         mat = glm::rotate(mat, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
         mat = glm::rotate(mat, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
         mat = glm::rotate(mat, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
         mat = glm::scale(mat, scale);
-        shader.setMat4("model", mat);
+        return parent >= 0 ? parentMatrix * mat : mat;
+    }
+
+    void Draw(Shader &shader) {
+        shader.setMat4("model", GetModelMatrix());
         if (model) model->Draw(shader);
     }
 
-    // NEW: Simple Ray-Sphere Intersection Logic
-    // Returns true if the ray hits this object's "bounding sphere"
-    bool IntersectRay(glm::vec3 rayOrigin, glm::vec3 rayDir) {
-        // 1. Vector from ray origin to sphere center
-        glm::vec3 oc = position - rayOrigin;
-        
-        // 2. Project that vector onto the ray direction
-        float t = glm::dot(oc, rayDir);
-        
-        // 3. Find the closest point on the ray to the sphere center
-        glm::vec3 closestPoint = rayOrigin + rayDir * t;
-        
-        // 4. Calculate distance from sphere center to that point
-        float distance = glm::length(position - closestPoint);
-        
-        // 5. Check if distance is less than radius (approx radius = max scale)
-        float radius = std::max(std::max(scale.x, scale.y), scale.z) * 1.0f; // 1.0 is base radius of cube
-        
-        // Check if 't' is positive (in front of camera) and distance is within radius
-        return (t > 0 && distance < radius);
+    // Triangle-accurate picking against the model's per-mesh BVHs.
+    // The world ray is moved into object space instead of transforming the mesh, so
+    // hit.distance stays a world-space distance as long as rayDir is normalized.
+    // Only updates 'hit' when this object is closer than hit.distance.
+    bool IntersectRay(glm::vec3 rayOrigin, glm::vec3 rayDir, RayHit &hit) const {
+        if (!model) return false;
+        glm::mat4 invModel = glm::inverse(GetModelMatrix());
+        glm::vec3 localOrigin = glm::vec3(invModel * glm::vec4(rayOrigin, 1.0f));
+        glm::vec3 localDir = glm::vec3(invModel * glm::vec4(rayDir, 0.0f));
+        return model->IntersectRay(localOrigin, localDir, hit);
     }
 };
+
+// Propagates transforms down the hierarchy. Parents precede children, so one pass suffices.
+inline void UpdateHierarchy(std::vector<GameObject> &objects) {
+    for (size_t i = 0; i < objects.size(); i++) {
+        GameObject &obj = objects[i];
+        if (obj.parent < 0) continue;
+        if ((size_t)obj.parent >= i) { obj.parent = -1; continue; }
+        obj.parentMatrix = objects[obj.parent].GetModelMatrix();
+    }
+}
 #endif
\ No newline at end of file
@@ -0,0 +1,124 @@
+#ifndef GPUPICKER_H
+#define GPUPICKER_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <algorithm>
+
+// Pixel-exact selection from an integer object-ID attachment.
+// The lighting pass writes (object index + 1) into a GL_R32UI target; a request copies the
+// pixels under the cursor (or a marquee rectangle) into a pixel pack buffer and drops a fence.
+// Poll() maps the buffer once the fence has signaled, so the CPU never waits on the GPU and the
+// answer simply shows up a frame or two later.
+class GpuPicker {
+public:
+    unsigned int idTexture = 0;
+
+    // Creates the ID texture, the framebuffer the readback reads it through and the pack buffers.
+    // The renderer attaches the texture to its lighting pass as a second color target.
+    void Init(int width, int height) {
+        glGenTextures(1, &idTexture);
+        glGenFramebuffers(1, &readFramebuffer);
+        for (int i = 0; i < SLOTS; i++) glGenBuffers(1, &slots[i].pbo);
+        Resize(width, height);
+    }
+
+    // Reallocates the ID texture in place, so its name (and the framebuffers using it) stay valid
+    void Resize(int width, int height) {
+        glBindTexture(GL_TEXTURE_2D, idTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, readFramebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, idTexture, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        this->width = width;
+        this->height = height;
+        hasPending = false;
+    }
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    // Queue a read of the region [x0,x1) x [y0,y1) in framebuffer pixels, origin top-left.
+    // A single pixel click is just a 1x1 region. The copy is issued by Flush().
+    void Request(int x0, int y0, int x1, int y1) {
+        if (x0 > x1) std::swap(x0, x1);
+        if (y0 > y1) std::swap(y0, y1);
+        pending.x0 = std::max(x0, 0); pending.x1 = std::min(std::max(x1, x0 + 1), width);
+        pending.y0 = std::max(y0, 0); pending.y1 = std::min(std::max(y1, y0 + 1), height);
+        hasPending = pending.x0 < pending.x1 && pending.y0 < pending.y1;
+    }
+
+    // Call after the frame that rendered the ID texture has been submitted
+    void Flush() {
+        if (!hasPending) return;
+        Slot &slot = slots[nextSlot];
+        if (slot.fence) return; // both slots in flight: keep the request for the next frame
+        hasPending = false;
+        nextSlot = (nextSlot + 1) % SLOTS;
+
+        int w = pending.x1 - pending.x0, h = pending.y1 - pending.y0;
+        GLsizeiptr bytes = (GLsizeiptr)w * h * sizeof(GLuint);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        if (bytes > slot.capacity) {
+            glBufferData(GL_PIXEL_PACK_BUFFER, bytes, NULL, GL_STREAM_READ);
+            slot.capacity = bytes;
+        }
+        // With a pack buffer bound glReadPixels only schedules the copy and returns immediately
+        glReadPixels(pending.x0, height - pending.y1, w, h, GL_RED_INTEGER, GL_UNSIGNED_INT, (void*)0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        slot.pixels = w * h;
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    // Returns true when a finished request was collected. 'ids' receives the unique non-zero
+    // IDs in the region, sorted ascending. Any vector of unsigned int works, e.g. one on the frame arena.
+    template <typename IdVector>
+    bool Poll(IdVector &ids) {
+        for (int n = 0; n < SLOTS; n++) {
+            Slot &slot = slots[(nextSlot + n) % SLOTS]; // oldest in-flight slot first
+            if (!slot.fence) continue;
+            GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return false;
+            glDeleteSync(slot.fence);
+            slot.fence = 0;
+
+            ids.clear();
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+            const GLuint *data = (const GLuint*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.pixels * sizeof(GLuint), GL_MAP_READ_BIT);
+            if (data) {
+                for (int i = 0; i < slot.pixels; i++)
+                    if (data[i] != 0 && (ids.empty() || ids.back() != data[i])) ids.push_back(data[i]);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            std::sort(ids.begin(), ids.end());
+            ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+            return true;
+        }
+        return false;
+    }
+
+private:
+    static const int SLOTS = 2;
+    struct Slot {
+        unsigned int pbo = 0;
+        GLsizeiptr capacity = 0;
+        int pixels = 0;
+        GLsync fence = 0;
+    };
+    struct Region { int x0, y0, x1, y1; };
+
+    Slot slots[SLOTS];
+    int nextSlot = 0;
+    Region pending = { 0, 0, 0, 0 };
+    bool hasPending = false;
+    unsigned int readFramebuffer = 0;
+    int width = 0, height = 0;
+};
+#endif
@@ -0,0 +1,72 @@
+#ifndef HEADLESSCONTEXT_H
+#define HEADLESSCONTEXT_H
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <glad/glad.h>
+
+#include <iostream>
+
+// Windowless GL 3.3 core context through EGL, for tools that render offscreen (benchmarks, CI).
+// Tries a surfaceless display first (Mesa, works without X/Wayland or a GPU: llvmpipe), then the
+// default display with a tiny pbuffer. Render into your own framebuffer objects.
+class HeadlessContext {
+public:
+    ~HeadlessContext() { Destroy(); }
+
+    bool Create() {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+        if (getPlatformDisplay) display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+#endif
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+            display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+            if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) { std::cout << "EGL: no display" << std::endl; return false; }
+        }
+
+        const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+            EGL_NONE
+        };
+        EGLConfig config; EGLint numConfigs = 0;
+        eglChooseConfig(display, configAttribs, &config, 1, &numConfigs);
+        if (!eglBindAPI(EGL_OPENGL_API)) { std::cout << "EGL: desktop GL not supported" << std::endl; return false; }
+
+        const EGLint contextAttribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        context = eglCreateContext(display, numConfigs ? config : (EGLConfig)0, EGL_NO_CONTEXT, contextAttribs);
+        if (context == EGL_NO_CONTEXT) { std::cout << "EGL: failed to create a 3.3 core context" << std::endl; return false; }
+
+        // Surfaceless first (EGL_KHR_surfaceless_context), a 1x1 pbuffer otherwise
+        if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+            const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+            if (numConfigs) surface = eglCreatePbufferSurface(display, config, pbufferAttribs);
+            if (surface == EGL_NO_SURFACE || !eglMakeCurrent(display, surface, surface, context)) { std::cout << "EGL: eglMakeCurrent failed" << std::endl; return false; }
+        }
+        if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) { std::cout << "Failed to load GL functions" << std::endl; return false; }
+        return true;
+    }
+
+    void Destroy() {
+        if (display == EGL_NO_DISPLAY) return;
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (surface != EGL_NO_SURFACE) eglDestroySurface(display, surface);
+        if (context != EGL_NO_CONTEXT) eglDestroyContext(display, context);
+        eglTerminate(display);
+        display = EGL_NO_DISPLAY; context = EGL_NO_CONTEXT; surface = EGL_NO_SURFACE;
+    }
+
+    const char* Renderer() const { return (const char*)glGetString(GL_RENDERER); }
+
+private:
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+    EGLSurface surface = EGL_NO_SURFACE;
+};
+#endif
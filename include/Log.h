@@ -0,0 +1,224 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+// Asynchronous logger. The calling thread only formats into a slot of a fixed, lock-free
+// multi-producer ring (no allocation, no I/O, no lock); a background thread writes the records
+// to stdout and, once Open() was called, to a file.
+//  - LOG_DEBUG/INFO/WARN/ERROR(format, ...) take printf arguments. Levels below
+//    ENGINE_LOG_LEVEL are compiled out, arguments included.
+//  - Each macro call site lets LOG_RATE_LIMIT messages through per second; the rest are counted
+//    and reported with the next message that gets through.
+//  - A full ring drops the record (counted) instead of blocking the caller.
+//  - Flush() waits until everything logged so far is written.
+enum LogLevel { LOG_LEVEL_DEBUG = 0, LOG_LEVEL_INFO, LOG_LEVEL_WARN, LOG_LEVEL_ERROR };
+
+#ifndef ENGINE_LOG_LEVEL
+#define ENGINE_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+const uint32_t LOG_RATE_LIMIT = 10;
+
+#if defined(__GNUC__)
+#define LOG_PRINTF_FORMAT(fmt, args) __attribute__((format(printf, fmt, args)))
+#else
+#define LOG_PRINTF_FORMAT(fmt, args)
+#endif
+
+class Log {
+public:
+    static constexpr size_t RING_SIZE = 512;   // power of two
+    static constexpr size_t TEXT_SIZE = 1000;  // longer messages are truncated
+
+    static Log& Get() {
+        static Log instance;
+        return instance;
+    }
+
+    static uint64_t Now() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Also write to 'path' (truncated); false if it cannot be opened
+    bool Open(const char *path) {
+        FILE *f = std::fopen(path, "w");
+        if (!f) return false;
+        std::lock_guard<std::mutex> lock(outputMutex);
+        if (file) std::fclose(file);
+        file = f;
+        return true;
+    }
+
+    void Write(int level, uint32_t suppressed, const char *format, ...) LOG_PRINTF_FORMAT(4, 5) {
+        // Claim a slot (bounded MPMC queue, used with a single consumer)
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;) {
+            slot = &ring[pos & (RING_SIZE - 1)];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        slot->level = level;
+        slot->time = Now();
+        slot->thread = threadIndex();
+        slot->suppressed = suppressed;
+        va_list args;
+        va_start(args, format);
+        int n = std::vsnprintf(slot->text, TEXT_SIZE, format, args);
+        va_end(args);
+        if (n >= (int)TEXT_SIZE) { slot->text[TEXT_SIZE - 4] = slot->text[TEXT_SIZE - 3] = slot->text[TEXT_SIZE - 2] = '.'; }
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        if (level >= LOG_LEVEL_ERROR) wake.notify_one(); // errors go out promptly
+    }
+
+    void Flush() {
+        size_t target = enqueuePos.load(std::memory_order_acquire);
+        wake.notify_one();
+        while (written.load(std::memory_order_acquire) < target) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    static const char* LevelName(int level) {
+        static const char *names[] = { "DEBUG", "INFO", "WARN", "ERROR" };
+        return level >= 0 && level <= LOG_LEVEL_ERROR ? names[level] : "?";
+    }
+
+    uint64_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        int level = 0;
+        uint32_t thread = 0, suppressed = 0;
+        uint64_t time = 0;
+        char text[TEXT_SIZE];
+    };
+
+    Slot ring[RING_SIZE];
+    std::atomic<size_t> enqueuePos{0};
+    size_t dequeuePos = 0; // consumer thread only
+    std::atomic<size_t> written{0};
+    std::atomic<uint64_t> dropped{0};
+    uint64_t reportedDrops = 0;
+    uint64_t start = Now();
+
+    std::atomic<bool> stop{false};
+    std::mutex wakeMutex, outputMutex;
+    std::condition_variable wake;
+    FILE *file = nullptr;
+    std::thread writer;
+
+    Log() {
+        for (size_t i = 0; i < RING_SIZE; i++) ring[i].sequence.store(i, std::memory_order_relaxed);
+        writer = std::thread(&Log::run, this);
+    }
+    ~Log() {
+        stop = true;
+        wake.notify_one();
+        writer.join();
+        if (file) std::fclose(file);
+    }
+
+    static uint32_t threadIndex() {
+        static std::atomic<uint32_t> next{0};
+        thread_local uint32_t index = next++;
+        return index;
+    }
+
+    void run() {
+        for (;;) {
+            bool stopping = stop.load();
+            size_t n = drain();
+            if (n == 0) {
+                if (stopping) return;
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wake.wait_for(lock, std::chrono::milliseconds(10));
+            }
+        }
+    }
+
+    // Writes all published records; one flush per batch instead of one per line
+    size_t drain() {
+        size_t count = 0;
+        std::lock_guard<std::mutex> lock(outputMutex);
+        for (;;) {
+            Slot &slot = ring[dequeuePos & (RING_SIZE - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) break;
+            output(slot.level, slot.time, slot.thread, slot.suppressed, slot.text);
+            slot.sequence.store(dequeuePos + RING_SIZE, std::memory_order_release);
+            dequeuePos++;
+            count++;
+        }
+        uint64_t drops = dropped.load(std::memory_order_relaxed);
+        if (drops != reportedDrops) {
+            char text[64];
+            std::snprintf(text, sizeof(text), "log ring full, %llu message(s) dropped", (unsigned long long)(drops - reportedDrops));
+            output(LOG_LEVEL_WARN, Now(), 0, 0, text);
+            reportedDrops = drops;
+            count++;
+        }
+        if (count) {
+            std::fflush(stdout);
+            if (file) std::fflush(file);
+        }
+        written.store(dequeuePos, std::memory_order_release);
+        return count;
+    }
+
+    void output(int level, uint64_t time, uint32_t thread, uint32_t suppressed, const char *text) {
+        double seconds = time > start ? (time - start) / 1e9 : 0.0;
+        char repeats[48] = "";
+        if (suppressed) std::snprintf(repeats, sizeof(repeats), " (%u similar suppressed)", suppressed);
+        std::printf("[%-5s] %s%s\n", LevelName(level), text, repeats);
+        if (file) std::fprintf(file, "%10.4f %-5s t%u %s%s\n", seconds, LevelName(level), thread, text, repeats);
+    }
+};
+
+// Per call site limiter behind the LOG_* macros
+struct LogRateLimit {
+    std::atomic<uint64_t> windowStart{0};
+    std::atomic<uint32_t> count{0}, suppressed{0};
+
+    // False when the site is over its budget for this second; 'skipped' receives the number of
+    // messages suppressed since the last one that got through
+    bool Allow(uint32_t &skipped) {
+        uint64_t now = Log::Now(), window = windowStart.load(std::memory_order_relaxed);
+        if (now - window >= 1000000000ull && windowStart.compare_exchange_strong(window, now, std::memory_order_relaxed))
+            count.store(0, std::memory_order_relaxed);
+        if (count.fetch_add(1, std::memory_order_relaxed) >= LOG_RATE_LIMIT) {
+            suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        skipped = suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+};
+
+#define LOG_AT(level, ...) do { \
+        if ((level) >= ENGINE_LOG_LEVEL) { \
+            static LogRateLimit logRateLimit; \
+            uint32_t logSuppressed = 0; \
+            if (logRateLimit.Allow(logSuppressed)) Log::Get().Write((level), logSuppressed, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#endif
@@ -3,9 +3,11 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstdio>
 #include <string>
 #include <vector>
 #include "Shader.h"
+#include "BVH.h"
 
 struct Vertex {
     glm::vec3 Position;
@@ -25,15 +27,42 @@ public:
     std::vector<Vertex>       vertices;
     std::vector<unsigned int> indices;
     std::vector<TextureStruct>      textures;
-    unsigned int VAO;
+    unsigned int VAO = 0;
+    // Picking acceleration structure, built once at import
+    MeshBVH bvh;
 
-    // Constructor
-    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<TextureStruct> textures) {
+    // Constructor. With upload = false no GL calls are made (safe on a loader thread); call Upload() later.
+    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<TextureStruct> textures, bool upload = true) {
         this->vertices = vertices;
         this->indices = indices;
         this->textures = textures;
 
-        setupMesh();
+        if (upload) setupMesh();
+        bvh.Build(this->vertices, this->indices);
+    }
+
+    void Upload() {
+        if (VAO == 0) setupMesh();
+    }
+
+    // Frees the GPU buffers. Meshes are copied by value, so this is explicit rather than a destructor.
+    void Release() {
+        if (VAO == 0) return;
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        VAO = VBO = EBO = 0;
+    }
+
+    // CPU copy + GPU buffers + picking BVH
+    size_t MemoryBytes() const {
+        size_t geometry = vertices.size() * sizeof(Vertex) + indices.size() * sizeof(unsigned int);
+        return 2 * geometry + bvh.nodes.size() * sizeof(MeshBVH::Node) + bvh.triIndices.size() * sizeof(uint32_t);
+    }
+
+    // Ray in mesh-local space; updates 'hit' if a closer triangle is found
+    bool IntersectRay(const glm::vec3 &origin, const glm::vec3 &dir, RayHit &hit) const {
+        return bvh.Intersect(origin, dir, vertices, indices, hit);
     }
 
     // Render the mesh
@@ -48,19 +77,22 @@ public:
             glActiveTexture(GL_TEXTURE0 + i); // active proper texture unit before binding
             
             // retrieve texture number (the N in diffuse_textureN)
-            std::string number;
-            std::string name = textures[i].type;
+            const std::string &name = textures[i].type;
+            unsigned int number = 0;
             if(name == "texture_diffuse")
-                number = std::to_string(diffuseNr++);
+                number = diffuseNr++;
             else if(name == "texture_specular")
-                number = std::to_string(specularNr++); 
+                number = specularNr++;
             else if(name == "texture_normal")
-                number = std::to_string(normalNr++); 
+                number = normalNr++;
             else if(name == "texture_height")
-                number = std::to_string(heightNr++); 
+                number = heightNr++;
 
-            // set the sampler to the correct texture unit
-            glUniform1i(glGetUniformLocation(shader.ID, (name + number).c_str()), i);
+            // set the sampler to the correct texture unit; formatted on the stack, this runs per draw
+            char uniform[64];
+            if (number) snprintf(uniform, sizeof(uniform), "%s%u", name.c_str(), number);
+            else snprintf(uniform, sizeof(uniform), "%s", name.c_str());
+            glUniform1i(glGetUniformLocation(shader.ID, uniform), i);
             // bind the texture
             glBindTexture(GL_TEXTURE_2D, textures[i].id);
         }
@@ -76,7 +108,7 @@ public:
 
 private:
     // Render data
-    unsigned int VBO, EBO;
+    unsigned int VBO = 0, EBO = 0;
 
     void setupMesh() {
         // create buffers/arrays
@@ -0,0 +1,264 @@
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+
+// Minimal in-tree microbenchmark harness with a Google Benchmark flavoured API:
+//
+//   static void BM_Something(BenchState &state) {
+//       Setup(state.range());               // untimed
+//       for (auto _ : state) { ... }         // timed, repeated until the run is long enough
+//       state.SetItemsProcessed(state.iterations() * state.range());
+//   }
+//   MICROBENCH(BM_Something)->Range(1, 1 << 20);
+//
+// Each benchmark/argument pair is run with a growing iteration count until it takes at least
+// --min_time seconds; the reported time is per iteration. Results can be written as JSON and
+// compared against an earlier run to catch regressions.
+
+inline void BenchClobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+template <typename T>
+inline void BenchDoNotOptimize(T const &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+class BenchState {
+public:
+    BenchState(int64_t arg, int64_t iterations) : arg(arg), maxIterations(iterations) {}
+
+    int64_t range() const { return arg; }
+    int64_t iterations() const { return maxIterations; }
+
+    // Exclude per-iteration setup from the measurement
+    void PauseTiming() { pauseStart = clock::now(); }
+    void ResumeTiming() { pausedSeconds += std::chrono::duration<double>(clock::now() - pauseStart).count(); }
+
+    void SetItemsProcessed(int64_t items) { itemsProcessed = items; }
+    void SetBytesProcessed(int64_t bytes) { bytesProcessed = bytes; }
+    void SetLabel(const std::string &text) { label = text; }
+
+    // Range-for support: for (auto _ : state)
+    struct Iterator {
+        BenchState *state;
+        int64_t remaining;
+        bool operator!=(const Iterator&) {
+            if (remaining > 0) return true;
+            state->stop();
+            return false;
+        }
+        void operator++() { remaining--; }
+        // Non-trivial so 'auto _' doesn't trip -Wunused-variable
+        struct Value { Value() {} ~Value() {} };
+        Value operator*() const { return Value(); }
+    };
+    Iterator begin() { start(); return Iterator{ this, maxIterations }; }
+    Iterator end() { return Iterator{ this, 0 }; }
+
+    double ElapsedSeconds() const { return elapsed; }
+    int64_t ItemsProcessed() const { return itemsProcessed; }
+    int64_t BytesProcessed() const { return bytesProcessed; }
+    const std::string& Label() const { return label; }
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    int64_t arg;
+    int64_t maxIterations;
+    clock::time_point started, pauseStart;
+    double pausedSeconds = 0.0;
+    double elapsed = 0.0;
+    int64_t itemsProcessed = 0, bytesProcessed = 0;
+    std::string label;
+
+    void start() { pausedSeconds = 0.0; started = clock::now(); }
+    void stop() { elapsed = std::chrono::duration<double>(clock::now() - started).count() - pausedSeconds; }
+};
+
+class MicroBenchmark {
+public:
+    typedef void (*Function)(BenchState&);
+
+    MicroBenchmark(const char *name, Function fn) : name(name), fn(fn) {}
+
+    MicroBenchmark* Arg(int64_t value) { args.push_back(value); return this; }
+    MicroBenchmark* RangeMultiplier(int m) { multiplier = m > 1 ? m : 2; return this; }
+    // lo, lo*m, lo*m^2, ... and always hi
+    MicroBenchmark* Range(int64_t lo, int64_t hi) {
+        for (int64_t v = lo; v < hi; v *= multiplier) args.push_back(v);
+        args.push_back(hi);
+        return this;
+    }
+
+    const char *name;
+    Function fn;
+    std::vector<int64_t> args;
+    int multiplier = 8;
+};
+
+struct MicroBenchResult {
+    std::string name;
+    double nsPerIteration;
+    int64_t iterations;
+    double itemsPerSecond;
+    double bytesPerSecond;
+    std::string label;
+};
+
+class MicroBenchRegistry {
+public:
+    static MicroBenchRegistry& Get() {
+        static MicroBenchRegistry instance;
+        return instance;
+    }
+
+    MicroBenchmark* Add(const char *name, MicroBenchmark::Function fn) {
+        benchmarks.push_back(new MicroBenchmark(name, fn));
+        return benchmarks.back();
+    }
+
+    // Usage: <exe> [--filter=substring] [--min_time=seconds] [--json=out.json] [--baseline=old.json] [--threshold=percent]
+    // Returns the process exit code (2 when a baseline comparison finds regressions).
+    int RunAll(int argc, char **argv) {
+        std::string filter, jsonPath, baselinePath;
+        double minTime = 0.5, threshold = 10.0;
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg.compare(0, 9, "--filter=") == 0) filter = arg.substr(9);
+            else if (arg.compare(0, 11, "--min_time=") == 0) minTime = std::atof(arg.c_str() + 11);
+            else if (arg.compare(0, 7, "--json=") == 0) jsonPath = arg.substr(7);
+            else if (arg.compare(0, 11, "--baseline=") == 0) baselinePath = arg.substr(11);
+            else if (arg.compare(0, 12, "--threshold=") == 0) threshold = std::atof(arg.c_str() + 12);
+            else { std::printf("Usage: %s [--filter=substring] [--min_time=seconds] [--json=out.json] [--baseline=old.json] [--threshold=percent]\n", argv[0]); return 1; }
+        }
+
+        std::vector<MicroBenchResult> results;
+        std::printf("%-44s %14s %12s %16s\n", "Benchmark", "Time", "Iterations", "Throughput");
+        for (MicroBenchmark *b : benchmarks) {
+            std::vector<int64_t> args = b->args;
+            if (args.empty()) args.push_back(0);
+            for (int64_t arg : args) {
+                std::string name = b->name;
+                if (!b->args.empty()) name += "/" + std::to_string(arg);
+                if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+                MicroBenchResult r = run(b, arg, minTime);
+                r.name = name;
+                print(r);
+                results.push_back(r);
+            }
+        }
+
+        if (!jsonPath.empty() && !writeJson(jsonPath, results)) std::printf("Failed to write %s\n", jsonPath.c_str());
+        if (baselinePath.empty()) return 0;
+        std::map<std::string, double> baseline;
+        if (!readJson(baselinePath, baseline)) { std::printf("Failed to read baseline %s\n", baselinePath.c_str()); return 1; }
+        int regressions = 0;
+        for (const MicroBenchResult &r : results) {
+            std::map<std::string, double>::const_iterator it = baseline.find(r.name);
+            if (it == baseline.end() || it->second <= 0.0) continue;
+            double change = (r.nsPerIteration - it->second) / it->second * 100.0;
+            if (change > threshold) {
+                std::printf("REGRESSION %-40s %.1f ns -> %.1f ns (%+.1f%%)\n", r.name.c_str(), it->second, r.nsPerIteration, change);
+                regressions++;
+            }
+        }
+        std::printf("%d regression(s) against %s (threshold %.1f%%)\n", regressions, baselinePath.c_str(), threshold);
+        return regressions ? 2 : 0;
+    }
+
+private:
+    std::vector<MicroBenchmark*> benchmarks;
+
+    static MicroBenchResult run(MicroBenchmark *b, int64_t arg, double minTime) {
+        int64_t iterations = 1;
+        for (;;) {
+            BenchState state(arg, iterations);
+            b->fn(state);
+            double elapsed = state.ElapsedSeconds();
+            // Accept once long enough (or at a sanity cap), otherwise grow towards the target
+            if (elapsed >= minTime || iterations >= ((int64_t)1 << 40)) {
+                MicroBenchResult r;
+                r.nsPerIteration = elapsed * 1e9 / iterations;
+                r.iterations = iterations;
+                r.itemsPerSecond = elapsed > 0.0 ? state.ItemsProcessed() / elapsed : 0.0;
+                r.bytesPerSecond = elapsed > 0.0 ? state.BytesProcessed() / elapsed : 0.0;
+                r.label = state.Label();
+                return r;
+            }
+            double scale = elapsed > 0.0 ? minTime * 1.4 / elapsed : 100.0;
+            if (scale > 100.0) scale = 100.0;
+            int64_t next = (int64_t)(iterations * scale);
+            iterations = next > iterations ? next : iterations + 1;
+        }
+    }
+
+    static std::string formatTime(double ns) {
+        char buf[32];
+        if (ns < 1e3) std::snprintf(buf, sizeof(buf), "%.1f ns", ns);
+        else if (ns < 1e6) std::snprintf(buf, sizeof(buf), "%.2f us", ns / 1e3);
+        else if (ns < 1e9) std::snprintf(buf, sizeof(buf), "%.2f ms", ns / 1e6);
+        else std::snprintf(buf, sizeof(buf), "%.2f s", ns / 1e9);
+        return buf;
+    }
+
+    static void print(const MicroBenchResult &r) {
+        char throughput[48] = "";
+        if (r.bytesPerSecond > 0.0) std::snprintf(throughput, sizeof(throughput), "%.1f MB/s", r.bytesPerSecond / 1e6);
+        else if (r.itemsPerSecond > 0.0) std::snprintf(throughput, sizeof(throughput), "%.2f M items/s", r.itemsPerSecond / 1e6);
+        std::printf("%-44s %14s %12lld %16s %s\n", r.name.c_str(), formatTime(r.nsPerIteration).c_str(), (long long)r.iterations, throughput, r.label.c_str());
+    }
+
+    // One benchmark per line so the reader below can stay trivial
+    static bool writeJson(const std::string &path, const std::vector<MicroBenchResult> &results) {
+        std::ofstream out(path);
+        if (!out.is_open()) return false;
+        out << "{\"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const MicroBenchResult &r = results[i];
+            char line[512];
+            std::snprintf(line, sizeof(line), "  {\"name\": \"%s\", \"ns_per_iter\": %.3f, \"iterations\": %lld, \"items_per_second\": %.1f, \"bytes_per_second\": %.1f}%s\n",
+                r.name.c_str(), r.nsPerIteration, (long long)r.iterations, r.itemsPerSecond, r.bytesPerSecond, i + 1 < results.size() ? "," : "");
+            out << line;
+        }
+        out << "]}\n";
+        return out.good();
+    }
+
+    static bool readJson(const std::string &path, std::map<std::string, double> &nsPerIteration) {
+        std::ifstream in(path);
+        if (!in.is_open()) return false;
+        std::string line;
+        while (std::getline(in, line)) {
+            size_t name = line.find("\"name\": \"");
+            size_t ns = line.find("\"ns_per_iter\": ");
+            if (name == std::string::npos || ns == std::string::npos) continue;
+            name += 9;
+            size_t nameEnd = line.find('"', name);
+            if (nameEnd == std::string::npos) continue;
+            nsPerIteration[line.substr(name, nameEnd - name)] = std::atof(line.c_str() + ns + 15);
+        }
+        return true;
+    }
+};
+
+#define MICROBENCH_CONCAT_INNER(a, b) a##b
+#define MICROBENCH_CONCAT(a, b) MICROBENCH_CONCAT_INNER(a, b)
+#define MICROBENCH(fn) static MicroBenchmark *MICROBENCH_CONCAT(microbench_, __LINE__) = MicroBenchRegistry::Get().Add(#fn, fn)
+#define MICROBENCH_MAIN() int main(int argc, char **argv) { return MicroBenchRegistry::Get().RunAll(argc, argv); }
+#endif
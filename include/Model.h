@@ -12,15 +12,26 @@
 
 #include "Mesh.h"
 #include "Shader.h"
+#include "Profiler.h"
+#include "Log.h"
 
+#include <algorithm>
 #include <string>
 #include <fstream>
 #include <sstream>
-#include <iostream>
 #include <map>
 #include <vector>
 
+// Decoded image waiting for upload. Decoding has no GL calls, so it can run on loader threads.
+struct TextureData {
+    std::string path; // as referenced by the material
+    unsigned char *pixels = nullptr;
+    int width = 0, height = 0, nrComponents = 0;
+};
+
 unsigned int TextureFromFile(const char *path, const std::string &directory, bool gamma = false);
+TextureData DecodeTexture(const char *path, const std::string &directory);
+unsigned int UploadTexture(TextureData &data);
 
 class Model {
 public:
@@ -28,52 +39,90 @@ public:
     std::vector<TextureStruct> textures_loaded;	
     std::vector<Mesh>    meshes;
     std::string directory;
+    std::string path;
     bool gammaCorrection;
+    size_t textureBytes = 0; // decoded size of all textures including mips
 
-    Model(std::string const &path, bool gamma = false) : gammaCorrection(gamma) {
+    // With deferUpload the constructor only does CPU work (import, vertex conversion, BVH build,
+    // image decoding), so models can be imported on worker threads. Upload() must then be
+    // called on the GL thread before drawing.
+    Model(std::string const &path, bool gamma = false, bool deferUpload = false) : path(path), gammaCorrection(gamma), deferUpload(deferUpload) {
         loadModel(path);
     }
 
+    // Empty model for procedural geometry: the caller fills 'meshes' (built without upload) and calls Upload()
+    Model() : gammaCorrection(false), deferUpload(true) {}
+
+    ~Model() {
+        for (unsigned int i = 0; i < pendingTextures.size(); i++) stbi_image_free(pendingTextures[i].pixels);
+    }
+
+    // Non-copyable: pending textures own decoded pixel memory
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+
+    void Upload() {
+        for (unsigned int i = 0; i < pendingTextures.size(); i++) {
+            unsigned int id = UploadTexture(pendingTextures[i]);
+            for (unsigned int j = 0; j < textures_loaded.size(); j++)
+                if (textures_loaded[j].path == pendingTextures[i].path) textures_loaded[j].id = id;
+            for (unsigned int m = 0; m < meshes.size(); m++)
+                for (unsigned int t = 0; t < meshes[m].textures.size(); t++)
+                    if (meshes[m].textures[t].path == pendingTextures[i].path) meshes[m].textures[t].id = id;
+        }
+        pendingTextures.clear();
+        for (unsigned int i = 0; i < meshes.size(); i++)
+            meshes[i].Upload();
+        deferUpload = false;
+    }
+
+    // Deletes the GL objects owned by this model (buffers and textures)
+    void Release() {
+        for (unsigned int i = 0; i < meshes.size(); i++)
+            meshes[i].Release();
+        for (unsigned int i = 0; i < textures_loaded.size(); i++)
+            if (textures_loaded[i].id) glDeleteTextures(1, &textures_loaded[i].id);
+        textures_loaded.clear();
+    }
+
+    size_t MemoryBytes() const {
+        size_t bytes = textureBytes;
+        for (unsigned int i = 0; i < meshes.size(); i++)
+            bytes += meshes[i].MemoryBytes();
+        return bytes;
+    }
+
     void Draw(Shader &shader) {
         for(unsigned int i = 0; i < meshes.size(); i++)
             meshes[i].Draw(shader);
     }
-    
-private:
-    void loadModel(std::string const &path) {
-        Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
-        
-        if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-            std::cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << std::endl;
-            return;
-        }
-        
-        // --- FIX: Handle paths with no directories (root folder files) ---
-        size_t lastSlash = path.find_last_of('/');
-        if (lastSlash == std::string::npos)
-            directory = "."; // Use current directory if no slash found
-        else
-            directory = path.substr(0, lastSlash);
 
-        processNode(scene->mRootNode, scene);
+    // Radius of a sphere around the local origin that holds every vertex (computed on first use)
+    float BoundingRadius() {
+        if (boundingRadius < 0.0f) {
+            boundingRadius = 0.0f;
+            for (unsigned int i = 0; i < meshes.size(); i++)
+                for (unsigned int v = 0; v < meshes[i].vertices.size(); v++)
+                    boundingRadius = std::max(boundingRadius, glm::length(meshes[i].vertices[v].Position));
+        }
+        return boundingRadius;
     }
 
-    void processNode(aiNode *node, const aiScene *scene) {
-        for(unsigned int i = 0; i < node->mNumMeshes; i++) {
-            aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-            meshes.push_back(processMesh(mesh, scene));
-        }
-        for(unsigned int i = 0; i < node->mNumChildren; i++) {
-            processNode(node->mChildren[i], scene);
+    // Ray in model-local space. The per-mesh BVHs live here, so every GameObject
+    // sharing this Model reuses them.
+    bool IntersectRay(const glm::vec3 &origin, const glm::vec3 &dir, RayHit &hit) const {
+        bool found = false;
+        for(unsigned int i = 0; i < meshes.size(); i++) {
+            if (meshes[i].IntersectRay(origin, dir, hit)) {
+                hit.mesh = i;
+                found = true;
+            }
         }
+        return found;
     }
 
-    Mesh processMesh(aiMesh *mesh, const aiScene *scene) {
-        std::vector<Vertex> vertices;
-        std::vector<unsigned int> indices;
-        std::vector<TextureStruct> textures;
-
+    // Assimp mesh -> engine vertex/index arrays (no GL, no materials)
+    static void ConvertMesh(const aiMesh *mesh, std::vector<Vertex> &vertices, std::vector<unsigned int> &indices) {
         for(unsigned int i = 0; i < mesh->mNumVertices; i++) {
             Vertex vertex;
             glm::vec3 vector; 
@@ -106,6 +155,50 @@ private:
             for(unsigned int j = 0; j < face.mNumIndices; j++)
                 indices.push_back(face.mIndices[j]);
         }
+    }
+    
+private:
+    bool deferUpload;
+    float boundingRadius = -1.0f;
+    std::vector<TextureData> pendingTextures;
+
+    void loadModel(std::string const &path) {
+        PROFILE_SCOPE("Model::loadModel");
+        PROFILE_MARK("asset", "model " + path);
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+        
+        if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+            LOG_ERROR("ASSIMP: %s", importer.GetErrorString());
+            return;
+        }
+        
+        // --- FIX: Handle paths with no directories (root folder files) ---
+        size_t lastSlash = path.find_last_of('/');
+        if (lastSlash == std::string::npos)
+            directory = "."; // Use current directory if no slash found
+        else
+            directory = path.substr(0, lastSlash);
+
+        processNode(scene->mRootNode, scene);
+    }
+
+    void processNode(aiNode *node, const aiScene *scene) {
+        for(unsigned int i = 0; i < node->mNumMeshes; i++) {
+            aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
+            meshes.push_back(processMesh(mesh, scene));
+        }
+        for(unsigned int i = 0; i < node->mNumChildren; i++) {
+            processNode(node->mChildren[i], scene);
+        }
+    }
+
+    Mesh processMesh(aiMesh *mesh, const aiScene *scene) {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        std::vector<TextureStruct> textures;
+
+        ConvertMesh(mesh, vertices, indices);
         
         aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];    
         
@@ -114,7 +207,7 @@ private:
         std::vector<TextureStruct> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
         textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
 
-        return Mesh(vertices, indices, textures);
+        return Mesh(vertices, indices, textures, !deferUpload);
     }
 
     std::vector<TextureStruct> loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName) {
@@ -132,7 +225,14 @@ private:
             }
             if(!skip) {
                 TextureStruct texture;
-                texture.id = TextureFromFile(str.C_Str(), this->directory);
+                TextureData data = DecodeTexture(str.C_Str(), this->directory);
+                textureBytes += (size_t)data.width * data.height * data.nrComponents * 4 / 3;
+                if (deferUpload) {
+                    pendingTextures.push_back(data);
+                    texture.id = 0; // filled in by Upload()
+                } else {
+                    texture.id = UploadTexture(data);
+                }
                 texture.type = typeName;
                 texture.path = str.C_Str();
                 textures.push_back(texture);
@@ -144,25 +244,39 @@ private:
 };
 
 unsigned int TextureFromFile(const char *path, const std::string &directory, bool gamma) {
-    std::string filename = std::string(path);
-    filename = directory + '/' + filename;
+    TextureData data = DecodeTexture(path, directory);
+    return UploadTexture(data);
+}
 
+TextureData DecodeTexture(const char *path, const std::string &directory) {
+    PROFILE_SCOPE("DecodeTexture");
+    TextureData data;
+    data.path = path;
+    std::string filename = directory + '/' + std::string(path);
+    PROFILE_MARK("asset", "texture " + filename);
+    data.pixels = stbi_load(filename.c_str(), &data.width, &data.height, &data.nrComponents, 0);
+    if (!data.pixels)
+        LOG_WARN("Texture failed to load at path: %s", filename.c_str());
+    return data;
+}
+
+// Creates the GL texture and releases the decoded pixels
+unsigned int UploadTexture(TextureData &data) {
+    PROFILE_SCOPE("UploadTexture");
     unsigned int textureID;
     glGenTextures(1, &textureID);
 
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    if (data) {
+    if (data.pixels) {
         GLenum format;
-        if (nrComponents == 1)
+        if (data.nrComponents == 1)
             format = GL_RED;
-        else if (nrComponents == 3)
+        else if (data.nrComponents == 3)
             format = GL_RGB;
-        else if (nrComponents == 4)
+        else if (data.nrComponents == 4)
             format = GL_RGBA;
 
         glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, data.width, data.height, 0, format, GL_UNSIGNED_BYTE, data.pixels);
         glGenerateMipmap(GL_TEXTURE_2D);
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -170,11 +284,8 @@ unsigned int TextureFromFile(const char *path, const std::string &directory, boo
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-        stbi_image_free(data);
-    }
-    else {
-        std::cout << "Texture failed to load at path: " << filename << std::endl;
-        stbi_image_free(data);
+        stbi_image_free(data.pixels);
+        data.pixels = nullptr;
     }
 
     return textureID;
@@ -0,0 +1,62 @@
+#ifndef MODELLIBRARY_H
+#define MODELLIBRARY_H
+
+#include "Model.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+// Owns every Model by path so scene objects that reference the same file share one copy
+// (and one set of GPU buffers and picking BVHs).
+class ModelLibrary {
+public:
+    // Returns the model for 'path', importing it synchronously on first use
+    Model* Get(const std::string &path) {
+        std::map<std::string, std::unique_ptr<Model>>::iterator it = models.find(path);
+        if (it != models.end()) return it->second.get();
+        Model *model = new Model(path);
+        models[path].reset(model);
+        return model;
+    }
+
+    // Imports all missing models in parallel and returns them in the order of 'paths'.
+    // Assimp import, vertex conversion, BVH builds and image decoding run on worker threads;
+    // only the GPU upload happens here, on the calling (GL) thread.
+    std::vector<Model*> LoadAll(const std::vector<std::string> &paths) {
+        PROFILE_SCOPE("ModelLibrary::LoadAll");
+        std::vector<std::string> missing;
+        for (unsigned int i = 0; i < paths.size(); i++)
+            if (models.find(paths[i]) == models.end() && std::find(missing.begin(), missing.end(), paths[i]) == missing.end())
+                missing.push_back(paths[i]);
+
+        std::vector<std::unique_ptr<Model>> imported(missing.size());
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (size_t i = next++; i < missing.size(); i = next++)
+                imported[i].reset(new Model(missing[i], false, true));
+        };
+        unsigned int threadCount = std::min<unsigned int>(std::max(1u, std::thread::hardware_concurrency()), (unsigned int)missing.size());
+        std::vector<std::thread> threads;
+        for (unsigned int t = 1; t < threadCount; t++) threads.emplace_back(worker);
+        worker();
+        for (unsigned int t = 0; t < threads.size(); t++) threads[t].join();
+
+        for (unsigned int i = 0; i < missing.size(); i++) {
+            imported[i]->Upload();
+            models[missing[i]] = std::move(imported[i]);
+        }
+
+        std::vector<Model*> result(paths.size());
+        for (unsigned int i = 0; i < paths.size(); i++) result[i] = models[paths[i]].get();
+        return result;
+    }
+
+private:
+    std::map<std::string, std::unique_ptr<Model>> models;
+};
+#endif
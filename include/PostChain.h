@@ -0,0 +1,181 @@
+#ifndef POSTCHAIN_H
+#define POSTCHAIN_H
+
+#include "RenderGraph.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Post-process effects, in the order the editor lists them
+enum PostEffectType { POST_INVERT, POST_GRAYSCALE, POST_SHARPEN, POST_EDGE_DETECT, POST_BLUR, POST_COLOR_GRADE, POST_FXAA, POST_EFFECT_TYPES };
+// Resolution a spatial effect runs at; anything below full is upsampled back before the next effect
+enum PostScale { POST_FULL, POST_HALF, POST_QUARTER };
+
+inline const char* PostEffectName(int type) {
+    static const char *names[] = { "Invert", "Grayscale", "Sharpen", "Edge Detect", "Blur", "Color Grade", "FXAA" };
+    return type >= 0 && type < POST_EFFECT_TYPES ? names[type] : "?";
+}
+
+// A pure function of the pixel's color: baked into a color stage's 3D LUT (ColorLut)
+inline bool PostEffectPerPixel(int type) { return type == POST_INVERT || type == POST_GRAYSCALE || type == POST_COLOR_GRADE; }
+// Can run at a lower resolution (anti-aliasing only makes sense at the output's)
+inline bool PostEffectScalable(int type) { return !PostEffectPerPixel(type) && type != POST_FXAA; }
+
+struct PostEffect {
+    PostEffectType type = POST_INVERT;
+    PostScale scale = POST_FULL; // scalable effects only, the others always run at full size
+    float radius = 2.0f;         // blur: Gaussian sigma in output pixels (taps reach 14 texels: wide blurs belong at a lower scale)
+    float exposure = 0.0f;       // color grade: stops
+    float contrast = 1.0f;       // color grade: around mid gray
+    float saturation = 1.0f;     // color grade: 0 = luma only
+    bool enabled = true;
+};
+
+// What a per-pixel effect does to one color in [0, 1] (the LUT bake runs this for every texel)
+inline glm::vec3 ApplyPostColor(const PostEffect &e, glm::vec3 c) {
+    const glm::vec3 luma(0.2126f, 0.7152f, 0.0722f);
+    switch (e.type) {
+    case POST_INVERT: c = 1.0f - c; break;
+    case POST_GRAYSCALE: c = glm::vec3(glm::dot(c, luma)); break;
+    case POST_COLOR_GRADE: {
+        c *= std::exp2(e.exposure);
+        c = (c - 0.5f) * e.contrast + 0.5f;
+        float y = glm::dot(c, luma);
+        c = y + (c - y) * e.saturation;
+        break;
+    }
+    default: break;
+    }
+    return glm::clamp(c, 0.0f, 1.0f); // as an 8-bit target between passes would
+}
+
+// Ordered list of effects applied to the lit scene, and the passes it turns into.
+//  - Consecutive per-pixel effects are fused into one pass that makes a single 3D LUT fetch per
+//    pixel (screen.frag); the LUT is baked on the CPU when their settings change, so stacking
+//    color effects costs nothing on the GPU.
+//  - Sharpen and edge detection are 3x3 kernels one texel apart at the effect's resolution.
+//  - FXAA searches along luma edges and blends across them, always at full resolution.
+//  - Blur is a separable Gaussian: a horizontal then a vertical pass, each tap a bilinear fetch
+//    that weighs two texels.
+//  - An effect at half or quarter resolution renders into a smaller target and is brought back
+//    by a bilateral upsample that weighs the low-resolution texels by scene depth, so it does not
+//    bleed across silhouettes.
+// Renderer declares the stages as render graph passes. Every intermediate target is its own graph
+// resource; the graph's pool aliases those of equal size, which makes them ping-pong pairs.
+class PostChain {
+public:
+    static const int MAX_BLUR_TAPS = 8; // blur.frag's arrays: the center and 7 bilinear taps per side
+
+    enum StageKind { STAGE_COLOR, STAGE_KERNEL, STAGE_BLUR_H, STAGE_BLUR_V, STAGE_UPSAMPLE, STAGE_FXAA };
+    struct Stage {
+        StageKind kind;
+        int effect, end; // effects[effect, end) (the enabled ones; one effect unless fused)
+        PostScale scale;
+        RGResource input, output; // assigned by the renderer; output RG_NONE = the frame's output
+        int lut;                  // color stage: the renderer's ColorLut
+    };
+
+    std::vector<PostEffect> effects;
+    int scaleBias = 0; // steps every spatial effect's resolution further down (quality governor)
+
+    // The resolution an effect actually runs at
+    PostScale Scale(const PostEffect &e) const {
+        if (!PostEffectScalable(e.type)) return POST_FULL;
+        return (PostScale)std::min((int)e.scale + std::max(scaleBias, 0), (int)POST_QUARTER);
+    }
+
+    // Changes whenever the stages would (not for parameters); cheap enough to compare every frame
+    uint32_t Shape() const {
+        uint32_t h = 2166136261u;
+        for (const PostEffect &e : effects) {
+            uint32_t v = e.enabled ? 1u + (uint32_t)e.type * 4u + (uint32_t)Scale(e) : 0u;
+            h = (h ^ v) * 16777619u;
+        }
+        return h;
+    }
+
+    bool Empty() const {
+        for (const PostEffect &e : effects) if (e.enabled) return false;
+        return true;
+    }
+
+    // The passes for the current effects, in order
+    std::vector<Stage>& Plan() {
+        stages.clear();
+        for (int i = 0; i < (int)effects.size(); i++) {
+            const PostEffect &e = effects[i];
+            if (!e.enabled) continue;
+            if (PostEffectPerPixel(e.type)) {
+                if (!stages.empty() && stages.back().kind == STAGE_COLOR) stages.back().end = i + 1;
+                else stages.push_back(stage(STAGE_COLOR, i, POST_FULL));
+                continue;
+            }
+            if (e.type == POST_FXAA) {
+                stages.push_back(stage(STAGE_FXAA, i, POST_FULL));
+                continue;
+            }
+            if (e.type == POST_BLUR) {
+                stages.push_back(stage(STAGE_BLUR_H, i, Scale(e)));
+                stages.push_back(stage(STAGE_BLUR_V, i, Scale(e)));
+            } else stages.push_back(stage(STAGE_KERNEL, i, Scale(e)));
+            if (Scale(e) != POST_FULL) stages.push_back(stage(STAGE_UPSAMPLE, i, POST_FULL));
+        }
+        return stages;
+    }
+    std::vector<Stage>& Stages() { return stages; }
+
+    // Identifies the color transform of effects[begin, end): equal values bake equal LUTs
+    uint32_t ColorHash(int begin, int end) const {
+        uint32_t h = 2166136261u;
+        for (int i = begin; i < end; i++) {
+            const PostEffect &e = effects[i];
+            if (!e.enabled || !PostEffectPerPixel(e.type)) continue;
+            float values[4] = { (float)e.type, e.exposure, e.contrast, e.saturation };
+            unsigned char bytes[sizeof(values)];
+            std::memcpy(bytes, values, sizeof(values));
+            for (unsigned char b : bytes) h = (h ^ b) * 16777619u;
+        }
+        return h;
+    }
+
+    // Gaussian of 'sigma' texels folded into bilinear taps: weights[0] is the center texel,
+    // taps i > 0 are read at +-offsets[i]. Returns the number of taps (<= MAX_BLUR_TAPS).
+    static int BlurTaps(float sigma, float *weights, float *offsets) {
+        const int maxRadius = 2 * (MAX_BLUR_TAPS - 1);
+        sigma = std::max(sigma, 0.5f);
+        int radius = std::min((int)std::ceil(sigma * 3.0f), maxRadius);
+        float texel[maxRadius + 1], sum = 0.0f;
+        for (int i = 0; i <= radius; i++) {
+            texel[i] = std::exp(-0.5f * i * i / (sigma * sigma));
+            sum += i ? 2.0f * texel[i] : texel[i];
+        }
+        weights[0] = texel[0] / sum; offsets[0] = 0.0f;
+        int taps = 1;
+        for (int i = 1; i <= radius; i += 2) {
+            float a = texel[i], b = i + 1 <= radius ? texel[i + 1] : 0.0f;
+            weights[taps] = (a + b) / sum;
+            offsets[taps] = (i * a + (i + 1) * b) / (a + b);
+            taps++;
+        }
+        return taps;
+    }
+
+    static int Scaled(int size, PostScale scale) { return std::max(size >> (int)scale, 1); }
+
+private:
+    std::vector<Stage> stages;
+
+    static Stage stage(StageKind kind, int effect, PostScale scale) {
+        Stage s;
+        s.kind = kind; s.effect = effect; s.end = effect + 1; s.scale = scale;
+        s.input = s.output = RG_NONE;
+        s.lut = -1;
+        return s;
+    }
+};
+#endif
@@ -0,0 +1,424 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+// Hierarchical frame profiler.
+//  - PROFILE_SCOPE("name") times a CPU zone on any thread; zones nest per thread.
+//  - PROFILE_GPU_SCOPE("name") additionally wraps the zone in a GL_TIME_ELAPSED query. Timer
+//    queries cannot nest, so GPU zones are meant for top-level passes. Queries are double
+//    buffered by frame parity and read back two frames later, only if already available,
+//    so the profiler never waits on the GPU.
+//  - Per-zone rolling statistics (CPU and GPU) are kept for the last HISTORY frames.
+//  - StartCapture() records every zone of the next N frames and writes them as a Chrome
+//    trace_event JSON file (load it in chrome://tracing or Perfetto).
+//  - PROFILE_MARK("category", text) drops an instant marker (asset loads, scene edits...) into
+//    the current frame; the text is copied, so it can be built on the fly.
+//  - The hitch recorder keeps the last N frames in a ring buffer at all times. A frame slower
+//    than the budget writes them, with their markers, as a trace (same format as a capture)
+//    once its GPU results are in. Dumps are at most one per ring length.
+// Zone names must be string literals (or otherwise outlive the profiler).
+
+struct ProfileEvent {
+    const char *name;
+    uint64_t start;    // ns since profiler start (CPU clock; GPU events use the CPU time the query began)
+    uint64_t duration; // ns
+    uint64_t frame;
+    uint32_t thread;   // 0 = main thread, GPU events use GPU_THREAD
+    uint16_t depth;
+    uint16_t gpu;
+};
+
+struct ProfileMarker {
+    const char *category; // string literal
+    std::string text;
+    uint64_t time;        // ns since profiler start
+    uint64_t frame;
+    uint32_t thread;
+};
+
+class Profiler {
+public:
+    static const int HISTORY = 120;
+    static const uint32_t GPU_THREAD = 0xFFFFFFFFu;
+
+    struct ZoneStats {
+        const char *name;
+        float cpuMs[HISTORY];
+        float gpuMs[HISTORY];
+        bool hasGpu;
+        float cpuAvg, cpuMax, gpuAvg, gpuMax;
+    };
+
+    // The first thread to touch the profiler becomes thread 0, the "main" thread the stats track
+    static Profiler& Get() {
+        static Profiler instance;
+        return instance;
+    }
+
+    Profiler() { ThreadIndex(); }
+
+    // Must be called on the GL thread after the context exists to enable GPU zones
+    void EnableGpu() {
+        if (gpuEnabled) return;
+        for (int set = 0; set < 2; set++) gpuQueries[set].reserve(32);
+        gpuEnabled = true;
+    }
+
+    static uint64_t Now() {
+        static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+    static uint32_t ThreadIndex() {
+        static std::atomic<uint32_t> next(0);
+        thread_local uint32_t index = next++;
+        return index;
+    }
+
+    void BeginFrame() {
+        frame++;
+        frameStart = Now();
+        collectGpu();
+    }
+
+    void EndFrame() {
+        uint64_t end = Now();
+        std::lock_guard<std::mutex> lock(mutex);
+        lastFrameStart = frameStart;
+        lastFrameEnd = end;
+        lastFrameEvents.swap(frameEvents);
+        frameEvents.clear();
+        lastMarkers.swap(frameMarkers);
+        frameMarkers.clear();
+        lastGpuEvents.swap(gpuResults);
+        gpuResults.clear();
+        frameHistory[frame % HISTORY] = (float)((end - frameStart) / 1e6);
+        updateStats();
+        if (capturing) {
+            if (frame <= captureLastFrame) {
+                captured.insert(captured.end(), lastFrameEvents.begin(), lastFrameEvents.end());
+                capturedMarkers.insert(capturedMarkers.end(), lastMarkers.begin(), lastMarkers.end());
+                captureFrames.push_back(std::make_pair(lastFrameStart, lastFrameEnd));
+            }
+            for (const ProfileEvent &e : lastGpuEvents)
+                if (e.frame >= captureFirstFrame && e.frame <= captureLastFrame) captured.push_back(e);
+            if (frame >= captureLastFrame + 2) writeCapture(); // GPU results lag two frames
+        }
+        if (!recorder.empty()) recordFrame();
+    }
+
+    // Zone API, normally used through the macros below
+    void BeginZone(const char *name = nullptr) {
+        int d = depth()++;
+        if (d < MAX_ZONE_DEPTH) zoneNames()[d] = name;
+    }
+
+    void EndZone(const char *name, uint64_t start) {
+        uint16_t d = (uint16_t)--depth();
+        ProfileEvent e = { name, start, Now() - start, frame, ThreadIndex(), d, 0 };
+        std::lock_guard<std::mutex> lock(mutex);
+        frameEvents.push_back(e);
+    }
+
+    int BeginGpuZone(const char *name, uint64_t start) {
+        if (!gpuEnabled || gpuActive) return -1;
+        std::vector<GpuQuery> &pool = gpuQueries[frame & 1];
+        size_t &used = gpuUsed[frame & 1];
+        if (used == pool.size()) {
+            GpuQuery q;
+            glGenQueries(1, &q.id);
+            pool.push_back(q);
+        }
+        GpuQuery &q = pool[used];
+        q.name = name;
+        q.start = start;
+        q.frame = frame;
+        q.depth = (uint16_t)(depth() - 1);
+        glBeginQuery(GL_TIME_ELAPSED, q.id);
+        gpuActive = true;
+        return (int)used++;
+    }
+
+    void EndGpuZone(int query) {
+        if (query < 0) return;
+        glEndQuery(GL_TIME_ELAPSED);
+        gpuActive = false;
+    }
+
+    void StartCapture(int frames, const std::string &path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        captured.clear();
+        captureFrames.clear();
+        capturePath = path;
+        captureFirstFrame = frame + 1;
+        captureLastFrame = frame + (uint64_t)frames;
+        capturing = true;
+    }
+    bool Capturing() const { return capturing; }
+
+    void Mark(const char *category, const std::string &text) {
+        ProfileMarker m = { category, text, Now(), frame, ThreadIndex() };
+        std::lock_guard<std::mutex> lock(mutex);
+        frameMarkers.push_back(m);
+    }
+
+    // Keeps the last 'frames' frames; frames slower than budgetMs dump them to <prefix><frame>.json.
+    // frames = 0 turns the recorder off.
+    void SetHitchRecorder(int frames, float budgetMs, const std::string &prefix) {
+        std::lock_guard<std::mutex> lock(mutex);
+        recorder.clear();
+        recorder.resize((size_t)std::max(frames, 0));
+        hitchBudgetMs = budgetMs;
+        hitchPrefix = prefix;
+        hitchFrame = 0;
+        hitchQuietUntil = frame + 3; // skip the first frames after (re)arming: startup and the resize itself
+    }
+    void SetHitchBudget(float ms) { hitchBudgetMs = ms; }
+    float HitchBudget() const { return hitchBudgetMs; }
+    int HitchRecorderFrames() const { return (int)recorder.size(); }
+    int HitchDumps() const { return hitchDumps; }
+    const std::string& LastHitchFile() const { return lastHitchFile; }
+
+    // Valid between EndFrame() and the next EndFrame(), on the main thread
+    const std::vector<ProfileEvent>& LastFrameEvents() const { return lastFrameEvents; }
+    const std::vector<ProfileEvent>& LastGpuEvents() const { return lastGpuEvents; }
+    const std::vector<ProfileMarker>& LastFrameMarkers() const { return lastMarkers; }
+    const std::vector<ZoneStats>& Stats() const { return stats; }
+    // GPU time of the frame whose timer results came in last (its GPU zones summed); 0 if none did
+    float LastGpuFrameMs() const {
+        uint64_t ns = 0;
+        for (const ProfileEvent &e : lastGpuEvents) ns += e.duration;
+        return ns / 1e6f;
+    }
+    // Innermost open zone on the calling thread, null outside any zone
+    static const char* CurrentZone() {
+        int d = depth();
+        return d > 0 ? zoneNames()[std::min(d, MAX_ZONE_DEPTH) - 1] : nullptr;
+    }
+    uint64_t LastFrameStart() const { return lastFrameStart; }
+    uint64_t LastFrameEnd() const { return lastFrameEnd; }
+    uint64_t FrameIndex() const { return frame; }
+    const float* FrameHistory() const { return frameHistory; }
+    int FrameHistoryOffset() const { return (int)((frame + 1) % HISTORY); }
+
+private:
+    struct GpuQuery {
+        GLuint id = 0;
+        const char *name = nullptr;
+        uint64_t start = 0;
+        uint64_t frame = 0;
+        uint16_t depth = 0;
+    };
+
+    std::mutex mutex;
+    std::atomic<uint64_t> frame{0};
+    uint64_t frameStart = 0, lastFrameStart = 0, lastFrameEnd = 0;
+    std::vector<ProfileEvent> frameEvents, lastFrameEvents;
+    std::vector<ProfileEvent> gpuResults, lastGpuEvents;
+    std::vector<ProfileMarker> frameMarkers, lastMarkers;
+    std::vector<ZoneStats> stats;
+    float frameHistory[HISTORY] = {};
+
+    bool gpuEnabled = false;
+    bool gpuActive = false;
+    std::vector<GpuQuery> gpuQueries[2];
+    size_t gpuUsed[2] = { 0, 0 };
+
+    bool capturing = false;
+    uint64_t captureFirstFrame = 0, captureLastFrame = 0;
+    std::string capturePath;
+    std::vector<ProfileEvent> captured;
+    std::vector<ProfileMarker> capturedMarkers;
+    std::vector<std::pair<uint64_t, uint64_t>> captureFrames;
+
+    // Hitch recorder ring, slot = frame % size. Slots keep their vectors' capacity, so once
+    // warmed up the recorder copies events without allocating.
+    struct RecordedFrame {
+        uint64_t frame = 0, start = 0, end = 0;
+        std::vector<ProfileEvent> events; // CPU zones, then GPU zones as they arrive
+        std::vector<ProfileMarker> markers;
+    };
+    std::vector<RecordedFrame> recorder;
+    float hitchBudgetMs = 0.0f;
+    std::string hitchPrefix, lastHitchFile;
+    uint64_t hitchFrame = 0, hitchQuietUntil = 0;
+    float hitchMs = 0.0f;
+    int hitchDumps = 0;
+
+    static const int MAX_ZONE_DEPTH = 64;
+
+    static int& depth() {
+        thread_local int d = 0;
+        return d;
+    }
+    static const char** zoneNames() {
+        thread_local const char *names[MAX_ZONE_DEPTH] = {};
+        return names;
+    }
+
+    // Reads the queries issued two frames ago (same parity) that the GPU has finished
+    void collectGpu() {
+        if (!gpuEnabled) return;
+        int set = frame & 1;
+        for (size_t i = 0; i < gpuUsed[set]; i++) {
+            GpuQuery &q = gpuQueries[set][i];
+            GLint available = 0;
+            glGetQueryObjectiv(q.id, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) continue; // dropped sample rather than a stall
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(q.id, GL_QUERY_RESULT, &ns);
+            ProfileEvent e = { q.name, q.start, (uint64_t)ns, q.frame, GPU_THREAD, q.depth, 1 };
+            std::lock_guard<std::mutex> lock(mutex);
+            gpuResults.push_back(e);
+        }
+        gpuUsed[set] = 0;
+    }
+
+    ZoneStats& zone(const char *name) {
+        for (ZoneStats &z : stats)
+            if (z.name == name || std::strcmp(z.name, name) == 0) return z;
+        stats.emplace_back();
+        ZoneStats &z = stats.back();
+        std::memset(&z, 0, sizeof(z));
+        z.name = name;
+        return z;
+    }
+
+    void updateStats() {
+        int slot = (int)(frame % HISTORY);
+        for (ZoneStats &z : stats) { z.cpuMs[slot] = 0.0f; z.gpuMs[slot] = 0.0f; }
+        for (const ProfileEvent &e : lastFrameEvents)
+            if (e.thread == 0) zone(e.name).cpuMs[slot] += e.duration / 1e6f;
+        for (const ProfileEvent &e : lastGpuEvents) {
+            ZoneStats &z = zone(e.name);
+            z.gpuMs[slot] += e.duration / 1e6f;
+            z.hasGpu = true;
+        }
+        for (ZoneStats &z : stats) {
+            z.cpuAvg = z.cpuMax = z.gpuAvg = z.gpuMax = 0.0f;
+            for (int i = 0; i < HISTORY; i++) {
+                z.cpuAvg += z.cpuMs[i]; if (z.cpuMs[i] > z.cpuMax) z.cpuMax = z.cpuMs[i];
+                z.gpuAvg += z.gpuMs[i]; if (z.gpuMs[i] > z.gpuMax) z.gpuMax = z.gpuMs[i];
+            }
+            z.cpuAvg /= HISTORY;
+            z.gpuAvg /= HISTORY;
+        }
+    }
+
+    static void writeJsonString(std::ofstream &out, const char *s) {
+        out << '"';
+        for (; *s; s++) {
+            if (*s == '"' || *s == '\\') out << '\\';
+            out << *s;
+        }
+        out << '"';
+    }
+
+    // Called from EndFrame() with the mutex held
+    void recordFrame() {
+        RecordedFrame &r = recorder[frame % recorder.size()];
+        r.frame = frame; r.start = lastFrameStart; r.end = lastFrameEnd;
+        r.events.assign(lastFrameEvents.begin(), lastFrameEvents.end());
+        r.markers.assign(lastMarkers.begin(), lastMarkers.end());
+        for (const ProfileEvent &e : lastGpuEvents) {
+            RecordedFrame &owner = recorder[e.frame % recorder.size()];
+            if (owner.frame == e.frame) owner.events.push_back(e);
+        }
+
+        float ms = (float)((lastFrameEnd - lastFrameStart) / 1e6);
+        if (hitchFrame == 0 && hitchBudgetMs > 0.0f && ms > hitchBudgetMs && frame >= hitchQuietUntil) { hitchFrame = frame; hitchMs = ms; }
+        if (hitchFrame == 0 || frame < hitchFrame + 2) return; // GPU results lag two frames
+
+        std::vector<std::pair<uint64_t, uint64_t>> frames;
+        std::vector<ProfileEvent> events;
+        std::vector<ProfileMarker> markers;
+        for (size_t i = 1; i <= recorder.size(); i++) { // oldest first
+            const RecordedFrame &f = recorder[(frame + i) % recorder.size()];
+            if (f.end == 0) continue;
+            frames.push_back(std::make_pair(f.start, f.end));
+            events.insert(events.end(), f.events.begin(), f.events.end());
+            markers.insert(markers.end(), f.markers.begin(), f.markers.end());
+        }
+        char detail[96];
+        snprintf(detail, sizeof(detail), "frame %llu took %.1f ms (budget %.1f ms)", (unsigned long long)hitchFrame, hitchMs, hitchBudgetMs);
+        ProfileMarker hitch = { "hitch", detail, recorder[hitchFrame % recorder.size()].start, hitchFrame, 0 };
+        markers.push_back(hitch);
+        lastHitchFile = hitchPrefix + std::to_string(hitchFrame) + ".json";
+        if (writeTrace(lastHitchFile, frames, events, markers)) hitchDumps++;
+        hitchFrame = 0;
+        hitchQuietUntil = frame + recorder.size(); // the dump itself is slow; never chain dumps
+    }
+
+    void writeCapture() {
+        capturing = false;
+        writeTrace(capturePath, captureFrames, captured, capturedMarkers);
+        captured.clear();
+        capturedMarkers.clear();
+        captureFrames.clear();
+    }
+
+    static bool writeTrace(const std::string &path, const std::vector<std::pair<uint64_t, uint64_t>> &frames, const std::vector<ProfileEvent> &events, const std::vector<ProfileMarker> &markers) {
+        std::ofstream out(path);
+        if (!out.is_open()) return false;
+        out << "{\"traceEvents\":[\n";
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Main\"}},\n";
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << GPU_THREAD << ",\"args\":{\"name\":\"GPU\"}}";
+        out.precision(3);
+        out << std::fixed;
+        for (const std::pair<uint64_t, uint64_t> &f : frames)
+            out << ",\n{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":" << f.first / 1e3 << ",\"dur\":" << (f.second - f.first) / 1e3 << "}";
+        for (const ProfileEvent &e : events) {
+            out << ",\n{\"name\":";
+            writeJsonString(out, e.name);
+            out << ",\"cat\":\"" << (e.gpu ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+                << ",\"ts\":" << e.start / 1e3 << ",\"dur\":" << e.duration / 1e3 << ",\"args\":{\"frame\":" << e.frame << "}}";
+        }
+        for (const ProfileMarker &m : markers) {
+            out << ",\n{\"name\":";
+            writeJsonString(out, m.text.c_str());
+            out << ",\"cat\":";
+            writeJsonString(out, m.category);
+            out << ",\"ph\":\"i\",\"s\":\"" << (std::strcmp(m.category, "hitch") == 0 ? 'g' : 't') << "\",\"pid\":1,\"tid\":" << m.thread
+                << ",\"ts\":" << m.time / 1e3 << ",\"args\":{\"frame\":" << m.frame << "}}";
+        }
+        out << "\n]}\n";
+        return out.good();
+    }
+};
+
+class ProfileScope {
+public:
+    ProfileScope(const char *name, bool gpu = false) : name(name), start(Profiler::Now()) {
+        Profiler &p = Profiler::Get();
+        p.BeginZone(name);
+        query = gpu ? p.BeginGpuZone(name, start) : -1;
+    }
+    ~ProfileScope() {
+        Profiler &p = Profiler::Get();
+        p.EndGpuZone(query);
+        p.EndZone(name, start);
+    }
+private:
+    const char *name;
+    uint64_t start;
+    int query;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_GPU_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name, true)
+#define PROFILE_MARK(category, text) Profiler::Get().Mark(category, text)
+#endif
@@ -0,0 +1,208 @@
+#ifndef PROFILERUI_H
+#define PROFILERUI_H
+
+#include "Profiler.h"
+#include "imgui.h"
+
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+// ImGui front end for the Profiler: rolling per-zone stats, a timeline of the last frame
+// (one lane per thread plus a GPU lane) and a flame view averaged over recent frames.
+class ProfilerWindow {
+public:
+    bool visible = true;
+    int captureFrames = 120;
+    char capturePath[256] = "profile_capture.json";
+
+    void Draw(Profiler &profiler) {
+        updateFlame(profiler);
+        if (!visible) return;
+        if (!ImGui::Begin("Profiler", &visible)) { ImGui::End(); return; }
+
+        const float *history = profiler.FrameHistory();
+        float avg = 0.0f, worst = 0.0f;
+        for (int i = 0; i < Profiler::HISTORY; i++) { avg += history[i]; worst = std::max(worst, history[i]); }
+        avg /= Profiler::HISTORY;
+        char overlay[64];
+        snprintf(overlay, sizeof(overlay), "avg %.2f ms  max %.2f ms", avg, worst);
+        ImGui::PlotLines("##frametimes", history, Profiler::HISTORY, profiler.FrameHistoryOffset(), overlay, 0.0f, std::max(worst, 16.7f), ImVec2(-1, 50));
+
+        ImGui::SetNextItemWidth(80);
+        ImGui::InputInt("Frames", &captureFrames);
+        captureFrames = std::max(1, captureFrames);
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(200);
+        ImGui::InputText("##capturepath", capturePath, sizeof(capturePath));
+        ImGui::SameLine();
+        if (profiler.Capturing()) ImGui::Text("Capturing...");
+        else if (ImGui::Button("Capture")) profiler.StartCapture(captureFrames, capturePath);
+
+        // Hitch recorder: always running, dumps the last frames when one exceeds the budget
+        float budget = profiler.HitchBudget();
+        ImGui::SetNextItemWidth(80);
+        if (ImGui::InputFloat("Hitch budget (ms)", &budget, 0.0f, 0.0f, "%.1f")) profiler.SetHitchBudget(std::max(budget, 0.0f));
+        ImGui::SameLine();
+        if (profiler.HitchRecorderFrames() == 0) ImGui::TextDisabled("recorder off");
+        else if (profiler.HitchDumps() == 0) ImGui::TextDisabled("last %d frames kept, no hitches", profiler.HitchRecorderFrames());
+        else ImGui::Text("%d dump(s), last: %s", profiler.HitchDumps(), profiler.LastHitchFile().c_str());
+
+        if (ImGui::BeginTabBar("ProfilerViews")) {
+            if (ImGui::BeginTabItem("Zones")) { drawStats(profiler); ImGui::EndTabItem(); }
+            if (ImGui::BeginTabItem("Timeline")) { drawTimeline(profiler); ImGui::EndTabItem(); }
+            if (ImGui::BeginTabItem("Flame")) { drawFlame(avg); ImGui::EndTabItem(); }
+            ImGui::EndTabBar();
+        }
+        ImGui::End();
+    }
+
+private:
+    struct FlameNode {
+        const char *name;
+        int parent;
+        float ms;      // smoothed
+        float frameMs; // this frame
+    };
+    std::vector<FlameNode> flame;
+    std::vector<ProfileEvent> sorted;
+    std::vector<std::pair<uint64_t, int>> stack;
+
+    static ImU32 zoneColor(const char *name) {
+        unsigned int h = 2166136261u;
+        for (; *name; name++) h = (h ^ (unsigned char)*name) * 16777619u;
+        return IM_COL32(90 + (h & 0x7F), 90 + ((h >> 8) & 0x7F), 90 + ((h >> 16) & 0x7F), 255);
+    }
+
+    void drawStats(Profiler &profiler) {
+        if (!ImGui::BeginTable("ZoneStats", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) return;
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("CPU avg");
+        ImGui::TableSetupColumn("CPU max");
+        ImGui::TableSetupColumn("GPU avg");
+        ImGui::TableSetupColumn("GPU max");
+        ImGui::TableHeadersRow();
+        for (const Profiler::ZoneStats &z : profiler.Stats()) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(z.name);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", z.cpuAvg);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", z.cpuMax);
+            ImGui::TableNextColumn(); if (z.hasGpu) ImGui::Text("%.3f", z.gpuAvg); else ImGui::TextDisabled("-");
+            ImGui::TableNextColumn(); if (z.hasGpu) ImGui::Text("%.3f", z.gpuMax); else ImGui::TextDisabled("-");
+        }
+        ImGui::EndTable();
+    }
+
+    static void drawBar(ImDrawList *draw, ImVec2 min, ImVec2 max, const char *name, float ms) {
+        if (max.x - min.x < 1.0f) max.x = min.x + 1.0f;
+        draw->AddRectFilled(min, max, zoneColor(name));
+        draw->AddRect(min, max, IM_COL32(0, 0, 0, 128));
+        if (ImGui::CalcTextSize(name).x < max.x - min.x - 4.0f) {
+            draw->PushClipRect(min, max, true);
+            draw->AddText(ImVec2(min.x + 2.0f, min.y + 1.0f), IM_COL32(0, 0, 0, 255), name);
+            draw->PopClipRect();
+        }
+        if (ImGui::IsMouseHoveringRect(min, max)) ImGui::SetTooltip("%s\n%.3f ms", name, ms);
+    }
+
+    void drawTimeline(Profiler &profiler) {
+        const std::vector<ProfileEvent> &events = profiler.LastFrameEvents();
+        const std::vector<ProfileEvent> &gpu = profiler.LastGpuEvents();
+        uint64_t frameStart = profiler.LastFrameStart();
+        double frameNs = (double)std::max<uint64_t>(profiler.LastFrameEnd() - frameStart, 1);
+        float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+        float width = ImGui::GetContentRegionAvail().x;
+        ImDrawList *draw = ImGui::GetWindowDrawList();
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImGui::Text("Frame %llu: %.3f ms", (unsigned long long)profiler.FrameIndex(), frameNs / 1e6);
+        float y = origin.y + rowHeight;
+
+        // CPU lanes, one per thread that recorded something this frame
+        uint32_t maxThread = 0;
+        for (const ProfileEvent &e : events) maxThread = std::max(maxThread, e.thread);
+        for (uint32_t thread = 0; thread <= maxThread; thread++) {
+            int depth = -1;
+            for (const ProfileEvent &e : events) {
+                if (e.thread != thread) continue;
+                depth = std::max(depth, (int)e.depth);
+                // Worker zones may have started in an earlier frame; clamp them to the frame
+                double x0 = e.start > frameStart ? (e.start - frameStart) / frameNs : 0.0;
+                double x1 = (e.start + e.duration - frameStart) / frameNs;
+                float top = y + rowHeight + e.depth * rowHeight;
+                drawBar(draw, ImVec2(origin.x + (float)(x0 * width), top), ImVec2(origin.x + (float)(std::min(x1, 1.0) * width), top + rowHeight - 1.0f), e.name, e.duration / 1e6f);
+            }
+            if (depth < 0) continue;
+            draw->AddText(ImVec2(origin.x, y), ImGui::GetColorU32(ImGuiCol_TextDisabled), thread == 0 ? "Main" : "Worker");
+            y += (depth + 2) * rowHeight;
+        }
+
+        // GPU lane: results arrive two frames late, so lay them end to end on the same scale
+        draw->AddText(ImVec2(origin.x, y), ImGui::GetColorU32(ImGuiCol_TextDisabled), "GPU");
+        float x = origin.x;
+        for (const ProfileEvent &e : gpu) {
+            float w = (float)(e.duration / frameNs * width);
+            drawBar(draw, ImVec2(x, y + rowHeight), ImVec2(x + w, y + 2.0f * rowHeight - 1.0f), e.name, e.duration / 1e6f);
+            x += w;
+        }
+        y += 2.0f * rowHeight;
+        ImGui::Dummy(ImVec2(width, y - origin.y - rowHeight));
+    }
+
+    int flameChild(int parent, const char *name) {
+        for (unsigned int i = 0; i < flame.size(); i++)
+            if (flame[i].parent == parent && (flame[i].name == name || std::strcmp(flame[i].name, name) == 0)) return (int)i;
+        FlameNode node = { name, parent, 0.0f, 0.0f };
+        flame.push_back(node);
+        return (int)flame.size() - 1;
+    }
+
+    // Merges the main thread's zones into a call tree keyed by (parent, name)
+    void updateFlame(Profiler &profiler) {
+        sorted.clear();
+        for (const ProfileEvent &e : profiler.LastFrameEvents())
+            if (e.thread == 0) sorted.push_back(e);
+        std::sort(sorted.begin(), sorted.end(), [](const ProfileEvent &a, const ProfileEvent &b) {
+            return a.start != b.start ? a.start < b.start : a.depth < b.depth;
+        });
+        for (FlameNode &n : flame) n.frameMs = 0.0f;
+        stack.clear();
+        for (const ProfileEvent &e : sorted) {
+            while (!stack.empty() && e.start >= stack.back().first) stack.pop_back();
+            int node = flameChild(stack.empty() ? -1 : stack.back().second, e.name);
+            flame[node].frameMs += e.duration / 1e6f;
+            stack.push_back(std::make_pair(e.start + e.duration, node));
+        }
+        for (FlameNode &n : flame) n.ms = n.ms * 0.9f + n.frameMs * 0.1f;
+    }
+
+    void drawFlameNode(ImDrawList *draw, int node, float x, float y, float msToPx, float rowHeight) {
+        const FlameNode &n = flame[node];
+        drawBar(draw, ImVec2(x, y), ImVec2(x + n.ms * msToPx, y + rowHeight - 1.0f), n.name, n.ms);
+        for (unsigned int i = 0; i < flame.size(); i++) {
+            if (flame[i].parent != node) continue;
+            drawFlameNode(draw, (int)i, x, y + rowHeight, msToPx, rowHeight);
+            x += flame[i].ms * msToPx;
+        }
+    }
+
+    void drawFlame(float frameMs) {
+        float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+        float width = ImGui::GetContentRegionAvail().x;
+        float msToPx = width / std::max(frameMs, 0.001f);
+        ImDrawList *draw = ImGui::GetWindowDrawList();
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        drawBar(draw, origin, ImVec2(origin.x + width, origin.y + rowHeight - 1.0f), "Frame", frameMs);
+        float x = origin.x;
+        int levels = 1;
+        for (unsigned int i = 0; i < flame.size(); i++) {
+            int level = 1;
+            for (int p = flame[i].parent; p >= 0; p = flame[p].parent) level++;
+            levels = std::max(levels, level + 1);
+            if (flame[i].parent != -1) continue;
+            drawFlameNode(draw, (int)i, x, origin.y + rowHeight, msToPx, rowHeight);
+            x += flame[i].ms * msToPx;
+        }
+        ImGui::Dummy(ImVec2(width, levels * rowHeight));
+    }
+};
+#endif
@@ -0,0 +1,111 @@
+#ifndef QUALITYGOVERNOR_H
+#define QUALITYGOVERNOR_H
+
+#include "Log.h"
+
+#include <algorithm>
+#include <vector>
+
+// Trades quality settings for frame time. Knobs are registered in priority order, each with a
+// number of steps it can be lowered by; the governor only ever lowers them from what the user
+// set (Drop() is how many steps a knob is currently down), and the owner applies the result.
+// The control law, on smoothed GPU time:
+//  - Down: the average has been over budget for SUSTAIN frames in a row. The first knob in
+//    priority order that still has a step left goes down one.
+//  - Up: the average has been below RAISE_BELOW of the budget for 'hold' frames in a row. The
+//    last knob that went down comes back up one step, so settings return in reverse order.
+//  - After any step, and after being enabled, nothing moves for SETTLE frames while the new cost
+//    reaches the average.
+//  - If a raise is undone by the next step, 'hold' doubles (up to MAX_HOLD): a load that sits
+//    right at the edge of a step stays at the lower setting and retries ever more rarely instead
+//    of flipping back and forth. Two raises in a row halve it again.
+// Every step is logged with the measurement that caused it.
+class QualityGovernor {
+public:
+    static constexpr int SUSTAIN = 10;
+    static constexpr int SETTLE = 30;
+    static constexpr int MIN_HOLD = 60, MAX_HOLD = 960;
+    static constexpr float RAISE_BELOW = 0.75f;
+    static constexpr float MAX_OVER = 4.0f; // a sample counts as at most this many budgets
+
+    bool enabled = false;
+    float budgetMs = 16.0f;
+
+    // Adds a knob after the ones registered so far (lower priority) and returns its index
+    int Register(const char *name, int steps) {
+        knobs.push_back(Knob{ name, std::max(steps, 0), 0 });
+        int total = 0;
+        for (const Knob &k : knobs) total += k.steps;
+        lowered.reserve(total); // stepping never allocates
+        return (int)knobs.size() - 1;
+    }
+
+    int Knobs() const { return (int)knobs.size(); }
+    const char* Name(int knob) const { return knobs[knob].name; }
+    int Steps(int knob) const { return knobs[knob].steps; }
+    int Drop(int knob) const { return knobs[knob].drop; }
+    float SmoothedGpuMs() const { return smoothed; }
+
+    // Feeds the GPU time of a finished frame (0 = no result). 'canLower' / 'canRaise' let another
+    // controller go first, e.g. dynamic resolution at its lowest / highest scale.
+    void Update(float gpuMs, bool canLower = true, bool canRaise = true) {
+        if (!enabled) { reset(); return; }
+        if (gpuMs <= 0.0f) return;
+        gpuMs = std::min(gpuMs, budgetMs * MAX_OVER);
+        smoothed = smoothed > 0.0f ? smoothed + (gpuMs - smoothed) * 0.1f : gpuMs;
+        if (settle > 0) { settle--; return; }
+
+        overFrames = smoothed > budgetMs ? overFrames + 1 : 0;
+        underFrames = smoothed < budgetMs * RAISE_BELOW ? underFrames + 1 : 0;
+        if (overFrames >= SUSTAIN && canLower) {
+            for (int i = 0; i < (int)knobs.size(); i++) {
+                if (knobs[i].drop >= knobs[i].steps) continue;
+                step(i, +1);
+                return;
+            }
+        } else if (underFrames >= hold && canRaise && !lowered.empty()) {
+            step(lowered.back(), -1);
+        }
+    }
+
+private:
+    struct Knob {
+        const char *name;
+        int steps;
+        int drop;
+    };
+
+    std::vector<Knob> knobs;
+    std::vector<int> lowered; // knob of every step down still in effect, oldest first
+    float smoothed = 0.0f;
+    int settle = SETTLE, overFrames = 0, underFrames = 0;
+    int hold = MIN_HOLD;
+    int lastStep = 0; // +1 down, -1 up, 0 none yet
+
+    void step(int knob, int direction) {
+        Knob &k = knobs[knob];
+        k.drop += direction;
+        if (direction > 0) lowered.push_back(knob);
+        else lowered.pop_back();
+        if (direction > 0 && lastStep < 0) hold = std::min(hold * 2, MAX_HOLD);
+        if (direction < 0 && lastStep < 0) hold = std::max(hold / 2, MIN_HOLD);
+        LOG_INFO("Quality %s: %s %d/%d steps down (GPU %.2f ms against a %.2f ms budget for %d frames%s)",
+            direction > 0 ? "lowered" : "raised", k.name, k.drop, k.steps, smoothed, budgetMs,
+            direction > 0 ? overFrames : underFrames, direction > 0 && lastStep < 0 ? ", raise undone: waiting longer" : "");
+        lastStep = direction;
+        settle = SETTLE;
+        overFrames = underFrames = 0;
+    }
+
+    void reset() {
+        if (!lowered.empty()) LOG_INFO("Quality governor off: %d step(s) restored", (int)lowered.size());
+        for (Knob &k : knobs) k.drop = 0;
+        lowered.clear();
+        smoothed = 0.0f;
+        settle = SETTLE;
+        overFrames = underFrames = 0;
+        hold = MIN_HOLD;
+        lastStep = 0;
+    }
+};
+#endif
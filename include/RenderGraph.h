@@ -0,0 +1,379 @@
+#ifndef RENDERGRAPH_H
+#define RENDERGRAPH_H
+
+#include <glad/glad.h>
+
+#include "Profiler.h"
+#include "GLStats.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+// Frame described as passes and the textures they read and write.
+//  - Declare resources and passes (in execution order), then Compile(). Compiling culls passes
+//    nothing needs, computes resource lifetimes, assigns GL textures from a pool and builds one
+//    framebuffer per pass. Execute() then only binds and calls the pass functions, so a compiled
+//    graph can run every frame until its inputs (size, settings) change.
+//  - Attachments of a pass are written; an attachment a pass did not write first also keeps
+//    (loads) what the previous writer left there. Read() is for sampled textures. Color(RG_NONE)
+//    leaves a slot empty, so the shader outputs after it keep their locations.
+//  - A pass is kept if it writes an imported resource or framebuffer, or something a kept pass
+//    reads or loads. Everything else is culled.
+//  - Transient textures whose lifetimes do not overlap share a GL texture when their
+//    descriptions match (GL has no placement of different formats into one allocation, so
+//    aliasing happens at the texture level). Pool textures the next Compile() does not need are
+//    deleted, which is how a resize releases the old targets.
+// Pass functions should capture little (typically 'this') so std::function does not allocate.
+typedef int RGResource;
+const RGResource RG_NONE = -1;
+
+struct RGTextureDesc {
+    int width = 0, height = 0;
+    GLenum format = GL_RGBA8;       // internal format
+    GLenum filter = GL_LINEAR;      // with a mipmap filter the writing pass generates the levels
+    GLenum wrap = GL_CLAMP_TO_EDGE; // GL_CLAMP_TO_BORDER uses a white border (depth maps)
+    GLenum compare = GL_NONE;       // GL_COMPARE_REF_TO_TEXTURE: depth compared by the sampler (LEQUAL)
+
+    bool operator==(const RGTextureDesc &o) const {
+        return width == o.width && height == o.height && format == o.format && filter == o.filter && wrap == o.wrap && compare == o.compare;
+    }
+};
+
+class RenderGraph {
+public:
+    static const int MAX_COLOR_ATTACHMENTS = 4;
+
+    struct Resource {
+        const char *name;
+        RGTextureDesc desc;
+        bool imported = false;
+        GLuint framebuffer = 0;  // imported render target (window, benchmark output): no texture
+        bool isFramebuffer = false;
+        // Compiled
+        int firstPass = -1, lastPass = -1;
+        GLuint texture = 0;
+        int physical = -1;       // pool slot, equal for aliased resources
+    };
+    struct Pass {
+        const char *name;
+        std::function<void()> execute;
+        std::vector<RGResource> reads;
+        RGResource colors[MAX_COLOR_ATTACHMENTS] = { RG_NONE, RG_NONE, RG_NONE, RG_NONE };
+        int colorCount = 0;
+        RGResource depth = RG_NONE;
+        RGResource target = RG_NONE; // imported framebuffer instead of attachments
+        // Compiled
+        bool culled = false;
+        GLuint framebuffer = 0;
+        int width = 0, height = 0;
+    };
+
+    // Returned by AddPass() to declare the pass's inputs and outputs
+    class PassBuilder {
+    public:
+        PassBuilder(RenderGraph &graph, int pass) : graph(graph), pass(pass) {}
+        PassBuilder& Read(RGResource r) { graph.passes[pass].reads.push_back(r); return *this; }
+        PassBuilder& Color(RGResource r) { Pass &p = graph.passes[pass]; if (p.colorCount < MAX_COLOR_ATTACHMENTS) p.colors[p.colorCount++] = r; return *this; }
+        PassBuilder& Depth(RGResource r) { graph.passes[pass].depth = r; return *this; }
+        PassBuilder& Target(RGResource r) { graph.passes[pass].target = r; return *this; }
+    private:
+        RenderGraph &graph;
+        int pass;
+    };
+
+    // Forget the declarations; the texture pool and framebuffers stay for the next Compile()
+    void Reset() {
+        passes.clear();
+        resources.clear();
+        compiled = false;
+    }
+
+    RGResource Create(const char *name, const RGTextureDesc &desc) {
+        Resource r;
+        r.name = name; r.desc = desc;
+        resources.push_back(r);
+        return (RGResource)resources.size() - 1;
+    }
+    // A texture owned elsewhere; it outlives the frame, so its writers are never culled
+    RGResource Import(const char *name, GLuint texture, const RGTextureDesc &desc) {
+        RGResource r = Create(name, desc);
+        resources[r].imported = true;
+        resources[r].texture = texture;
+        return r;
+    }
+    RGResource ImportFramebuffer(const char *name, GLuint framebuffer, int width, int height) {
+        RGTextureDesc desc;
+        desc.width = width; desc.height = height;
+        RGResource r = Import(name, 0, desc);
+        resources[r].framebuffer = framebuffer;
+        resources[r].isFramebuffer = true;
+        return r;
+    }
+
+    PassBuilder AddPass(const char *name, std::function<void()> execute) {
+        Pass p;
+        p.name = name;
+        p.execute = std::move(execute);
+        passes.push_back(std::move(p));
+        return PassBuilder(*this, (int)passes.size() - 1);
+    }
+
+    void Compile() {
+        uint64_t start = Profiler::Now();
+        cull();
+        for (Resource &r : resources) { r.firstPass = r.lastPass = -1; if (!r.imported) { r.texture = 0; r.physical = -1; } }
+        for (int i = 0; i < (int)passes.size(); i++) {
+            if (passes[i].culled) continue;
+            forEachUse(passes[i], [&](RGResource r) {
+                Resource &res = resources[r];
+                if (res.firstPass < 0) res.firstPass = i;
+                res.lastPass = i;
+            });
+        }
+        allocate();
+        buildFramebuffers();
+        compiled = true;
+        compileCount++;
+        lastCompileMs = (Profiler::Now() - start) / 1e6;
+    }
+
+    // Runs the kept passes; returns the number of framebuffer binds. Consecutive passes on the
+    // same attachments stay on one binding.
+    unsigned int Execute() {
+        unsigned int binds = 0;
+        if (!compiled) return binds;
+        int bound = -1;
+        for (Pass &p : passes) {
+            if (p.culled) continue;
+            PROFILE_GPU_SCOPE(p.name);
+            GL_STATS_PASS(p.name);
+            if ((int)p.framebuffer != bound) {
+                glBindFramebuffer(GL_FRAMEBUFFER, p.framebuffer);
+                bound = (int)p.framebuffer;
+                binds++;
+            }
+            glViewport(0, 0, p.width, p.height);
+            p.execute();
+        }
+        return binds;
+    }
+
+    GLuint Texture(RGResource r) const { return r >= 0 && r < (int)resources.size() ? resources[r].texture : 0; }
+
+    // Deletes every pooled texture and framebuffer (needs the GL context)
+    void Release() {
+        for (PoolTexture &t : pool) glDeleteTextures(1, &t.texture);
+        pool.clear();
+        for (std::map<FramebufferKey, GLuint>::iterator it = framebuffers.begin(); it != framebuffers.end(); ++it) glDeleteFramebuffers(1, &it->second);
+        framebuffers.clear();
+        compiled = false;
+    }
+
+    // --- Introspection (RenderGraphWindow) ---
+    const std::vector<Pass>& Passes() const { return passes; }
+    const std::vector<Resource>& Resources() const { return resources; }
+    bool Compiled() const { return compiled; }
+    int CompileCount() const { return compileCount; }
+    double LastCompileMs() const { return lastCompileMs; }
+    size_t PoolTextures() const { return pool.size(); }
+    // Bytes of the transient textures as allocated, and as they would be without aliasing
+    size_t TransientBytes(bool aliased) const {
+        size_t total = 0;
+        if (aliased) { for (const PoolTexture &t : pool) total += Bytes(t.desc); return total; }
+        for (const Resource &r : resources) if (!r.imported && r.firstPass >= 0) total += Bytes(r.desc);
+        return total;
+    }
+    // Does pass 'pass' read (1), write (2) or both (3) resource 'r'
+    int Access(int pass, RGResource r) const {
+        const Pass &p = passes[pass];
+        int access = 0;
+        for (RGResource read : p.reads) if (read == r) access |= 1;
+        if (p.depth == r || p.target == r) access |= 2;
+        for (int i = 0; i < p.colorCount; i++) if (p.colors[i] == r) access |= 2;
+        if ((access & 2) && loads(pass, r)) access |= 1;
+        return access;
+    }
+
+    static size_t Bytes(const RGTextureDesc &d) {
+        size_t pixel = 4;
+        switch (d.format) {
+        case GL_R8: pixel = 1; break;
+        case GL_RG8: case GL_DEPTH_COMPONENT16: case GL_R16F: pixel = 2; break;
+        case GL_RGB8: case GL_SRGB8: case GL_DEPTH_COMPONENT24: pixel = 3; break;
+        case GL_RGBA16F: pixel = 8; break;
+        case GL_RGB16F: pixel = 6; break;
+        case GL_RGBA32F: pixel = 16; break;
+        default: break;
+        }
+        return (size_t)d.width * d.height * pixel;
+    }
+
+private:
+    struct PoolTexture {
+        GLuint texture = 0;
+        RGTextureDesc desc;
+        int busyUntil = -1; // last pass of the resource currently using it, during allocate()
+        bool used = false;
+    };
+    typedef std::vector<GLuint> FramebufferKey; // color attachments..., depth
+
+    std::vector<Pass> passes;
+    std::vector<Resource> resources;
+    std::vector<PoolTexture> pool;
+    std::map<FramebufferKey, GLuint> framebuffers;
+    bool compiled = false;
+    int compileCount = 0;
+    double lastCompileMs = 0.0;
+
+    template <typename F> void forEachUse(const Pass &p, F f) const {
+        for (RGResource r : p.reads) f(r);
+        for (int i = 0; i < p.colorCount; i++) if (p.colors[i] != RG_NONE) f(p.colors[i]);
+        if (p.depth != RG_NONE) f(p.depth);
+        if (p.target != RG_NONE) f(p.target);
+    }
+
+    bool writes(const Pass &p, RGResource r) const {
+        if (p.depth == r || p.target == r) return true;
+        for (int i = 0; i < p.colorCount; i++) if (p.colors[i] == r) return true;
+        return false;
+    }
+
+    // An attachment loads if an earlier pass wrote it
+    bool loads(int pass, RGResource r) const {
+        for (int i = 0; i < pass; i++) if (writes(passes[i], r)) return true;
+        return false;
+    }
+
+    // Backwards from the passes with visible results, marking the producers of what they consume
+    void cull() {
+        std::vector<bool> needed(resources.size(), false);
+        for (int i = (int)passes.size() - 1; i >= 0; i--) {
+            Pass &p = passes[i];
+            bool keep = false;
+            forEachUse(p, [&](RGResource r) { if (writes(p, r) && (resources[r].imported || needed[r])) keep = true; });
+            p.culled = !keep;
+            if (!keep) continue;
+            for (RGResource r : p.reads) needed[r] = true;
+            forEachUse(p, [&](RGResource r) { if (writes(p, r) && loads(i, r)) needed[r] = true; });
+            // What this pass writes is produced here; earlier writers are only needed if it loads
+            forEachUse(p, [&](RGResource r) { if (writes(p, r) && !loads(i, r) && !resources[r].imported) needed[r] = false; });
+        }
+    }
+
+    // Greedy interval assignment: resources in order of first use take a free pool texture with
+    // the same description, or a new one
+    void allocate() {
+        for (PoolTexture &t : pool) { t.busyUntil = -1; t.used = false; }
+        std::vector<int> order;
+        for (int i = 0; i < (int)resources.size(); i++)
+            if (!resources[i].imported && resources[i].firstPass >= 0) order.push_back(i);
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return resources[a].firstPass < resources[b].firstPass; });
+        for (int i : order) {
+            Resource &r = resources[i];
+            int slot = -1;
+            for (int s = 0; s < (int)pool.size() && slot < 0; s++)
+                if (pool[s].desc == r.desc && pool[s].busyUntil < r.firstPass) slot = s;
+            if (slot < 0) {
+                PoolTexture t;
+                t.desc = r.desc;
+                t.texture = createTexture(r.desc);
+                pool.push_back(t);
+                slot = (int)pool.size() - 1;
+            }
+            pool[slot].busyUntil = r.lastPass;
+            pool[slot].used = true;
+            r.physical = slot;
+            r.texture = pool[slot].texture;
+        }
+        // Drop what this graph does not use (old sizes after a resize, removed passes)
+        for (size_t s = 0; s < pool.size();) {
+            if (pool[s].used) { s++; continue; }
+            glDeleteTextures(1, &pool[s].texture);
+            for (Resource &r : resources) if (r.physical > (int)s) r.physical--;
+            pool.erase(pool.begin() + s);
+        }
+    }
+
+    static GLuint createTexture(const RGTextureDesc &d) {
+        GLenum format = GL_RGBA, type = GL_UNSIGNED_BYTE;
+        switch (d.format) {
+        case GL_DEPTH_COMPONENT: case GL_DEPTH_COMPONENT16: case GL_DEPTH_COMPONENT24: case GL_DEPTH_COMPONENT32F: format = GL_DEPTH_COMPONENT; type = GL_FLOAT; break;
+        case GL_DEPTH24_STENCIL8: format = GL_DEPTH_STENCIL; type = GL_UNSIGNED_INT_24_8; break;
+        case GL_R32UI: format = GL_RED_INTEGER; type = GL_UNSIGNED_INT; break;
+        case GL_R8: case GL_R16F: format = GL_RED; break;
+        case GL_RG8: case GL_RG16F: format = GL_RG; break;
+        case GL_RGB: case GL_RGB8: case GL_SRGB8: case GL_RGB16F: format = GL_RGB; break;
+        default: break;
+        }
+        if (d.format == GL_RGB16F || d.format == GL_RGBA16F || d.format == GL_RGBA32F || d.format == GL_R16F || d.format == GL_RG16F) type = GL_FLOAT;
+        GLuint texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, d.format, d.width, d.height, 0, format, type, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, d.filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, d.filter == GL_NEAREST ? GL_NEAREST : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, d.wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, d.wrap);
+        if (d.wrap == GL_CLAMP_TO_BORDER) {
+            float white[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+            glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, white);
+        }
+        if (d.compare != GL_NONE) {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, d.compare);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return texture;
+    }
+
+    // One framebuffer per distinct attachment set, shared by passes that render to the same
+    // targets. Rebuilt on every Compile(): texture names freed by a resize can come back for new
+    // textures, so an old framebuffer must never be matched by name.
+    void buildFramebuffers() {
+        for (std::map<FramebufferKey, GLuint>::iterator it = framebuffers.begin(); it != framebuffers.end(); ++it) glDeleteFramebuffers(1, &it->second);
+        framebuffers.clear();
+        for (Pass &p : passes) {
+            if (p.culled) continue;
+            if (p.target != RG_NONE) {
+                const Resource &t = resources[p.target];
+                p.framebuffer = t.framebuffer; p.width = t.desc.width; p.height = t.desc.height;
+                continue;
+            }
+            FramebufferKey key;
+            for (int i = 0; i < p.colorCount; i++) key.push_back(p.colors[i] != RG_NONE ? resources[p.colors[i]].texture : 0);
+            key.push_back(p.depth != RG_NONE ? resources[p.depth].texture : 0);
+            const Resource &first = resources[p.colorCount && p.colors[0] != RG_NONE ? p.colors[0] : p.depth];
+            p.width = first.desc.width; p.height = first.desc.height;
+            std::map<FramebufferKey, GLuint>::iterator it = framebuffers.find(key);
+            p.framebuffer = it != framebuffers.end() ? it->second : (framebuffers[key] = createFramebuffer(p));
+        }
+    }
+
+    GLuint createFramebuffer(const Pass &p) {
+        GLuint fbo;
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        GLenum drawBuffers[MAX_COLOR_ATTACHMENTS];
+        for (int i = 0; i < p.colorCount; i++) {
+            drawBuffers[i] = GL_NONE;
+            if (p.colors[i] == RG_NONE) continue;
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, resources[p.colors[i]].texture, 0);
+            drawBuffers[i] = GL_COLOR_ATTACHMENT0 + i;
+        }
+        if (p.depth != RG_NONE) {
+            const Resource &d = resources[p.depth];
+            GLenum attachment = d.desc.format == GL_DEPTH24_STENCIL8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+            glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, d.texture, 0);
+        }
+        if (p.colorCount) glDrawBuffers(p.colorCount, drawBuffers);
+        else { glDrawBuffer(GL_NONE); glReadBuffer(GL_NONE); }
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) LOG_ERROR("Render graph: framebuffer of pass %s is incomplete", p.name);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return fbo;
+    }
+};
+#endif
@@ -0,0 +1,109 @@
+#ifndef RENDERGRAPHUI_H
+#define RENDERGRAPHUI_H
+
+#include "RenderGraph.h"
+#include "imgui.h"
+
+#include <cstdio>
+#include <vector>
+
+// ImGui "Render Graph" window: the compiled passes (culled ones greyed out), which resource each
+// pass reads (R) and writes (W) with the lifetimes shaded, and the GL textures behind the
+// transient resources with their memory, with and without aliasing.
+class RenderGraphWindow {
+public:
+    bool visible = false;
+
+    void Draw(const RenderGraph &graph) {
+        if (!visible) return;
+        if (!ImGui::Begin("Render Graph", &visible)) { ImGui::End(); return; }
+        if (!graph.Compiled()) { ImGui::TextDisabled("No graph compiled yet."); ImGui::End(); return; }
+
+        const std::vector<RenderGraph::Pass> &passes = graph.Passes();
+        const std::vector<RenderGraph::Resource> &resources = graph.Resources();
+        int culled = 0;
+        for (const RenderGraph::Pass &p : passes) culled += p.culled ? 1 : 0;
+        ImGui::Text("%d passes (%d culled), %d resources, compiled %d time(s), last %.3f ms", (int)passes.size(), culled, (int)resources.size(),
+            graph.CompileCount(), graph.LastCompileMs());
+        ImGui::Text("Transient memory: %.2f MB in %zu textures (%.2f MB without aliasing)", graph.TransientBytes(true) / (1024.0 * 1024.0),
+            graph.PoolTextures(), graph.TransientBytes(false) / (1024.0 * 1024.0));
+        ImGui::Separator();
+        drawUsage(graph);
+        ImGui::Separator();
+        drawResources(graph);
+        ImGui::End();
+    }
+
+private:
+    static void drawUsage(const RenderGraph &graph) {
+        const std::vector<RenderGraph::Pass> &passes = graph.Passes();
+        const std::vector<RenderGraph::Resource> &resources = graph.Resources();
+        if (!ImGui::BeginTable("Usage", (int)passes.size() + 1, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit)) return;
+        ImGui::TableSetupColumn("Resource");
+        for (const RenderGraph::Pass &p : passes) ImGui::TableSetupColumn(p.name);
+        ImGui::TableNextRow(ImGuiTableRowFlags_Headers);
+        ImGui::TableSetColumnIndex(0);
+        ImGui::TableHeader("Resource");
+        for (int i = 0; i < (int)passes.size(); i++) {
+            ImGui::TableSetColumnIndex(i + 1);
+            if (passes[i].culled) ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled));
+            ImGui::TableHeader(passes[i].name);
+            if (passes[i].culled) ImGui::PopStyleColor();
+        }
+        for (int r = 0; r < (int)resources.size(); r++) {
+            const RenderGraph::Resource &res = resources[r];
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::Text("%s%s", res.name, res.imported ? " (imported)" : "");
+            for (int i = 0; i < (int)passes.size(); i++) {
+                ImGui::TableSetColumnIndex(i + 1);
+                if (res.firstPass >= 0 && i >= res.firstPass && i <= res.lastPass)
+                    ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, IM_COL32(60, 90, 140, 120));
+                int access = graph.Access(i, r);
+                const char *label = access == 3 ? "RW" : access == 2 ? "W" : access == 1 ? "R" : "";
+                if (passes[i].culled) ImGui::TextDisabled("%s", label);
+                else ImGui::TextUnformatted(label);
+            }
+        }
+        ImGui::EndTable();
+    }
+
+    static void drawResources(const RenderGraph &graph) {
+        if (!ImGui::BeginTable("Resources", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) return;
+        ImGui::TableSetupColumn("Resource");
+        ImGui::TableSetupColumn("Texture");
+        ImGui::TableSetupColumn("Size");
+        ImGui::TableSetupColumn("Format");
+        ImGui::TableSetupColumn("Memory");
+        ImGui::TableHeadersRow();
+        for (const RenderGraph::Resource &res : graph.Resources()) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(res.name);
+            ImGui::TableNextColumn();
+            if (res.isFramebuffer) ImGui::Text("framebuffer %u", res.framebuffer);
+            else if (res.imported) ImGui::Text("%u (imported)", res.texture);
+            else if (res.physical < 0) ImGui::TextDisabled("unused");
+            else ImGui::Text("%u (slot %d)", res.texture, res.physical);
+            ImGui::TableNextColumn(); ImGui::Text("%dx%d", res.desc.width, res.desc.height);
+            ImGui::TableNextColumn(); ImGui::Text("%s", res.isFramebuffer ? "-" : formatName(res.desc.format));
+            ImGui::TableNextColumn(); ImGui::Text("%.2f MB", res.isFramebuffer ? 0.0 : RenderGraph::Bytes(res.desc) / (1024.0 * 1024.0));
+        }
+        ImGui::EndTable();
+    }
+
+    static const char* formatName(GLenum format) {
+        switch (format) {
+        case GL_RGBA8: return "RGBA8";
+        case GL_RGB8: return "RGB8";
+        case GL_RGBA16F: return "RGBA16F";
+        case GL_RGB16F: return "RGB16F";
+        case GL_R8: return "R8";
+        case GL_R32UI: return "R32UI";
+        case GL_DEPTH_COMPONENT16: return "DEPTH16";
+        case GL_DEPTH_COMPONENT24: return "DEPTH24";
+        case GL_DEPTH24_STENCIL8: return "DEPTH24_STENCIL8";
+        default: return "?";
+        }
+    }
+};
+#endif
@@ -0,0 +1,960 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "stb_image.h"
+
+#include "Shader.h"
+#include "ShaderVariants.h"
+#include "Model.h"
+#include "GameObject.h"
+#include "SceneFile.h"
+#include "WorldPartition.h"
+#include "GpuPicker.h"
+#include "RenderGraph.h"
+#include "ShadowAtlas.h"
+#include "PostChain.h"
+#include "ColorLut.h"
+#include "DynamicResolution.h"
+#include "QualityGovernor.h"
+#include "Profiler.h"
+#include "GLStats.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Per-frame work counters, reset by DrawFrame()
+struct RenderCounters {
+    unsigned int drawCalls = 0;
+    unsigned int triangles = 0;
+    unsigned int objects = 0;      // object draws, summed over passes
+    unsigned int programBinds = 0;
+    unsigned int textureBinds = 0;
+    unsigned int framebufferBinds = 0;
+    unsigned int shadowFaces = 0;  // point-light shadow faces redrawn into the atlas
+};
+
+// Everything DrawFrame() needs to know about the world, owned by the caller
+struct RenderScene {
+    std::vector<GameObject> *objects = nullptr;
+    WorldPartition *world = nullptr; // optional streamed cells
+    glm::vec3 sunDirection = glm::vec3(-0.5f, -1.0f, -0.5f);
+    glm::vec3 sunColor = glm::vec3(0.9f);
+    const SceneLight *pointLights = nullptr;
+    int pointLightCount = 0;
+};
+
+// Most lights standard.frag is specialized for (its NR_POINT_LIGHTS); further lights only get a lamp
+const int MAX_SHADED_POINT_LIGHTS = 4;
+
+// Feature fields of the shader variants, in the order they are declared in Renderer::Init()
+enum StandardFeature { STANDARD_POINT_LIGHTS, STANDARD_SHADOWS, STANDARD_PCF_RADIUS, STANDARD_SHADOW_FILTER };
+enum KernelFeature { KERNEL_TYPE };
+// Settings the quality governor may lower, registered in this order (the first goes down first)
+enum QualityKnob { QUALITY_SHADOW_MAP, QUALITY_PCF, QUALITY_POINT_LIGHTS, QUALITY_LOD_BIAS, QUALITY_POST_SCALE, QUALITY_SKYBOX };
+
+// How the sun's shadow map is filtered (see shadow.glsl); a setting, so a change rebuilds the graph
+enum ShadowFilter { SHADOW_FILTER_PCF, SHADOW_FILTER_HARDWARE, SHADOW_FILTER_POISSON, SHADOW_FILTER_EVSM, SHADOW_FILTER_COUNT };
+
+inline const char* ShadowFilterName(int filter) {
+    static const char *names[] = { "PCF", "Hardware PCF", "Poisson", "EVSM" };
+    return filter >= 0 && filter < SHADOW_FILTER_COUNT ? names[filter] : "?";
+}
+
+// The editor's lights for scenes that don't define their own
+inline std::vector<SceneLight> DefaultPointLights() {
+    return {
+        { glm::vec3( 0.7f,  0.2f,  2.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+        { glm::vec3( 2.3f, -3.3f, -4.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+        { glm::vec3(-4.0f,  2.0f, -12.0f), glm::vec3(0.0f, 0.0f, 1.0f) },
+        { glm::vec3( 0.0f,  0.0f, -3.0f), glm::vec3(1.0f, 1.0f, 0.0f) }
+    };
+}
+
+// The engine's frame: shadow map, lit scene with lamps and skybox into an offscreen target,
+// then the post-process chain, declared as a RenderGraph. Shared by the editor and the headless
+// benchmark. The graph is rebuilt only when the output size or a setting that changes its shape
+// does; offscreen targets follow the output size. With dynamic resolution the scene passes draw
+// into the lower left SceneWidth() x SceneHeight() of them and an edge-adaptive upscale followed
+// by contrast-adaptive sharpening brings it back to full size before the post chain. With TAA
+// the projection is jittered every frame, the scene passes also write a velocity buffer, and a
+// resolve against the full size history replaces the edge-adaptive upscale. The shaded point
+// lights cast shadows from a ShadowAtlas of cube faces that is only redrawn where something
+// changed, a few faces per frame.
+// Init() must run with a current GL context; assets are loaded relative to the working directory.
+class Renderer {
+public:
+    unsigned int shadowWidth = 1024, shadowHeight = 1024; // Shadow Map Resolution (the governor may halve it)
+    PostChain post;
+    DynamicResolution resolution;
+    QualityGovernor quality;    // lowers the settings here (and the post effects' resolution) under load
+    int pcfRadius = 1;          // shadow filter of (2 * pcfRadius + 1)^2 texels, 0..2
+    ShadowFilter shadowFilter = SHADOW_FILTER_PCF;
+    bool shadowDepth16 = false; // 16-bit shadow depth (and half float EVSM moments): half the bandwidth
+    bool taa = false;           // temporal anti-aliasing (and upsampling, with dynamic resolution)
+    bool writeObjectIDs = true; // fill the picking attachment in the lighting pass
+    bool shadows = true;        // off: lighting skips the shadow lookup and the shadow pass is culled
+    bool pointShadows = true;   // the shaded point lights cast shadows too (with 'shadows')
+    float pointShadowRange = 15.0f; // point-light shadows reach this far from the light
+    ShadowAtlas pointShadowAtlas;   // its maxUpdates bounds the faces redrawn per frame
+    GpuPicker picker;
+    RenderCounters counters;
+
+    ~Renderer() {
+        delete standardVariants; delete lampShader; delete skyboxShader; delete screenShader; delete shadowDepthShader;
+        delete kernelVariants; delete blurShader; delete upsampleShader; delete upscaleShader; delete rcasShader;
+        delete fxaaShader; delete taaShader; delete evsmShader; delete pointShadowShader;
+        delete lampModel;
+    }
+
+    bool Init(int width, int height) {
+        // --- SHADERS ---
+        // Lit and post-process shaders are specialized per light count, shadow receiving and effect.
+        // Every program is issued here and only waited for on first use, so the driver compiles
+        // (or loads cached binaries) while the models and the cubemap load.
+        uint64_t shaderStart = Profiler::Now();
+        unsigned int cacheHits = ShaderCache::Get().Hits();
+        standardVariants = new ShaderVariants("simple_lighting.vert", "standard.frag", { { "NR_POINT_LIGHTS", 3 }, { "SHADOWS", 1 }, { "PCF_RADIUS", 2 }, { "SHADOW_FILTER", 2 } });
+        standardVariants->BindSampler("texture_diffuse1", 0);
+        standardVariants->BindSampler("shadowMap", 1); // Shadow map will be bound to unit 1
+        standardVariants->BindSampler("pointShadowAtlas", 2);
+        lampShader = new Shader("simple_lighting.vert", "lamp.frag");
+        skyboxShader = new Shader("skybox.vert", "skybox.frag");
+        screenShader = new Shader("screen.vert", "screen.frag");
+        kernelVariants = new ShaderVariants("screen.vert", "kernel.frag", { { "KERNEL", 1 } });
+        kernelVariants->BindSampler("screenTexture", 0);
+        blurShader = new Shader("screen.vert", "blur.frag");
+        upsampleShader = new Shader("screen.vert", "upsample.frag");
+        upscaleShader = new Shader("screen.vert", "upscale.frag");
+        rcasShader = new Shader("screen.vert", "rcas.frag");
+        fxaaShader = new Shader("screen.vert", "fxaa.frag");
+        taaShader = new Shader("screen.vert", "taa.frag");
+        evsmShader = new Shader("screen.vert", "shadow_evsm.frag");
+        shadowDepthShader = new Shader("shadow_depth.vert", "shadow_depth.frag");
+        pointShadowShader = new Shader("point_shadow.vert", "point_shadow.frag");
+        prepareLitVariants(shadowFilter);
+        for (uint32_t kernel = 0; kernel <= 1; kernel++) kernelVariants->Prepare(kernelVariants->Field(KERNEL_TYPE, kernel));
+        unsigned int programs = 12 + (unsigned int)(standardVariants->Compiled() + kernelVariants->Compiled());
+        LOG_INFO("Issued %u shader programs (%u from the binary cache) in %.1f ms", programs, ShaderCache::Get().Hits() - cacheHits,
+            (Profiler::Now() - shaderStart) / 1e6);
+        lampModel = new Model("cube.obj");
+        quality.Register("Shadow map resolution", 2);
+        quality.Register("PCF kernel", 2);
+        quality.Register("Point lights", MAX_SHADED_POINT_LIGHTS - 1);
+        quality.Register("Texture LOD bias", 2);
+        quality.Register("Post effect resolution", 2);
+        quality.Register("Skybox sampling", 2);
+        picker.Init(width, height); // Object ID target, attached by the lighting pass
+        glGenFramebuffers(1, &presentFramebuffer);
+        glGenFramebuffers(1, &historyFramebuffer);
+        glGenTextures(1, &historyTexture);
+        glGenTextures(1, &atlasTexture);
+
+        // --- QUAD & SKYBOX SETUP ---
+        glGenVertexArrays(1, &quadVAO); glGenBuffers(1, &quadVBO);
+        glBindVertexArray(quadVAO); glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0); glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(1); glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+        glGenVertexArrays(1, &skyboxVAO); glGenBuffers(1, &skyboxVBO);
+        glBindVertexArray(skyboxVAO); glBindBuffer(GL_ARRAY_BUFFER, skyboxVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), &skyboxVertices, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0); glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        glBindVertexArray(0);
+
+        std::vector<std::string> faces = { "right.jpg", "left.jpg", "top.jpg", "bottom.jpg", "front.jpg", "back.jpg" };
+        cubemapTexture = loadCubemap(faces);
+        skyboxShader->use(); skyboxShader->setInt("skybox", 0);
+        screenShader->use(); screenShader->setInt("screenTexture", 0); screenShader->setInt("colorLut", 1); screenShader->setFloat("lutSize", (float)ColorLut::SIZE);
+        blurShader->use(); blurShader->setInt("screenTexture", 0);
+        upsampleShader->use(); upsampleShader->setInt("screenTexture", 0); upsampleShader->setInt("sceneDepth", 1);
+        upscaleShader->use(); upscaleShader->setInt("screenTexture", 0);
+        rcasShader->use(); rcasShader->setInt("screenTexture", 0);
+        fxaaShader->use(); fxaaShader->setInt("screenTexture", 0);
+        taaShader->use(); taaShader->setInt("screenTexture", 0); taaShader->setInt("velocityBuffer", 1); taaShader->setInt("sceneDepth", 2);
+        taaShader->setInt("history", 3);
+        evsmShader->use(); evsmShader->setInt("source", 0);
+
+        return true;
+    }
+
+    // Size of the offscreen targets (the output size of the last DrawFrame())
+    int Width() const { return key.width; }
+    int Height() const { return key.height; }
+    // Size the scene was drawn at: the output size times the dynamic resolution scale
+    int SceneWidth() const { return sceneWidth; }
+    int SceneHeight() const { return sceneHeight; }
+    const RenderGraph& Graph() const { return graph; }
+
+    // Renders the frame into 'target' (0 = window) of the given size
+    void DrawFrame(const RenderScene &scene, const glm::vec3 &viewPos, const glm::mat4 &view, const glm::mat4 &projection, unsigned int target, int width, int height) {
+        counters = RenderCounters();
+        if (width <= 0 || height <= 0) return; // minimized
+
+        // The timings are a couple of frames old; a new scale only moves the scene's viewport.
+        // Settings go down once the resolution is as low as it goes and back up once it is full.
+        float gpuMs = Profiler::Get().LastGpuFrameMs();
+        float scale = resolution.Update(gpuMs);
+        quality.Update(gpuMs, !resolution.enabled || scale <= resolution.minScale, !resolution.enabled || scale >= resolution.maxScale);
+        sceneWidth = std::max(1, (int)(width * scale + 0.5f));
+        sceneHeight = std::max(1, (int)(height * scale + 0.5f));
+        post.scaleBias = quality.Drop(QUALITY_POST_SCALE);
+        // A lower shadow resolution is drawn into a corner of the map, like the scene's
+        unsigned int shadowDrop = (unsigned int)quality.Drop(QUALITY_SHADOW_MAP);
+        shadowViewWidth = std::max(shadowWidth >> shadowDrop, 1u);
+        shadowViewHeight = std::max(shadowHeight >> shadowDrop, 1u);
+
+        GraphKey current = { width, height, target, shadows, writeObjectIDs, shadowWidth, shadowHeight, post.Shape(), resolution.enabled, taa,
+            shadowFilter, shadowDepth16, shadows && pointShadows };
+        if (!(current == key)) {
+            if (current.width != key.width || current.height != key.height) picker.Resize(width, height);
+            if (current.shadowFilter != key.shadowFilter) { prepareLitVariants(current.shadowFilter); shadersBuilding = true; }
+            if (current.pointShadows != key.pointShadows) atlasFormat = GL_NONE; // casters went untracked: start over
+            key = current;
+            buildGraph();
+        }
+
+        // Variants prepared by Init() are picked up as the driver finishes them
+        if (shadersBuilding) shadersBuilding = standardVariants->Collect() + kernelVariants->Collect() > 0;
+
+        frameScene = &scene;
+        frameViewPos = viewPos;
+        frameView = view;
+        frameProjection = projection;
+        // TAA: a different sub-pixel offset every frame (Halton 2, 3 over 8 frames), in scene pixels.
+        // Velocities compare the unjittered matrices; without history the last frame's are this one's.
+        frameJitter = glm::vec2(0.0f);
+        if (key.taa) {
+            taaFrame = taaFrame % 8 + 1;
+            frameJitter = glm::vec2(halton(taaFrame, 2), halton(taaFrame, 3)) - 0.5f;
+            frameProjection = glm::translate(glm::mat4(1.0f), glm::vec3(2.0f * frameJitter.x / sceneWidth, 2.0f * frameJitter.y / sceneHeight, 0.0f)) * projection;
+        }
+        frameViewProjection = projection * view;
+        frameSkyViewProjection = projection * glm::mat4(glm::mat3(view));
+        if (!historyValid) { previousViewProjection = frameViewProjection; previousSkyViewProjection = frameSkyViewProjection; }
+        // Calculate Light Space Matrix (Orthographic because Sun is directional)
+        float near_plane = 1.0f, far_plane = 20.0f;
+        glm::mat4 lightProjection = glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, near_plane, far_plane);
+        glm::mat4 lightView = glm::lookAt(scene.sunDirection * -10.0f, glm::vec3(0.0f), glm::vec3(0.0, 1.0, 0.0));
+        lightSpaceMatrix = lightProjection * lightView;
+        // The lookup maps the light's clip space onto the corner the shadow pass draws into
+        glm::vec3 corner((float)shadowViewWidth / shadowWidth, (float)shadowViewHeight / shadowHeight, 1.0f);
+        shadowLookupMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(corner.x - 1.0f, corner.y - 1.0f, 0.0f)) * glm::scale(glm::mat4(1.0f), corner) * lightSpaceMatrix;
+        // The governor sheds the lights at the end of the list first; they keep their lamps
+        frameLights = std::min(std::max(scene.pointLightCount, 0), MAX_SHADED_POINT_LIGHTS - quality.Drop(QUALITY_POINT_LIGHTS));
+        if (key.pointShadows) updatePointShadows(scene, viewPos);
+
+        counters.framebufferBinds += graph.Execute();
+        frameScene = nullptr;
+        previousViewProjection = frameViewProjection;
+        previousSkyViewProjection = frameSkyViewProjection;
+        historyValid = key.taa;
+    }
+
+private:
+    struct GraphKey {
+        int width, height;
+        unsigned int target;
+        bool shadows, objectIDs;
+        unsigned int shadowWidth, shadowHeight;
+        uint32_t postShape;
+        bool upscale, taa;
+        ShadowFilter shadowFilter;
+        bool shadowDepth16, pointShadows;
+        bool operator==(const GraphKey &o) const {
+            return width == o.width && height == o.height && target == o.target && shadows == o.shadows && objectIDs == o.objectIDs &&
+                shadowWidth == o.shadowWidth && shadowHeight == o.shadowHeight && postShape == o.postShape && upscale == o.upscale && taa == o.taa &&
+                shadowFilter == o.shadowFilter && shadowDepth16 == o.shadowDepth16 && pointShadows == o.pointShadows;
+        }
+    };
+
+    ShaderVariants *standardVariants = nullptr, *kernelVariants = nullptr;
+    Shader *lampShader = nullptr, *skyboxShader = nullptr, *screenShader = nullptr, *shadowDepthShader = nullptr, *blurShader = nullptr, *upsampleShader = nullptr;
+    Shader *upscaleShader = nullptr, *rcasShader = nullptr, *fxaaShader = nullptr, *taaShader = nullptr;
+    Shader *evsmShader = nullptr, *pointShadowShader = nullptr;
+    Model *lampModel = nullptr;
+    bool shadersBuilding = true;
+    unsigned int quadVAO = 0, quadVBO = 0, skyboxVAO = 0, skyboxVBO = 0;
+    unsigned int cubemapTexture = 0;
+    unsigned int presentFramebuffer = 0, presentSource = 0; // read side of the empty chain's blit
+    // TAA history: the last resolved frame at the output size, outside the graph since it outlives
+    // the frame. taaFramebuffer is the resolve pass's, bound again after copying into the history.
+    unsigned int historyTexture = 0, historyFramebuffer = 0, taaFramebuffer = 0;
+    int historyWidth = 0, historyHeight = 0, taaPassIndex = -1;
+    bool historyValid = false;
+    unsigned int taaFrame = 0;
+    std::vector<ColorLut> colorLuts; // one per color stage of the post chain, kept across rebuilds
+    // Point-light shadows: the atlas's depth texture (outside the graph, its tiles are kept across
+    // frames) and the faces scheduled for this frame
+    static constexpr int POINT_SHADOW_ATLAS_SIZE = 2048;
+    unsigned int atlasTexture = 0;
+    GLenum atlasFormat = GL_NONE;
+    unsigned int shadowCasters = 0;
+    int updateLights[ShadowAtlas::MAX_LIGHTS * ShadowAtlas::FACES], updateFaces[ShadowAtlas::MAX_LIGHTS * ShadowAtlas::FACES];
+
+    RenderGraph graph;
+    GraphKey key = { 0, 0, 0, false, false, 0, 0, 0, false, false, SHADOW_FILTER_PCF, false, false };
+    RGResource shadowMap = RG_NONE, shadowMoments = RG_NONE, shadowLookup = RG_NONE, sceneColor = RG_NONE, sceneDepth = RG_NONE, velocity = RG_NONE;
+    RGResource sharpenInput = RG_NONE, presentInput = RG_NONE, pointShadowMap = RG_NONE;
+    int sceneWidth = 0, sceneHeight = 0;
+
+    // The frame being drawn, for the pass functions
+    const RenderScene *frameScene = nullptr;
+    glm::vec3 frameViewPos;
+    glm::mat4 frameView, frameProjection, lightSpaceMatrix, shadowLookupMatrix;
+    glm::mat4 frameViewProjection, frameSkyViewProjection, previousViewProjection, previousSkyViewProjection; // unjittered
+    glm::vec2 frameJitter;
+    unsigned int shadowViewWidth = 0, shadowViewHeight = 0;
+    int frameLights = 0; // point lights shaded this frame
+
+    void buildGraph() {
+        graph.Reset();
+        RGTextureDesc shadowDesc;
+        shadowDesc.width = key.shadowWidth; shadowDesc.height = key.shadowHeight;
+        shadowDesc.format = key.shadowDepth16 ? GL_DEPTH_COMPONENT16 : GL_DEPTH_COMPONENT24;
+        shadowDesc.filter = GL_NEAREST;
+        shadowDesc.wrap = GL_CLAMP_TO_BORDER; // prevents shadows appearing outside the map range
+        if (key.shadowFilter == SHADOW_FILTER_HARDWARE || key.shadowFilter == SHADOW_FILTER_POISSON) {
+            shadowDesc.filter = GL_LINEAR; // with the comparison: bilinear PCF per tap
+            shadowDesc.compare = GL_COMPARE_REF_TO_TEXTURE;
+        }
+        // EVSM: the two warped moments, blurred and mipmapped for the lookup
+        RGTextureDesc momentsDesc = shadowDesc;
+        momentsDesc.format = key.shadowDepth16 ? GL_RGBA16F : GL_RGBA32F;
+        momentsDesc.wrap = GL_CLAMP_TO_EDGE;
+        RGTextureDesc filteredDesc = momentsDesc;
+        filteredDesc.filter = GL_LINEAR_MIPMAP_LINEAR;
+        RGTextureDesc colorDesc;
+        colorDesc.width = key.width; colorDesc.height = key.height;
+        colorDesc.format = GL_RGB8;
+        RGTextureDesc depthDesc = colorDesc;
+        depthDesc.format = GL_DEPTH24_STENCIL8;
+        depthDesc.filter = GL_NEAREST;
+        RGTextureDesc idDesc = depthDesc;
+        idDesc.format = GL_R32UI;
+        RGTextureDesc velocityDesc = depthDesc;
+        velocityDesc.format = GL_RG16F;
+
+        // With nothing to post-process and no ID attachment the scene can go straight to the window,
+        // which has its own depth buffer (offscreen outputs may not)
+        bool direct = post.Empty() && !writeObjectIDs && key.target == 0 && !key.upscale && !key.taa;
+        shadowMap = graph.Create("ShadowMap", shadowDesc);
+        sceneColor = direct ? RG_NONE : graph.Create("SceneColor", colorDesc);
+        sceneDepth = direct ? RG_NONE : graph.Create("SceneDepth", depthDesc);
+        velocity = key.taa ? graph.Create("Velocity", velocityDesc) : RG_NONE;
+        RGResource output = graph.ImportFramebuffer("Output", key.target, key.width, key.height);
+
+        graph.AddPass("Shadow", [this]() { shadowPass(); }).Depth(shadowMap);
+        shadowLookup = shadowMap;
+        if (key.shadowFilter == SHADOW_FILTER_EVSM) {
+            shadowMoments = graph.Create("ShadowMoments", momentsDesc);
+            shadowLookup = graph.Create("ShadowFiltered", filteredDesc);
+            graph.AddPass("EVSM H", [this]() { evsmPass(false); }).Read(shadowMap).Color(shadowMoments);
+            graph.AddPass("EVSM V", [this]() { evsmPass(true); }).Read(shadowMoments).Color(shadowLookup);
+        }
+        pointShadowMap = RG_NONE;
+        if (key.pointShadows) {
+            pointShadowMap = graph.Import("PointShadowAtlas", atlasTexture, allocateAtlas());
+            graph.AddPass("PointShadows", [this]() { pointShadowPass(); }).Depth(pointShadowMap);
+        }
+        // Lamps and skybox write ID 0 over what they cover, so they keep the ID attachment too
+        RGResource objectIDs = writeObjectIDs ? graph.Import("ObjectIDs", picker.idTexture, idDesc) : RG_NONE;
+        RenderGraph::PassBuilder lighting = graph.AddPass("Lighting", [this]() { lightingPass(); });
+        RenderGraph::PassBuilder lamps = graph.AddPass("Lamps", [this]() { lampsPass(); });
+        RenderGraph::PassBuilder skybox = graph.AddPass("Skybox", [this]() { skyboxPass(); });
+        if (shadows) lighting.Read(shadowLookup);
+        if (pointShadowMap != RG_NONE) lighting.Read(pointShadowMap);
+        RenderGraph::PassBuilder scenePasses[] = { lighting, lamps, skybox };
+        for (RenderGraph::PassBuilder &pass : scenePasses) {
+            if (direct) { pass.Target(output); continue; }
+            pass.Color(sceneColor);
+            if (objectIDs != RG_NONE || velocity != RG_NONE) pass.Color(objectIDs); // keeps velocity at location 2
+            if (velocity != RG_NONE) pass.Color(velocity);
+            pass.Depth(sceneDepth);
+        }
+        taaPassIndex = -1;
+        if (!direct) {
+            RGResource source = key.taa ? addTaaPass(colorDesc) : sceneColor;
+            if (key.upscale) source = addUpscalePasses(output, colorDesc, source);
+            addPostPasses(output, colorDesc, source);
+        }
+        graph.Compile();
+        presentSource = 0; // the scene color texture may be a new one with an old name
+        taaFramebuffer = taaPassIndex >= 0 ? graph.Passes()[taaPassIndex].framebuffer : 0;
+        historyValid = false;
+    }
+
+    // TAA: the jittered scene resolved against the history into a full size target, which is
+    // also copied into the history for the next frame
+    RGResource addTaaPass(const RGTextureDesc &colorDesc) {
+        RGTextureDesc desc = colorDesc;
+        desc.format = GL_RGBA16F; // 8 bits would lose the small steps of a 10% blend
+        if (historyWidth != key.width || historyHeight != key.height) {
+            glBindTexture(GL_TEXTURE_2D, historyTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, key.width, key.height, 0, GL_RGBA, GL_FLOAT, NULL);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            glBindFramebuffer(GL_FRAMEBUFFER, historyFramebuffer);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, historyTexture, 0);
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            historyWidth = key.width; historyHeight = key.height;
+        }
+        RGResource history = graph.Import("History", historyTexture, desc);
+        RGResource resolved = graph.Create("Resolved", desc);
+        taaPassIndex = (int)graph.Passes().size();
+        graph.AddPass("TAA", [this]() { taaPass(); }).Read(sceneColor).Read(velocity).Read(sceneDepth).Read(history).Color(resolved);
+        return resolved;
+    }
+
+    // Dynamic resolution: the scene's corner is upscaled to full size (unless TAA already did),
+    // then sharpened into the post chain's source (or the output when the chain is empty, which
+    // is then returned as RG_NONE)
+    RGResource addUpscalePasses(RGResource output, const RGTextureDesc &colorDesc, RGResource source) {
+        if (!key.taa) {
+            RGResource upscaled = graph.Create("Upscaled", colorDesc);
+            graph.AddPass("Upscale", [this]() { upscalePass(); }).Read(source).Color(upscaled);
+            source = upscaled;
+        }
+        sharpenInput = source;
+        RGResource sharpened = post.Empty() ? RG_NONE : graph.Create("Sharpened", colorDesc);
+        RenderGraph::PassBuilder rcas = graph.AddPass("RCAS", [this]() { rcasPass(); });
+        rcas.Read(source);
+        if (sharpened != RG_NONE) rcas.Color(sharpened); else rcas.Target(output);
+        return sharpened;
+    }
+
+    // One pass per post chain stage, each reading the previous one's target (the first reads
+    // 'source'); the last renders into the output. An empty chain copies the scene over with a
+    // blit instead of a full-screen draw.
+    void addPostPasses(RGResource output, const RGTextureDesc &colorDesc, RGResource source) {
+        static const char *names[] = { "PostColor", "PostKernel", "BlurH", "BlurV", "Upsample", "FXAA" };
+        std::vector<PostChain::Stage> &stages = post.Plan();
+        if (source == RG_NONE) return; // already in the output
+        if (stages.empty()) {
+            presentInput = source;
+            graph.AddPass("Present", [this]() { presentPass(); }).Read(source).Target(output);
+            return;
+        }
+        int luts = 0;
+        for (int i = 0; i < (int)stages.size(); i++) {
+            PostChain::Stage &stage = stages[i];
+            if (stage.kind == PostChain::STAGE_COLOR) stage.lut = luts++;
+            RGResource target = RG_NONE;
+            if (i + 1 < (int)stages.size()) {
+                RGTextureDesc desc = colorDesc;
+                desc.width = PostChain::Scaled(key.width, stage.scale); desc.height = PostChain::Scaled(key.height, stage.scale);
+                target = graph.Create(names[stage.kind], desc);
+            }
+            RenderGraph::PassBuilder pass = graph.AddPass(names[stage.kind], [this, i]() { postPass(i); });
+            pass.Read(source);
+            if (stage.kind == PostChain::STAGE_UPSAMPLE) pass.Read(sceneDepth);
+            if (target != RG_NONE) pass.Color(target); else pass.Target(output);
+            stage.input = source;
+            stage.output = target;
+            source = target;
+        }
+        if ((int)colorLuts.size() < luts) colorLuts.resize(luts);
+    }
+
+    // --- 1. SHADOW PASS ---
+    // Render scene from Sun's perspective to generate Depth Map
+    void shadowPass() {
+        const RenderScene &scene = *frameScene;
+        glClear(GL_DEPTH_BUFFER_BIT); // all of it: the rest of the map reads as unshadowed
+        glViewport(0, 0, shadowViewWidth, shadowViewHeight);
+
+        useShader(*shadowDepthShader);
+        shadowDepthShader->setMat4("lightSpaceMatrix", lightSpaceMatrix);
+
+        glEnable(GL_CULL_FACE);
+        glCullFace(GL_FRONT); // Optimization: Render back faces to fix Peter Panning
+        drawObjects(scene, *shadowDepthShader, false);
+        glCullFace(GL_BACK);
+        glDisable(GL_CULL_FACE);
+    }
+
+    // EVSM prefilter: depth to moments with the horizontal blur, then the vertical one and the
+    // mipmaps. Both stay in the shadow pass's corner; the rest of the filtered map reads as
+    // unshadowed, which is what the coarser mips blend in at its edge.
+    void evsmPass(bool vertical) {
+        glDisable(GL_DEPTH_TEST);
+        glm::vec2 c = evsmExponents();
+        if (vertical) {
+            float positive = std::exp(c.x), negative = -std::exp(-c.y); // depth 1.0
+            const float far[] = { positive, positive * positive, negative, negative * negative };
+            glClearBufferfv(GL_COLOR, 0, far);
+        }
+        glViewport(0, 0, shadowViewWidth, shadowViewHeight);
+        useShader(*evsmShader);
+        evsmShader->setInt("vertical", vertical ? 1 : 0);
+        evsmShader->setVec2("viewSize", (float)shadowViewWidth, (float)shadowViewHeight);
+        evsmShader->setInt("radius", std::min(std::max(pcfRadius - quality.Drop(QUALITY_PCF), 0), 2) + 1);
+        evsmShader->setVec2("exponents", c.x, c.y);
+        drawQuad(graph.Texture(vertical ? shadowMoments : shadowMap));
+        if (vertical) {
+            glBindTexture(GL_TEXTURE_2D, graph.Texture(shadowLookup));
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+    }
+
+    // Point-light shadows: the shaded lights are placed in the atlas by how much of the view their
+    // range covers, then the faces casters moved in (or out of) since the last frame go stale
+    void updatePointShadows(const RenderScene &scene, const glm::vec3 &viewPos) {
+        glm::vec3 positions[MAX_SHADED_POINT_LIGHTS];
+        float coverage[MAX_SHADED_POINT_LIGHTS];
+        for (int i = 0; i < frameLights; i++) {
+            positions[i] = scene.pointLights[i].position;
+            coverage[i] = std::min(pointShadowRange / std::max(glm::length(positions[i] - viewPos), 1e-3f), 1.0f);
+        }
+        pointShadowAtlas.Place(frameLights, positions, coverage, pointShadowRange);
+        unsigned int casters = 0;
+        forEachObject(scene, -1, [&](GameObject &obj, unsigned int) {
+            casters++;
+            glm::mat4 model = obj.GetModelMatrix();
+            if (obj.shadowCasterValid && model == obj.shadowCasterModel) return;
+            glm::vec3 center;
+            float radius;
+            if (obj.shadowCasterValid) {
+                radius = obj.BoundingSphere(obj.shadowCasterModel, center);
+                pointShadowAtlas.Invalidate(center, radius);
+            }
+            radius = obj.BoundingSphere(model, center);
+            pointShadowAtlas.Invalidate(center, radius);
+            obj.shadowCasterModel = model;
+            obj.shadowCasterValid = true;
+        });
+        // A removed caster leaves no bounds to invalidate; its shadow could be anywhere
+        if (casters < shadowCasters) pointShadowAtlas.InvalidateAll();
+        shadowCasters = casters;
+    }
+
+    // The atlas's depth texture, (re)allocated with a new format, which drops every tile
+    RGTextureDesc allocateAtlas() {
+        RGTextureDesc desc;
+        desc.width = desc.height = POINT_SHADOW_ATLAS_SIZE;
+        desc.format = key.shadowDepth16 ? GL_DEPTH_COMPONENT16 : GL_DEPTH_COMPONENT24;
+        desc.filter = GL_LINEAR; // with the comparison: one bilinear PCF tap
+        desc.wrap = GL_CLAMP_TO_EDGE;
+        desc.compare = GL_COMPARE_REF_TO_TEXTURE;
+        if (atlasFormat != desc.format) {
+            glBindTexture(GL_TEXTURE_2D, atlasTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, desc.format, desc.width, desc.height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, desc.filter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, desc.filter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, desc.wrap);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, desc.wrap);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, desc.compare);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            atlasFormat = desc.format;
+            pointShadowAtlas.Init(POINT_SHADOW_ATLAS_SIZE, 256, 64);
+            shadowCasters = 0;
+        }
+        return desc;
+    }
+
+    // The faces the atlas scheduled, each into its tile (the scissor keeps the clear inside it)
+    // with the casters inside its pyramid. Depth is the distance to the light, see point_shadow.frag.
+    void pointShadowPass() {
+        const RenderScene &scene = *frameScene;
+        int faces = pointShadowAtlas.Schedule(updateLights, updateFaces);
+        counters.shadowFaces = (unsigned int)faces;
+        if (!faces) return;
+        glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, 0.05f, pointShadowRange);
+        useShader(*pointShadowShader);
+        pointShadowShader->setFloat("far", pointShadowRange);
+        glEnable(GL_DEPTH_TEST);
+        glEnable(GL_SCISSOR_TEST);
+        glEnable(GL_CULL_FACE);
+        glCullFace(GL_FRONT);
+        for (int i = 0; i < faces; i++) {
+            int face = updateFaces[i];
+            glm::vec3 position = scene.pointLights[updateLights[i]].position;
+            const ShadowAtlas::Tile &tile = pointShadowAtlas.FaceTile(updateLights[i], face);
+            glViewport(tile.x, tile.y, tile.size, tile.size);
+            glScissor(tile.x, tile.y, tile.size, tile.size);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            pointShadowShader->setMat4("lightSpaceMatrix", projection * ShadowAtlas::FaceView(position, face));
+            pointShadowShader->setVec3("lightPos", position);
+            forEachObject(scene, -1, [&](GameObject &obj, unsigned int) {
+                glm::vec3 center;
+                float radius = obj.BoundingSphere(obj.shadowCasterModel, center);
+                glm::vec3 d = center - position;
+                if (glm::dot(d, d) <= (pointShadowRange + radius) * (pointShadowRange + radius) && ShadowAtlas::SphereInFace(d, radius, face))
+                    drawObject(obj, *pointShadowShader);
+            });
+        }
+        glCullFace(GL_BACK);
+        glDisable(GL_CULL_FACE);
+        glDisable(GL_SCISSOR_TEST);
+    }
+
+    // Largest warps whose squares the moments' format still holds (e^(2c) below its maximum)
+    glm::vec2 evsmExponents() const { return key.shadowDepth16 ? glm::vec2(5.54f, 5.54f) : glm::vec2(40.0f, 5.0f); }
+
+    // Every lit variant the governor can pick for one shadow filter, issued for background compilation
+    void prepareLitVariants(ShadowFilter filter) {
+        for (uint32_t lights = 0; lights <= (uint32_t)MAX_SHADED_POINT_LIGHTS; lights++)
+            for (uint32_t shadowed = 0; shadowed <= 1; shadowed++)
+                for (uint32_t pcf = 0; pcf <= (shadowed ? 2u : 0u); pcf++) // every filter size the governor can pick
+                    standardVariants->Prepare(standardVariants->Field(STANDARD_POINT_LIGHTS, lights) | standardVariants->Field(STANDARD_SHADOWS, shadowed) |
+                        standardVariants->Field(STANDARD_PCF_RADIUS, pcf) | standardVariants->Field(STANDARD_SHADOW_FILTER, shadowed ? (uint32_t)filter : 0u));
+    }
+
+    // --- 2. LIGHTING PASS (Render to the offscreen target) ---
+    void lightingPass() {
+        const RenderScene &scene = *frameScene;
+        glEnable(GL_DEPTH_TEST);
+        glViewport(0, 0, sceneWidth, sceneHeight); // clears still cover the whole target
+        if (writeObjectIDs || key.taa) {
+            // Integer attachments must be cleared with glClearBuffer*, glClear's float color is undefined for them
+            const float clearColor[] = { 0.1f, 0.1f, 0.1f, 1.0f };
+            const GLuint clearID[] = { 0, 0, 0, 0 };
+            const float clearVelocity[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            glClearBufferfv(GL_COLOR, 0, clearColor);
+            if (writeObjectIDs) glClearBufferuiv(GL_COLOR, 1, clearID);
+            if (key.taa) glClearBufferfv(GL_COLOR, 2, clearVelocity);
+            glClear(GL_DEPTH_BUFFER_BIT);
+        } else {
+            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
+
+        if (shadows) {
+            // Bind Shadow Map to Texture Unit 1
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, graph.Texture(shadowLookup));
+            counters.textureBinds++;
+        }
+        if (key.pointShadows) {
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, atlasTexture);
+            counters.textureBinds++;
+        }
+        // Bind Standard Textures (handled in Mesh.Draw usually, but we reset here to be safe)
+        glActiveTexture(GL_TEXTURE0);
+
+        // One variant per group: shadow receivers, then the objects that skip the lookup
+        int pcf = std::min(std::max(pcfRadius - quality.Drop(QUALITY_PCF), 0), 2);
+        uint32_t variant = standardVariants->Field(STANDARD_POINT_LIGHTS, (uint32_t)frameLights);
+        if (shadows) drawLit(scene, variant | standardVariants->Field(STANDARD_SHADOWS, 1) | standardVariants->Field(STANDARD_PCF_RADIUS, (uint32_t)pcf) |
+            standardVariants->Field(STANDARD_SHADOW_FILTER, (uint32_t)key.shadowFilter), 1);
+        drawLit(scene, variant, shadows ? 0 : -1);
+    }
+
+    // Draws the objects selected by 'receivers' (see forEachObject) with standard.frag's variant
+    // 'variant', which is bound and given the frame's uniforms before the first of them
+    void drawLit(const RenderScene &scene, uint32_t variant, int receivers) {
+        Shader *shader = nullptr;
+        unsigned int boundID = ~0u;
+        forEachObject(scene, receivers, [&](GameObject &obj, unsigned int id) {
+            if (!shader) {
+                shader = &standardVariants->Get(variant);
+                setupLighting(scene, *shader, (int)standardVariants->Value(variant, STANDARD_POINT_LIGHTS), standardVariants->Value(variant, STANDARD_SHADOWS) != 0);
+            }
+            if (writeObjectIDs && id != boundID) { shader->setUInt("objectID", id); boundID = id; }
+            if (key.taa) {
+                // Last frame's transform for the velocity buffer; a new object has no motion yet
+                glm::mat4 model = obj.GetModelMatrix();
+                shader->setMat4("prevModel", obj.motionValid ? obj.previousModel : model);
+                obj.previousModel = model;
+                obj.motionValid = true;
+            }
+            drawObject(obj, *shader);
+        });
+    }
+
+    void setupLighting(const RenderScene &scene, Shader &shader, int lights, bool shadowed) {
+        useShader(shader);
+        shader.setVec3("viewPos", frameViewPos);
+        shader.setFloat("lodBias", (float)quality.Drop(QUALITY_LOD_BIAS));
+        shader.setVec3("dirLight.direction", scene.sunDirection);
+        shader.setVec3("dirLight.ambient", scene.sunColor * 0.2f);
+        shader.setVec3("dirLight.diffuse", scene.sunColor);
+        shader.setVec3("dirLight.specular", scene.sunColor);
+        shader.setMat4("lightSpaceMatrix", shadowLookupMatrix); // Send matrix for shadow calculations
+        if (key.shadowFilter == SHADOW_FILTER_EVSM) { glm::vec2 c = evsmExponents(); shader.setVec2("evsmExponents", c.x, c.y); }
+        for(int i = 0; i < lights; i++) {
+            const SceneLight &light = scene.pointLights[i];
+            char name[48];
+            snprintf(name, sizeof(name), "pointLights[%d].position", i); shader.setVec3(name, light.position);
+            snprintf(name, sizeof(name), "pointLights[%d].ambient", i); shader.setVec3(name, light.color * 0.1f);
+            snprintf(name, sizeof(name), "pointLights[%d].diffuse", i); shader.setVec3(name, light.color);
+            snprintf(name, sizeof(name), "pointLights[%d].specular", i); shader.setVec3(name, light.color);
+            snprintf(name, sizeof(name), "pointLights[%d].constant", i); shader.setFloat(name, 1.0f);
+            snprintf(name, sizeof(name), "pointLights[%d].linear", i); shader.setFloat(name, 0.09f);
+            snprintf(name, sizeof(name), "pointLights[%d].quadratic", i); shader.setFloat(name, 0.032f);
+        }
+        if (shadowed && lights > 0) {
+            // Each face's tile in atlas UV; zeros for a light without shadows (yet)
+            float tiles[MAX_SHADED_POINT_LIGHTS * ShadowAtlas::FACES * 4] = {};
+            float size = (float)pointShadowAtlas.Size();
+            for (int i = 0; key.pointShadows && i < std::min(lights, pointShadowAtlas.Lights()); i++) {
+                if (!pointShadowAtlas.Ready(i)) continue;
+                for (int face = 0; face < ShadowAtlas::FACES; face++) {
+                    const ShadowAtlas::Tile &tile = pointShadowAtlas.FaceTile(i, face);
+                    float *t = tiles + (i * ShadowAtlas::FACES + face) * 4;
+                    t[0] = tile.x / size; t[1] = tile.y / size; t[2] = tile.size / size; t[3] = 0.5f / tile.size;
+                }
+            }
+            shader.setVec4Array("pointShadowTiles", tiles, lights * ShadowAtlas::FACES);
+            shader.setFloat("pointShadowFar", pointShadowRange);
+        }
+        shader.setMat4("projection", frameProjection);
+        shader.setMat4("view", frameView);
+        shader.setMat4("currentViewProjection", frameViewProjection);
+        shader.setMat4("previousViewProjection", previousViewProjection);
+    }
+
+    void lampsPass() {
+        const RenderScene &scene = *frameScene;
+        glViewport(0, 0, sceneWidth, sceneHeight);
+        useShader(*lampShader);
+        lampShader->setMat4("projection", frameProjection);
+        lampShader->setMat4("view", frameView);
+        lampShader->setMat4("currentViewProjection", frameViewProjection);
+        lampShader->setMat4("previousViewProjection", previousViewProjection);
+        for(int i = 0; i < scene.pointLightCount; i++) {
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, scene.pointLights[i].position);
+            model = glm::scale(model, glm::vec3(0.2f));
+            lampShader->setMat4("model", model);
+            lampShader->setMat4("prevModel", model); // lamps only move with their light: close enough
+            lampShader->setVec3("lightColor", scene.pointLights[i].color);
+            lampModel->Draw(*lampShader);
+            countModel(lampModel);
+        }
+    }
+
+    void skyboxPass() {
+        glViewport(0, 0, sceneWidth, sceneHeight);
+        glDepthFunc(GL_LEQUAL);
+        useShader(*skyboxShader);
+        skyboxShader->setMat4("view", glm::mat4(glm::mat3(frameView)));
+        skyboxShader->setMat4("projection", frameProjection);
+        skyboxShader->setFloat("lodBias", (float)quality.Drop(QUALITY_SKYBOX));
+        skyboxShader->setMat4("currentViewProjection", frameSkyViewProjection);
+        skyboxShader->setMat4("previousViewProjection", previousSkyViewProjection);
+        glBindVertexArray(skyboxVAO);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+        glBindVertexArray(0);
+        glDepthFunc(GL_LESS);
+        counters.textureBinds++;
+        counters.drawCalls++;
+        counters.triangles += 12;
+    }
+
+    // --- 3. POST PROCESS (Screen Quads) --- one chain stage, see addPostPasses()
+    void postPass(int index) {
+        const PostChain::Stage &stage = post.Stages()[index];
+        const PostEffect &effect = post.effects[stage.effect];
+        int width = PostChain::Scaled(key.width, stage.scale), height = PostChain::Scaled(key.height, stage.scale);
+        glDisable(GL_DEPTH_TEST);
+        switch (stage.kind) {
+        case PostChain::STAGE_COLOR: {
+            ColorLut &lut = colorLuts[stage.lut];
+            lut.Bake(post, stage.effect, stage.end);
+            useShader(*screenShader);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_3D, lut.Texture());
+            counters.textureBinds++;
+            break;
+        }
+        case PostChain::STAGE_KERNEL: {
+            Shader &shader = kernelVariants->Get(kernelVariants->Field(KERNEL_TYPE, effect.type == POST_EDGE_DETECT ? 1 : 0));
+            useShader(shader);
+            shader.setVec2("texelSize", 1.0f / width, 1.0f / height);
+            break;
+        }
+        case PostChain::STAGE_BLUR_H: case PostChain::STAGE_BLUR_V: {
+            float weights[PostChain::MAX_BLUR_TAPS], offsets[PostChain::MAX_BLUR_TAPS];
+            int taps = PostChain::BlurTaps(effect.radius / (float)(1 << stage.scale), weights, offsets);
+            useShader(*blurShader);
+            blurShader->setInt("taps", taps);
+            blurShader->setFloatArray("weights", weights, taps);
+            blurShader->setFloatArray("offsets", offsets, taps);
+            if (stage.kind == PostChain::STAGE_BLUR_H) blurShader->setVec2("direction", 1.0f / width, 0.0f);
+            else blurShader->setVec2("direction", 0.0f, 1.0f / height);
+            break;
+        }
+        case PostChain::STAGE_UPSAMPLE:
+            useShader(*upsampleShader);
+            upsampleShader->setVec2("lowSize", (float)PostChain::Scaled(key.width, post.Scale(effect)), (float)PostChain::Scaled(key.height, post.Scale(effect)));
+            upsampleShader->setVec2("depthParams", frameProjection[2][2], frameProjection[3][2]);
+            upsampleShader->setVec2("depthScale", (float)sceneWidth / key.width, (float)sceneHeight / key.height);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, graph.Texture(sceneDepth));
+            counters.textureBinds++;
+            break;
+        case PostChain::STAGE_FXAA:
+            useShader(*fxaaShader);
+            fxaaShader->setVec2("texelSize", 1.0f / width, 1.0f / height);
+            break;
+        }
+        drawQuad(graph.Texture(stage.input));
+    }
+
+    // Dynamic resolution, full size from here on
+    void upscalePass() {
+        glDisable(GL_DEPTH_TEST);
+        useShader(*upscaleShader);
+        upscaleShader->setVec2("renderSize", (float)sceneWidth, (float)sceneHeight);
+        drawQuad(graph.Texture(sceneColor));
+    }
+
+    void rcasPass() {
+        glDisable(GL_DEPTH_TEST);
+        useShader(*rcasShader);
+        rcasShader->setFloat("sharpness", std::exp2(-resolution.sharpness));
+        drawQuad(graph.Texture(sharpenInput));
+    }
+
+    // TAA resolve, then the result is kept as the next frame's history
+    void taaPass() {
+        glDisable(GL_DEPTH_TEST);
+        useShader(*taaShader);
+        taaShader->setVec2("renderSize", (float)sceneWidth, (float)sceneHeight);
+        taaShader->setVec2("jitter", frameJitter.x, frameJitter.y);
+        taaShader->setFloat("historyValid", historyValid ? 1.0f : 0.0f);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, graph.Texture(velocity));
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, graph.Texture(sceneDepth));
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, historyTexture);
+        counters.textureBinds += 3;
+        drawQuad(graph.Texture(sceneColor));
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, historyFramebuffer);
+        glBlitFramebuffer(0, 0, key.width, key.height, 0, 0, key.width, key.height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, taaFramebuffer);
+        counters.framebufferBinds += 2;
+    }
+
+    // Radical inverse of i in 'base', in [0, 1)
+    static float halton(unsigned int i, unsigned int base) {
+        float f = 1.0f, result = 0.0f;
+        for (; i > 0; i /= base) {
+            f /= base;
+            result += f * (i % base);
+        }
+        return result;
+    }
+
+    void drawQuad(GLuint texture) {
+        glBindVertexArray(quadVAO);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        counters.textureBinds++;
+        counters.drawCalls++;
+        counters.triangles += 2;
+    }
+
+    // Empty chain: the scene color (or TAA's result) goes to the output as is
+    void presentPass() {
+        GLuint texture = graph.Texture(presentInput);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, presentFramebuffer);
+        if (presentSource != texture) {
+            glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+            presentSource = texture;
+        }
+        glBlitFramebuffer(0, 0, key.width, key.height, 0, 0, key.width, key.height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, key.target);
+        counters.framebufferBinds += 2;
+    }
+
+    void useShader(Shader &shader) { shader.use(); counters.programBinds++; }
+
+    void countModel(const Model *model) {
+        for (unsigned int i = 0; i < model->meshes.size(); i++) {
+            counters.drawCalls++;
+            counters.triangles += (unsigned int)model->meshes[i].indices.size() / 3;
+            counters.textureBinds += (unsigned int)model->meshes[i].textures.size();
+        }
+    }
+
+    void drawObject(GameObject &obj, Shader &shader) {
+        obj.Draw(shader);
+        counters.objects++;
+        if (obj.model) countModel(obj.model);
+    }
+
+    void drawObjects(const RenderScene &scene, Shader &shader, bool ids) {
+        forEachObject(scene, -1, [&](GameObject &obj, unsigned int id) {
+            if (ids) shader.setUInt("objectID", id);
+            drawObject(obj, shader);
+        });
+    }
+
+    // Calls fn(object, pickingID) for the scene's objects, then the streamed ones (ID 0: not
+    // editable). 'receivers' 1 / 0 keeps only objects that do / do not receive shadows, -1 all.
+    template <typename Fn>
+    void forEachObject(const RenderScene &scene, int receivers, Fn fn) {
+        if (scene.objects) {
+            std::vector<GameObject> &objects = *scene.objects;
+            for(unsigned int i = 0; i < objects.size(); i++)
+                if (receivers < 0 || objects[i].receiveShadows == (receivers != 0)) fn(objects[i], i + 1); // 0 means "nothing"
+        }
+        if (!scene.world) return;
+        scene.world->ForEachObject([&](GameObject &obj) { if (receivers < 0 || obj.receiveShadows == (receivers != 0)) fn(obj, 0u); });
+    }
+
+    unsigned int loadCubemap(const std::vector<std::string> &faces) {
+        PROFILE_SCOPE("loadCubemap");
+        PROFILE_MARK("asset", "cubemap " + faces[0]);
+        unsigned int textureID;
+        glGenTextures(1, &textureID);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+        int width, height, nrChannels;
+        stbi_set_flip_vertically_on_load(false);
+        for (unsigned int i = 0; i < faces.size(); i++) {
+            unsigned char *data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
+            if (data) {
+                GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
+                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+                stbi_image_free(data);
+            } else { LOG_WARN("Cubemap texture failed to load at path: %s", faces[i].c_str()); stbi_image_free(data); }
+        }
+        stbi_set_flip_vertically_on_load(true);
+        glGenerateMipmap(GL_TEXTURE_CUBE_MAP); // for the quality governor's LOD bias
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        return textureID;
+    }
+
+    static constexpr float skyboxVertices[108] = {
+        -1.0f,  1.0f, -1.0f, -1.0f, -1.0f, -1.0f, 1.0f, -1.0f, -1.0f,
+        1.0f, -1.0f, -1.0f, 1.0f,  1.0f, -1.0f, -1.0f,  1.0f, -1.0f,
+        -1.0f, -1.0f,  1.0f, -1.0f, -1.0f, -1.0f, -1.0f,  1.0f, -1.0f,
+        -1.0f,  1.0f, -1.0f, -1.0f,  1.0f,  1.0f, -1.0f, -1.0f,  1.0f,
+         1.0f, -1.0f, -1.0f, 1.0f, -1.0f,  1.0f, 1.0f,  1.0f,  1.0f,
+         1.0f,  1.0f,  1.0f, 1.0f,  1.0f, -1.0f, 1.0f, -1.0f, -1.0f,
+        -1.0f, -1.0f,  1.0f, -1.0f,  1.0f,  1.0f, 1.0f,  1.0f,  1.0f,
+         1.0f,  1.0f,  1.0f, 1.0f, -1.0f,  1.0f, -1.0f, -1.0f,  1.0f,
+        -1.0f,  1.0f, -1.0f, 1.0f,  1.0f, -1.0f, 1.0f,  1.0f,  1.0f,
+         1.0f,  1.0f,  1.0f, -1.0f,  1.0f,  1.0f, -1.0f,  1.0f, -1.0f,
+        -1.0f, -1.0f, -1.0f, -1.0f, -1.0f,  1.0f, 1.0f, -1.0f, -1.0f,
+         1.0f, -1.0f, -1.0f, -1.0f, -1.0f,  1.0f, 1.0f, -1.0f,  1.0f
+    };
+
+    static constexpr float quadVertices[24] = {
+        -1.0f,  1.0f,  0.0f, 1.0f, -1.0f, -1.0f,  0.0f, 0.0f, 1.0f, -1.0f,  1.0f, 0.0f,
+        -1.0f,  1.0f,  0.0f, 1.0f, 1.0f, -1.0f,  1.0f, 0.0f, 1.0f,  1.0f,  1.0f, 1.0f
+    };
+};
+#endif
@@ -0,0 +1,412 @@
+#ifndef SCENEFILE_H
+#define SCENEFILE_H
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <atomic>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Scene files come in two flavours:
+//  - the original line-oriented text format (name / position / rotation / scale per object,
+//    followed by SUN_SETTINGS). The model path, if any, trails the scale line so older
+//    readers simply skip it. Optional PARENTS and POINT_LIGHTS blocks follow SUN_SETTINGS,
+//    where older readers stop.
+//  - a versioned binary format laid out exactly like SceneView, so a mapped file can be
+//    used in place without parsing. All sections are 16-byte aligned, little-endian.
+
+struct SceneTransform {
+    glm::vec3 position;
+    glm::vec3 rotation;
+    glm::vec3 scale;
+};
+
+struct SceneLight {
+    glm::vec3 position;
+    glm::vec3 color;
+};
+
+const uint32_t SCENE_NO_ASSET = 0xFFFFFFFFu; // object uses the loader's default model
+const uint32_t SCENE_NO_PARENT = 0xFFFFFFFFu; // root object; parents always precede their children
+
+// Read-only view over a scene, either pointing into a mapped binary file or into a SceneData
+struct SceneView {
+    const char *strings = nullptr;          // string table, NUL-terminated entries
+    uint32_t stringBytes = 0;
+    const uint32_t *assetPaths = nullptr;   // asset table: string offset of each model path
+    uint32_t assetCount = 0;
+    const uint32_t *names = nullptr;        // per object: string offset of the name
+    const uint32_t *assets = nullptr;       // per object: asset index or SCENE_NO_ASSET
+    const SceneTransform *transforms = nullptr;
+    const uint32_t *parents = nullptr;      // per object: parent index or SCENE_NO_PARENT; null when flat
+    uint32_t objectCount = 0;
+    const SceneLight *lights = nullptr;     // point lights; none means "keep the editor's defaults"
+    uint32_t lightCount = 0;
+    glm::vec3 sunDirection = glm::vec3(-0.5f, -1.0f, -0.5f);
+    glm::vec3 sunColor = glm::vec3(0.9f);
+
+    const char* String(uint32_t offset) const {
+        return offset < stringBytes ? strings + offset : "";
+    }
+    uint32_t Parent(uint32_t object) const {
+        return parents ? parents[object] : SCENE_NO_PARENT;
+    }
+};
+
+// Owning, editable scene description with the same layout as the binary file
+struct SceneData {
+    std::vector<char> strings;
+    std::vector<uint32_t> assetPaths;
+    std::vector<uint32_t> names;
+    std::vector<uint32_t> assets;
+    std::vector<SceneTransform> transforms;
+    std::vector<uint32_t> parents;          // empty until the first object with a parent
+    std::vector<SceneLight> lights;
+    glm::vec3 sunDirection = glm::vec3(-0.5f, -1.0f, -0.5f);
+    glm::vec3 sunColor = glm::vec3(0.9f);
+
+    uint32_t AddString(const std::string &s) {
+        uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings.insert(strings.end(), s.begin(), s.end());
+        strings.push_back('\0');
+        return offset;
+    }
+
+    // Returns the asset index for a model path, adding it to the asset table on first use
+    uint32_t AddAsset(const std::string &path) {
+        std::map<std::string, uint32_t>::iterator it = assetLookup.find(path);
+        if (it != assetLookup.end()) return it->second;
+        uint32_t index = static_cast<uint32_t>(assetPaths.size());
+        assetPaths.push_back(AddString(path));
+        assetLookup[path] = index;
+        return index;
+    }
+
+    void AddObject(const std::string &name, uint32_t asset, const SceneTransform &transform, uint32_t parent = SCENE_NO_PARENT) {
+        if (parent != SCENE_NO_PARENT && parents.size() < names.size()) parents.resize(names.size(), SCENE_NO_PARENT);
+        names.push_back(AddString(name));
+        assets.push_back(asset);
+        transforms.push_back(transform);
+        if (!parents.empty()) parents.push_back(parent);
+    }
+
+    void Reserve(size_t objects) {
+        names.reserve(objects);
+        assets.reserve(objects);
+        transforms.reserve(objects);
+        strings.reserve(objects * 16);
+    }
+
+    void Clear() {
+        strings.clear(); assetPaths.clear(); names.clear(); assets.clear(); transforms.clear();
+        parents.clear(); lights.clear();
+        assetLookup.clear();
+    }
+
+    SceneView View() const {
+        SceneView view;
+        view.strings = strings.data();
+        view.stringBytes = static_cast<uint32_t>(strings.size());
+        view.assetPaths = assetPaths.data();
+        view.assetCount = static_cast<uint32_t>(assetPaths.size());
+        view.names = names.data();
+        view.assets = assets.data();
+        view.transforms = transforms.data();
+        view.parents = parents.empty() ? nullptr : parents.data();
+        view.objectCount = static_cast<uint32_t>(names.size());
+        view.lights = lights.data();
+        view.lightCount = static_cast<uint32_t>(lights.size());
+        view.sunDirection = sunDirection;
+        view.sunColor = sunColor;
+        return view;
+    }
+
+private:
+    std::map<std::string, uint32_t> assetLookup;
+};
+
+// Read-only file mapping. Falls back to reading the file into memory where mmap is unavailable.
+class MappedFile {
+public:
+    MappedFile() {}
+    ~MappedFile() { Close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const char *path) {
+        Close();
+#ifndef _WIN32
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) { close(fd); return false; }
+        void *mem = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mem == MAP_FAILED) return false;
+        data = static_cast<const unsigned char*>(mem);
+        size = (size_t)st.st_size;
+        mapped = true;
+        return true;
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) return false;
+        fallback.resize((size_t)in.tellg());
+        in.seekg(0);
+        in.read(fallback.data(), fallback.size());
+        data = reinterpret_cast<const unsigned char*>(fallback.data());
+        size = fallback.size();
+        return size > 0;
+#endif
+    }
+
+    void Close() {
+#ifndef _WIN32
+        if (mapped) munmap(const_cast<unsigned char*>(data), size);
+#endif
+        fallback.clear();
+        data = nullptr;
+        size = 0;
+        mapped = false;
+    }
+
+    const unsigned char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const unsigned char *data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    std::vector<char> fallback;
+};
+
+// --- Binary format ---
+const char SCENE_BINARY_MAGIC[4] = { 'G', 'S', 'C', 'N' };
+const uint32_t SCENE_BINARY_VERSION = 1;
+
+enum SceneSectionID : uint32_t {
+    SCENE_SECTION_STRINGS       = 1, // char[count]
+    SCENE_SECTION_ASSETS        = 2, // uint32_t[count], string offsets of model paths
+    SCENE_SECTION_NAMES         = 3, // uint32_t[count], string offsets of object names
+    SCENE_SECTION_OBJECT_ASSETS = 4, // uint32_t[count], asset index per object
+    SCENE_SECTION_TRANSFORMS    = 5, // SceneTransform[count]
+    SCENE_SECTION_SUN           = 6, // float[6], direction then color
+    SCENE_SECTION_PARENTS       = 7, // uint32_t[count], parent index per object (optional)
+    SCENE_SECTION_LIGHTS        = 8, // SceneLight[count] (optional)
+};
+
+struct SceneFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t sectionCount;
+    uint32_t reserved;
+};
+
+struct SceneSection {
+    uint32_t id;
+    uint32_t count;  // element count
+    uint64_t offset; // from the start of the file, 16-byte aligned
+    uint64_t size;   // in bytes
+};
+
+inline bool IsBinarySceneFile(const char *path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4] = {};
+    in.read(magic, 4);
+    return in && std::memcmp(magic, SCENE_BINARY_MAGIC, 4) == 0;
+}
+
+// Points 'view' into a mapped binary scene. Only the header and section table are read;
+// unknown sections are skipped so newer writers stay loadable.
+inline bool OpenSceneBinary(const MappedFile &file, SceneView &view) {
+    const unsigned char *base = file.Data();
+    size_t size = file.Size();
+    if (size < sizeof(SceneFileHeader)) return false;
+    SceneFileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, SCENE_BINARY_MAGIC, 4) != 0 || header.version > SCENE_BINARY_VERSION) return false;
+    if (sizeof(SceneFileHeader) + (uint64_t)header.sectionCount * sizeof(SceneSection) > size) return false;
+
+    view = SceneView();
+    const SceneSection *sections = reinterpret_cast<const SceneSection*>(base + sizeof(SceneFileHeader));
+    uint32_t namesCount = 0, assetsCount = 0, transformCount = 0, parentCount = 0;
+    for (uint32_t i = 0; i < header.sectionCount; i++) {
+        const SceneSection &s = sections[i];
+        if (s.offset > size || s.size > size - s.offset || (s.offset & 15) != 0) return false;
+        const void *p = base + s.offset;
+        switch (s.id) {
+        case SCENE_SECTION_STRINGS:
+            if (s.size != s.count || (s.count > 0 && static_cast<const char*>(p)[s.count - 1] != '\0')) return false;
+            view.strings = static_cast<const char*>(p); view.stringBytes = s.count; break;
+        case SCENE_SECTION_ASSETS:
+            if (s.size < (uint64_t)s.count * sizeof(uint32_t)) return false;
+            view.assetPaths = static_cast<const uint32_t*>(p); view.assetCount = s.count; break;
+        case SCENE_SECTION_NAMES:
+            if (s.size < (uint64_t)s.count * sizeof(uint32_t)) return false;
+            view.names = static_cast<const uint32_t*>(p); namesCount = s.count; break;
+        case SCENE_SECTION_OBJECT_ASSETS:
+            if (s.size < (uint64_t)s.count * sizeof(uint32_t)) return false;
+            view.assets = static_cast<const uint32_t*>(p); assetsCount = s.count; break;
+        case SCENE_SECTION_TRANSFORMS:
+            if (s.size < (uint64_t)s.count * sizeof(SceneTransform)) return false;
+            view.transforms = static_cast<const SceneTransform*>(p); transformCount = s.count; break;
+        case SCENE_SECTION_SUN:
+            if (s.size < 6 * sizeof(float)) return false;
+            std::memcpy(&view.sunDirection, p, sizeof(glm::vec3));
+            std::memcpy(&view.sunColor, static_cast<const float*>(p) + 3, sizeof(glm::vec3));
+            break;
+        case SCENE_SECTION_PARENTS:
+            if (s.size < (uint64_t)s.count * sizeof(uint32_t)) return false;
+            view.parents = s.count ? static_cast<const uint32_t*>(p) : nullptr; parentCount = s.count; break;
+        case SCENE_SECTION_LIGHTS:
+            if (s.size < (uint64_t)s.count * sizeof(SceneLight)) return false;
+            view.lights = static_cast<const SceneLight*>(p); view.lightCount = s.count; break;
+        default: break;
+        }
+    }
+    if (namesCount != assetsCount || namesCount != transformCount) return false;
+    if (view.parents && parentCount != namesCount) return false;
+    view.objectCount = namesCount;
+    // Parents must precede children, so transforms can be resolved in one pass
+    for (uint32_t i = 0; view.parents && i < namesCount; i++)
+        if (view.parents[i] != SCENE_NO_PARENT && view.parents[i] >= i) return false;
+    return true;
+}
+
+// 'progress', if given, is advanced from 0 to 1 as the file is written (for background saves)
+inline bool WriteSceneBinary(const char *path, const SceneView &view, std::atomic<float> *progress = nullptr) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    float sun[6] = { view.sunDirection.x, view.sunDirection.y, view.sunDirection.z,
+                     view.sunColor.x, view.sunColor.y, view.sunColor.z };
+    struct Blob { uint32_t id, count; const void *data; uint64_t size; };
+    const Blob blobs[] = {
+        { SCENE_SECTION_STRINGS,       view.stringBytes, view.strings,    view.stringBytes },
+        { SCENE_SECTION_ASSETS,        view.assetCount,  view.assetPaths, view.assetCount * sizeof(uint32_t) },
+        { SCENE_SECTION_NAMES,         view.objectCount, view.names,      view.objectCount * sizeof(uint32_t) },
+        { SCENE_SECTION_OBJECT_ASSETS, view.objectCount, view.assets,     view.objectCount * sizeof(uint32_t) },
+        { SCENE_SECTION_TRANSFORMS,    view.objectCount, view.transforms, view.objectCount * sizeof(SceneTransform) },
+        { SCENE_SECTION_SUN,           6,                sun,             sizeof(sun) },
+        { SCENE_SECTION_PARENTS,       view.parents ? view.objectCount : 0, view.parents, view.parents ? view.objectCount * sizeof(uint32_t) : 0 },
+        { SCENE_SECTION_LIGHTS,        view.lightCount,  view.lights,     view.lightCount * sizeof(SceneLight) },
+    };
+    const uint32_t count = sizeof(blobs) / sizeof(blobs[0]);
+
+    SceneFileHeader header;
+    std::memcpy(header.magic, SCENE_BINARY_MAGIC, 4);
+    header.version = SCENE_BINARY_VERSION;
+    header.sectionCount = count;
+    header.reserved = 0;
+
+    SceneSection sections[count];
+    uint64_t offset = (sizeof(SceneFileHeader) + sizeof(sections) + 15) & ~uint64_t(15);
+    for (uint32_t i = 0; i < count; i++) {
+        sections[i].id = blobs[i].id;
+        sections[i].count = blobs[i].count;
+        sections[i].offset = offset;
+        sections[i].size = blobs[i].size;
+        offset = (offset + blobs[i].size + 15) & ~uint64_t(15);
+    }
+
+    static const char padding[16] = {};
+    const uint64_t CHUNK = 1 << 20;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(sections), sizeof(sections));
+    uint64_t written = sizeof(header) + sizeof(sections);
+    for (uint32_t i = 0; i < count; i++) {
+        out.write(padding, sections[i].offset - written);
+        const char *data = static_cast<const char*>(blobs[i].data);
+        for (uint64_t done = 0; done < blobs[i].size; done += CHUNK) {
+            out.write(data + done, std::min(CHUNK, blobs[i].size - done));
+            if (progress) progress->store((float)(sections[i].offset + done) / offset);
+        }
+        written = sections[i].offset + blobs[i].size;
+    }
+    if (progress) progress->store(1.0f);
+    return out.good();
+}
+
+// --- Text format ---
+inline bool WriteSceneText(const char *path, const SceneView &view, std::atomic<float> *progress = nullptr) {
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+    out << view.objectCount << "\n";
+    for (uint32_t i = 0; i < view.objectCount; i++) {
+        const SceneTransform &t = view.transforms[i];
+        out << view.String(view.names[i]) << "\n";
+        out << t.position.x << " " << t.position.y << " " << t.position.z << "\n";
+        out << t.rotation.x << " " << t.rotation.y << " " << t.rotation.z << "\n";
+        out << t.scale.x << " " << t.scale.y << " " << t.scale.z;
+        if (view.assets[i] != SCENE_NO_ASSET) out << " " << view.String(view.assetPaths[view.assets[i]]);
+        out << "\n";
+        if (progress && (i & 4095) == 0) progress->store((float)i / view.objectCount);
+    }
+    out << "SUN_SETTINGS\n"; out << view.sunDirection.x << " " << view.sunDirection.y << " " << view.sunDirection.z << "\n"; out << view.sunColor.x << " " << view.sunColor.y << " " << view.sunColor.z << "\n";
+    if (view.parents) {
+        out << "PARENTS\n";
+        for (uint32_t i = 0; i < view.objectCount; i++) out << (view.parents[i] == SCENE_NO_PARENT ? -1 : (int64_t)view.parents[i]) << "\n";
+    }
+    if (view.lightCount) {
+        out << "POINT_LIGHTS\n" << view.lightCount << "\n";
+        for (uint32_t i = 0; i < view.lightCount; i++) {
+            const SceneLight &l = view.lights[i];
+            out << l.position.x << " " << l.position.y << " " << l.position.z << " " << l.color.x << " " << l.color.y << " " << l.color.z << "\n";
+        }
+    }
+    if (progress) progress->store(1.0f);
+    return out.good();
+}
+
+inline bool ReadSceneText(const char *path, SceneData &scene) {
+    std::ifstream in(path); if (!in.is_open()) return false;
+    scene.Clear();
+    int count = 0; in >> count; std::string rest; std::getline(in, rest);
+    if (count > 0) scene.Reserve(std::min(count, 1 << 20)); // the count is untrusted; push_back grows past the cap
+    for (int i = 0; i < count && in; i++) {
+        std::string name; std::getline(in, name); if (name.empty()) name = "Unnamed Object";
+        SceneTransform t{};
+        in >> t.position.x >> t.position.y >> t.position.z;
+        in >> t.rotation.x >> t.rotation.y >> t.rotation.z;
+        in >> t.scale.x >> t.scale.y >> t.scale.z;
+        if (!in) break; // cut off inside the object
+        std::getline(in, rest);
+        size_t start = rest.find_first_not_of(" \t\r");
+        uint32_t asset = start == std::string::npos ? SCENE_NO_ASSET : scene.AddAsset(rest.substr(start));
+        scene.AddObject(name, asset, t);
+    }
+    if ((int64_t)scene.names.size() < (int64_t)count) return false; // truncated: fewer objects than the header says
+    std::string tag;
+    while (in >> tag) {
+        if (tag == "SUN_SETTINGS") { in >> scene.sunDirection.x >> scene.sunDirection.y >> scene.sunDirection.z; in >> scene.sunColor.x >> scene.sunColor.y >> scene.sunColor.z; }
+        else if (tag == "PARENTS") {
+            scene.parents.assign(scene.names.size(), SCENE_NO_PARENT);
+            for (size_t i = 0; i < scene.parents.size(); i++) {
+                int64_t parent = -1; in >> parent;
+                if (parent >= 0 && (size_t)parent < i) scene.parents[i] = (uint32_t)parent; // parents precede children
+            }
+        }
+        else if (tag == "POINT_LIGHTS") {
+            int lights = 0; in >> lights;
+            for (int i = 0; i < lights && in; i++) {
+                SceneLight l;
+                in >> l.position.x >> l.position.y >> l.position.z >> l.color.x >> l.color.y >> l.color.z;
+                scene.lights.push_back(l);
+            }
+        }
+        else break;
+    }
+    return true;
+}
+#endif
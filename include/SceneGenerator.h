@@ -0,0 +1,195 @@
+#ifndef SCENEGENERATOR_H
+#define SCENEGENERATOR_H
+
+#include "SceneFile.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Procedural stress scenes for the renderer, culling, picking and serialization benchmarks.
+// The same settings always produce the same file: the generator uses its own RNG instead of
+// <random>'s distributions, whose output differs between standard libraries.
+
+enum SceneDistribution {
+    SCENE_DIST_UNIFORM,  // objects scattered evenly over the whole area
+    SCENE_DIST_CITY,     // districts of buildings on a street grid, taller towards each centre
+    SCENE_DIST_INTERIOR, // small props packed into multi-storey rooms (heavy overdraw, deep picking)
+};
+
+inline const char* SceneDistributionName(SceneDistribution d) {
+    switch (d) {
+    case SCENE_DIST_CITY: return "city";
+    case SCENE_DIST_INTERIOR: return "interior";
+    default: return "uniform";
+    }
+}
+
+inline bool ParseSceneDistribution(const char *name, SceneDistribution &d) {
+    for (int i = SCENE_DIST_UNIFORM; i <= SCENE_DIST_INTERIOR; i++)
+        if (std::strcmp(name, SceneDistributionName((SceneDistribution)i)) == 0) { d = (SceneDistribution)i; return true; }
+    return false;
+}
+
+struct SceneModelWeight {
+    std::string path; // empty: the loader's default model
+    float weight;
+};
+
+struct SceneGenSettings {
+    uint64_t seed = 1;
+    uint32_t objectCount = 1000;
+    SceneDistribution distribution = SCENE_DIST_UNIFORM;
+    float extent = 500.0f;                  // half-size of the generated area in world units
+    std::vector<SceneModelWeight> models;   // model mix; empty puts the default model everywhere
+    uint32_t lightCount = 4;
+    int hierarchyDepth = 1;                 // 1 = flat, otherwise levels per tree including the root
+    int childrenPerNode = 4;
+};
+
+// Parses "cube.obj:3,crate.obj:1" (weights default to 1) into a model mix
+inline std::vector<SceneModelWeight> ParseSceneModelMix(const std::string &text) {
+    std::vector<SceneModelWeight> models;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find(',', start);
+        if (end == std::string::npos) end = text.size();
+        std::string item = text.substr(start, end - start);
+        size_t colon = item.rfind(':');
+        SceneModelWeight m = { item, 1.0f };
+        if (colon != std::string::npos) { m.path = item.substr(0, colon); m.weight = (float)std::atof(item.c_str() + colon + 1); }
+        if (!m.path.empty() && m.weight > 0.0f) models.push_back(m);
+        start = end + 1;
+    }
+    return models;
+}
+
+// splitmix64: tiny, fast and bit-identical everywhere
+struct SceneRandom {
+    uint64_t state;
+    explicit SceneRandom(uint64_t seed) : state(seed) {}
+
+    uint64_t Next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    float Float() { return (Next() >> 40) * (1.0f / 16777216.0f); } // [0, 1)
+    float Range(float lo, float hi) { return lo + (hi - lo) * Float(); }
+    uint32_t Index(uint32_t count) { return (uint32_t)((Next() >> 32) * count >> 32); }
+    // Approximately normal (Irwin-Hall with 4 samples), mean 0, deviation 1
+    float Normal() { return (Float() + Float() + Float() + Float() - 2.0f) * 1.7320508f; }
+};
+
+// Fills 'scene' (cleared first). Trees are written depth first, so parents precede children.
+inline void GenerateScene(const SceneGenSettings &settings, SceneData &scene) {
+    scene.Clear();
+    scene.Reserve(settings.objectCount);
+    SceneRandom rng(settings.seed);
+    const float extent = settings.extent > 0.0f ? settings.extent : 1.0f;
+
+    // Model mix as a cumulative table
+    std::vector<uint32_t> assets;
+    std::vector<float> cumulative;
+    float totalWeight = 0.0f;
+    for (const SceneModelWeight &m : settings.models) {
+        totalWeight += m.weight;
+        cumulative.push_back(totalWeight);
+        assets.push_back(m.path.empty() ? SCENE_NO_ASSET : scene.AddAsset(m.path));
+    }
+    auto pickAsset = [&]() -> uint32_t {
+        if (assets.empty()) return SCENE_NO_ASSET;
+        float r = rng.Float() * totalWeight;
+        for (size_t i = 0; i < cumulative.size(); i++) if (r < cumulative[i]) return assets[i];
+        return assets.back();
+    };
+
+    // City districts, roughly one per 2000 buildings
+    std::vector<glm::vec2> districts;
+    if (settings.distribution == SCENE_DIST_CITY) {
+        uint32_t count = settings.objectCount / 2000 + 1;
+        for (uint32_t i = 0; i < count; i++) districts.push_back(glm::vec2(rng.Range(-extent, extent), rng.Range(-extent, extent)) * 0.8f);
+    }
+    const float interiorSize = extent * 0.1f, storeyHeight = 3.0f;
+    const int storeys = 4;
+
+    auto makeRoot = [&]() -> SceneTransform {
+        SceneTransform t;
+        switch (settings.distribution) {
+        case SCENE_DIST_CITY: {
+            const glm::vec2 &centre = districts[rng.Index((uint32_t)districts.size())];
+            float spread = extent * 0.08f;
+            glm::vec2 offset(rng.Normal() * spread, rng.Normal() * spread);
+            glm::vec2 p = glm::floor((centre + offset) / 8.0f) * 8.0f + 4.0f; // one building per 8x8 lot
+            float falloff = std::exp(-glm::length(offset) / spread);
+            float height = 2.0f + 40.0f * falloff * rng.Float() * rng.Float();
+            t.position = glm::vec3(p.x, height * 0.5f, p.y);
+            t.rotation = glm::vec3(0.0f, 90.0f * (float)rng.Index(4), 0.0f);
+            t.scale = glm::vec3(rng.Range(3.0f, 7.0f), height, rng.Range(3.0f, 7.0f));
+            break;
+        }
+        case SCENE_DIST_INTERIOR: {
+            float storey = (float)rng.Index(storeys);
+            t.position = glm::vec3(rng.Range(-interiorSize, interiorSize), storey * storeyHeight + rng.Range(0.1f, 2.5f), rng.Range(-interiorSize, interiorSize));
+            t.rotation = glm::vec3(rng.Range(0.0f, 360.0f), rng.Range(0.0f, 360.0f), rng.Range(0.0f, 360.0f));
+            t.scale = glm::vec3(rng.Range(0.1f, 0.8f));
+            break;
+        }
+        default:
+            t.position = glm::vec3(rng.Range(-extent, extent), 0.0f, rng.Range(-extent, extent));
+            t.rotation = glm::vec3(0.0f, rng.Range(0.0f, 360.0f), 0.0f);
+            t.scale = glm::vec3(rng.Range(0.5f, 2.0f));
+            break;
+        }
+        return t;
+    };
+    // Children sit on or around their parent, in the parent's space
+    auto makeChild = [&]() -> SceneTransform {
+        SceneTransform t;
+        t.position = glm::vec3(rng.Range(-0.6f, 0.6f), rng.Range(0.5f, 1.0f), rng.Range(-0.6f, 0.6f));
+        t.rotation = glm::vec3(0.0f, rng.Range(0.0f, 360.0f), 0.0f);
+        t.scale = glm::vec3(rng.Range(0.3f, 0.6f));
+        return t;
+    };
+
+    const int depth = settings.hierarchyDepth > 1 ? settings.hierarchyDepth : 1;
+    const int fanout = settings.childrenPerNode > 0 ? settings.childrenPerNode : 1;
+    std::vector<uint32_t> stackParent;
+    std::vector<int> stackLevel;
+    std::string name;
+    while (scene.names.size() < settings.objectCount) {
+        stackParent.assign(1, SCENE_NO_PARENT);
+        stackLevel.assign(1, 0);
+        while (!stackParent.empty() && scene.names.size() < settings.objectCount) {
+            uint32_t parent = stackParent.back(); stackParent.pop_back();
+            int level = stackLevel.back(); stackLevel.pop_back();
+            uint32_t index = (uint32_t)scene.names.size();
+            name = (level == 0 ? "Object " : "Child ") + std::to_string(index);
+            scene.AddObject(name, pickAsset(), level == 0 ? makeRoot() : makeChild(), parent);
+            if (level + 1 < depth)
+                for (int c = 0; c < fanout; c++) { stackParent.push_back(index); stackLevel.push_back(level + 1); }
+        }
+    }
+
+    // Lights over the same area, with saturated colours
+    const float lightArea = settings.distribution == SCENE_DIST_INTERIOR ? interiorSize : extent;
+    for (uint32_t i = 0; i < settings.lightCount; i++) {
+        SceneLight light;
+        float height = settings.distribution == SCENE_DIST_INTERIOR ? (float)rng.Index(storeys) * storeyHeight + 2.8f : rng.Range(2.0f, 10.0f);
+        light.position = glm::vec3(rng.Range(-lightArea, lightArea), height, rng.Range(-lightArea, lightArea));
+        glm::vec3 color(rng.Float(), rng.Float(), rng.Float());
+        float peak = std::max(color.x, std::max(color.y, color.z));
+        light.color = peak > 0.0f ? color / peak : glm::vec3(1.0f);
+        scene.lights.push_back(light);
+    }
+    scene.sunDirection = glm::vec3(-0.5f, -1.0f, -0.5f);
+    scene.sunColor = glm::vec3(0.9f);
+}
+#endif
@@ -0,0 +1,47 @@
+#ifndef SCENELOADER_H
+#define SCENELOADER_H
+
+#include "SceneFile.h"
+#include "ModelLibrary.h"
+#include "GameObject.h"
+#include "Profiler.h"
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+// Instantiates a scene file (binary or text) as GameObjects, importing its models through 'library'.
+// Objects without a model, or whose model is missing, get 'defaultModel'. Replaces 'objects'.
+// 'lights' is only replaced when the scene defines point lights.
+inline bool LoadSceneObjects(const char *filename, ModelLibrary &library, Model *defaultModel, std::vector<GameObject> &objects, glm::vec3 &sunDirection, glm::vec3 &sunColor, std::vector<SceneLight> *lights = nullptr) {
+    PROFILE_SCOPE("LoadSceneObjects");
+    PROFILE_MARK("scene", std::string("load ") + filename);
+    // Binary scenes are used straight from the mapping, text scenes are parsed into a SceneData first
+    MappedFile mapped; SceneData parsed; SceneView view;
+    if (IsBinarySceneFile(filename)) { if (!mapped.Open(filename) || !OpenSceneBinary(mapped, view)) return false; }
+    else { if (!ReadSceneText(filename, parsed)) return false; view = parsed.View(); }
+
+    std::vector<std::string> assetPaths(view.assetCount);
+    for (uint32_t i = 0; i < view.assetCount; i++) assetPaths[i] = view.String(view.assetPaths[i]);
+    std::vector<Model*> assetModels = library.LoadAll(assetPaths);
+
+    objects.clear();
+    objects.reserve(view.objectCount);
+    for (uint32_t i = 0; i < view.objectCount; i++) {
+        const char *name = view.String(view.names[i]);
+        uint32_t asset = view.assets[i];
+        objects.emplace_back(name[0] ? name : "Unnamed Object", asset < assetModels.size() ? assetModels[asset] : defaultModel);
+        GameObject &obj = objects.back();
+        obj.position = view.transforms[i].position;
+        obj.rotation = view.transforms[i].rotation;
+        obj.scale = view.transforms[i].scale;
+        uint32_t parent = view.Parent(i);
+        if (parent != SCENE_NO_PARENT && parent < i) obj.parent = (int)parent;
+    }
+    UpdateHierarchy(objects);
+    sunDirection = view.sunDirection; sunColor = view.sunColor;
+    if (lights && view.lightCount) lights->assign(view.lights, view.lights + view.lightCount);
+    return true;
+}
+#endif
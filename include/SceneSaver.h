@@ -0,0 +1,69 @@
+#ifndef SCENESAVER_H
+#define SCENESAVER_H
+
+#include "SceneFile.h"
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+
+// Writes a scene snapshot on a background thread so the editor keeps rendering while saving.
+// The snapshot is a SceneData owned by the saver, so the live scene can be edited (or cleared)
+// right after Start(). The file is written next to the target and renamed over it at the end,
+// so a crash mid-save never leaves a truncated scene behind.
+class AsyncSceneSaver {
+public:
+    ~AsyncSceneSaver() { Wait(); }
+
+    bool Busy() const { return running.load(); }
+    float Progress() const { return progress.load(); }
+    const std::string& Path() const { return path; }
+
+    // Returns false if a save is already in flight
+    bool Start(SceneData &&snapshot, const std::string &target, bool text) {
+        if (Busy()) return false;
+        Wait(); // join the previous, finished thread
+        scene = std::move(snapshot);
+        path = target;
+        progress = 0.0f;
+        finished = false;
+        running = true;
+        worker = std::thread([this, text]() {
+            std::string temp = path + ".tmp";
+            SceneView view = scene.View();
+            bool ok = text ? WriteSceneText(temp.c_str(), view, &progress) : WriteSceneBinary(temp.c_str(), view, &progress);
+#ifdef _WIN32
+            if (ok) std::remove(path.c_str()); // rename() does not replace on Windows
+#endif
+            if (ok) ok = std::rename(temp.c_str(), path.c_str()) == 0;
+            else std::remove(temp.c_str());
+            succeeded = ok;
+            scene = SceneData(); // free the snapshot on the worker, not the frame
+            finished = true;
+            running = false;
+        });
+        return true;
+    }
+
+    // Returns true once per completed save, reporting whether it succeeded
+    bool Poll(bool &ok) {
+        if (!finished.exchange(false)) return false;
+        ok = succeeded.load();
+        return true;
+    }
+
+    void Wait() {
+        if (worker.joinable()) worker.join();
+    }
+
+private:
+    SceneData scene;
+    std::string path;
+    std::thread worker;
+    std::atomic<float> progress{0.0f};
+    std::atomic<bool> running{false};
+    std::atomic<bool> finished{false};
+    std::atomic<bool> succeeded{false};
+};
+#endif
@@ -4,118 +4,220 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include "Profiler.h"
+#include "ShaderCache.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <string>
 #include <fstream>
-#include <sstream>
-#include <iostream>
+#include <vector>
 
+// A GL program from a vertex and a fragment shader file.
+// Construction only issues the work: the program comes from the binary cache (ShaderCache) or its
+// stages are compiled and linked without asking for the result, so the driver can build several
+// programs in parallel while the caller goes on creating the next. The status is checked (and a
+// fresh binary stored) by Finish(), which the first use() calls.
 class Shader {
 public:
     unsigned int ID;
 
-    // Constructor generates the shader on the fly
-    Shader(const char* vertexPath, const char* fragmentPath) {
-        // 1. Retrieve the vertex/fragment source code from filePath
-        std::string vertexCode;
-        std::string fragmentCode;
-        std::ifstream vShaderFile;
-        std::ifstream fShaderFile;
-        
-        // ensure ifstream objects can throw exceptions:
-        vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        try {
-            // open files
-            vShaderFile.open(vertexPath);
-            fShaderFile.open(fragmentPath);
-            std::stringstream vShaderStream, fShaderStream;
-            // read file's buffer contents into streams
-            vShaderStream << vShaderFile.rdbuf();
-            fShaderStream << fShaderFile.rdbuf();
-            // close file handlers
-            vShaderFile.close();
-            fShaderFile.close();
-            // convert stream into string
-            vertexCode = vShaderStream.str();
-            fragmentCode = fShaderStream.str();
-        }
-        catch (std::ifstream::failure& e) {
-            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << e.what() << std::endl;
-        }
+    // Constructor generates the shader on the fly. 'defines' ("#define NAME value" lines) is
+    // inserted after the #version line of both stages; see ShaderVariants.
+    Shader(const char* vertexPath, const char* fragmentPath, const char* defines = "")
+        : vertexPath(vertexPath), fragmentPath(fragmentPath), defines(defines) {
+        PROFILE_SCOPE("Shader compile");
+        PROFILE_MARK("shader", std::string(vertexPath) + " + " + fragmentPath);
+        // 1. Retrieve the vertex/fragment source code from filePath, with #includes expanded
+        std::string vertexCode = Preprocess(vertexPath, defines);
+        std::string fragmentCode = Preprocess(fragmentPath, defines);
         const char* vShaderCode = vertexCode.c_str();
         const char * fShaderCode = fragmentCode.c_str();
+
+        ID = glCreateProgram();
+        ShaderCache &cache = ShaderCache::Get();
+        cacheKey = cache.Key(vertexCode, fragmentCode);
+        fromCache = cache.Load(ID, cacheKey);
         
         // 2. Compile shaders
-        unsigned int vertex, fragment;
-        
         // Vertex Shader
         vertex = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(vertex, 1, &vShaderCode, NULL);
-        glCompileShader(vertex);
-        checkCompileErrors(vertex, "VERTEX");
         
         // Fragment Shader
         fragment = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragment, 1, &fShaderCode, NULL);
-        glCompileShader(fragment);
-        checkCompileErrors(fragment, "FRAGMENT");
         
         // Shader Program
-        ID = glCreateProgram();
         glAttachShader(ID, vertex);
         glAttachShader(ID, fragment);
+        if (fromCache) {
+            // Attached but never compiled: the binary is the program, the sources are only kept
+            // for FrameCapture, which records programs by their shaders
+            glDeleteShader(vertex);
+            glDeleteShader(fragment);
+            return;
+        }
+        glCompileShader(vertex);
+        glCompileShader(fragment);
+        cache.PrepareLink(ID);
         glLinkProgram(ID);
-        checkCompileErrors(ID, "PROGRAM");
+        pending = true;
+    }
+
+    // False while the driver is still compiling or linking in the background. Without
+    // GL_KHR_parallel_shader_compile there is no way to ask, and it reports true.
+    bool Ready() const {
+        if (!pending || !GLAD_GL_KHR_parallel_shader_compile) return true;
+        GLint done = GL_FALSE;
+        glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &done);
+        return done != GL_FALSE;
+    }
+
+    // Waits for the program if needed, reports errors and caches the binary
+    void Finish() {
+        if (!pending) return;
+        PROFILE_SCOPE("Shader link wait");
+        pending = false;
+        bool compiled = checkCompileErrors(vertex, "VERTEX", vertexPath.c_str());
+        compiled = checkCompileErrors(fragment, "FRAGMENT", fragmentPath.c_str()) && compiled;
+        bool linked = checkCompileErrors(ID, "PROGRAM", fragmentPath.c_str());
         
         // Delete the shaders as they're linked into our program now and no longer necessary
         glDeleteShader(vertex);
         glDeleteShader(fragment);
+        if (compiled && linked) ShaderCache::Get().Store(ID, cacheKey);
     }
-    
+
+    bool FromCache() const { return fromCache; }
+
+    // Source of 'path' as it is handed to the compiler:
+    //  - '#include "file"' lines are replaced by the file (paths relative to the working
+    //    directory, like the shaders themselves; each file is included once per source),
+    //  - 'defines' follows the #version line.
+    // #line directives keep compiler messages on the original lines; the source string number
+    // in them counts the files in the order they were opened, the shader itself being 0.
+    static std::string Preprocess(const char *path, const char *defines = "") {
+        std::vector<std::string> files;
+        std::string code;
+        if (!expandIncludes(path, files, code)) return code;
+        size_t version = code.find("#version");
+        if (version == std::string::npos || !defines || !*defines) return code;
+        size_t lineEnd = code.find('\n', version);
+        if (lineEnd == std::string::npos) { code += '\n'; lineEnd = code.size() - 1; }
+        int versionLine = 1 + (int)std::count(code.begin(), code.begin() + version, '\n');
+        char line[32];
+        snprintf(line, sizeof(line), "#line %d 0\n", versionLine + 1);
+        code.insert(lineEnd + 1, std::string(defines) + (defines[strlen(defines) - 1] == '\n' ? "" : "\n") + line);
+        return code;
+    }
+
     // Activate the shader
     void use() { 
+        if (pending) Finish();
         glUseProgram(ID); 
     }
     
-    // Utility uniform functions
-    void setBool(const std::string &name, bool value) const {         
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); 
+    // Utility uniform functions. Names are taken as C strings so the per-frame calls with
+    // literals do not build a std::string each; the std::string overloads are for composed names.
+    void setBool(const char *name, bool value) const {
+        glUniform1i(glGetUniformLocation(ID, name), (int)value);
+    }
+    void setInt(const char *name, int value) const {
+        glUniform1i(glGetUniformLocation(ID, name), value);
+    }
+    void setUInt(const char *name, unsigned int value) const {
+        glUniform1ui(glGetUniformLocation(ID, name), value);
+    }
+    void setFloat(const char *name, float value) const {
+        glUniform1f(glGetUniformLocation(ID, name), value);
     }
-    void setInt(const std::string &name, int value) const { 
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value); 
+    void setFloatArray(const char *name, const float *values, int count) const {
+        glUniform1fv(glGetUniformLocation(ID, name), count, values);
     }
-    void setFloat(const std::string &name, float value) const { 
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+    void setVec4Array(const char *name, const float *values, int count) const {
+        glUniform4fv(glGetUniformLocation(ID, name), count, values);
     }
-    void setVec3(const std::string &name, const glm::vec3 &value) const { 
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+    void setVec2(const char *name, float x, float y) const {
+        glUniform2f(glGetUniformLocation(ID, name), x, y);
     }
-    void setVec3(const std::string &name, float x, float y, float z) const { 
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z); 
+    void setVec3(const char *name, const glm::vec3 &value) const {
+        glUniform3fv(glGetUniformLocation(ID, name), 1, &value[0]);
     }
-    void setMat4(const std::string &name, const glm::mat4 &mat) const {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    void setVec3(const char *name, float x, float y, float z) const {
+        glUniform3f(glGetUniformLocation(ID, name), x, y, z);
     }
+    void setMat4(const char *name, const glm::mat4 &mat) const {
+        glUniformMatrix4fv(glGetUniformLocation(ID, name), 1, GL_FALSE, &mat[0][0]);
+    }
+    void setBool(const std::string &name, bool value) const { setBool(name.c_str(), value); }
+    void setInt(const std::string &name, int value) const { setInt(name.c_str(), value); }
+    void setUInt(const std::string &name, unsigned int value) const { setUInt(name.c_str(), value); }
+    void setFloat(const std::string &name, float value) const { setFloat(name.c_str(), value); }
+    void setVec3(const std::string &name, const glm::vec3 &value) const { setVec3(name.c_str(), value); }
+    void setVec3(const std::string &name, float x, float y, float z) const { setVec3(name.c_str(), x, y, z); }
+    void setMat4(const std::string &name, const glm::mat4 &mat) const { setMat4(name.c_str(), mat); }
 
 private:
+    static bool expandIncludes(const char *path, std::vector<std::string> &files, std::string &out) {
+        std::ifstream file(path);
+        if (!file) {
+            LOG_ERROR("Shader file not successfully read: %s", path);
+            return false;
+        }
+        int index = (int)files.size();
+        files.push_back(path);
+        std::string line;
+        char directive[32];
+        for (int number = 1; std::getline(file, line); number++) {
+            size_t start = line.find_first_not_of(" \t");
+            if (start == std::string::npos || line.compare(start, 8, "#include") != 0) { out += line; out += '\n'; continue; }
+            size_t open = line.find('"', start), close = open == std::string::npos ? open : line.find('"', open + 1);
+            if (close == std::string::npos) {
+                LOG_ERROR("%s:%d: malformed #include", path, number);
+                out += '\n';
+                continue;
+            }
+            std::string included = line.substr(open + 1, close - open - 1);
+            if (std::find(files.begin(), files.end(), included) == files.end()) {
+                snprintf(directive, sizeof(directive), "#line 1 %d\n", (int)files.size());
+                out += directive;
+                expandIncludes(included.c_str(), files, out);
+            }
+            snprintf(directive, sizeof(directive), "#line %d %d\n", number + 1, index);
+            out += directive;
+        }
+        return true;
+    }
+
+    std::string vertexPath, fragmentPath, defines; // for error messages
+    unsigned int vertex = 0, fragment = 0;
+    uint64_t cacheKey = 0;
+    bool pending = false, fromCache = false;
+
     // Utility function for checking shader compilation/linking errors.
-    void checkCompileErrors(unsigned int shader, std::string type) {
+    bool checkCompileErrors(unsigned int shader, const char *type, const char *path) {
         int success;
         char infoLog[1024];
-        if (type != "PROGRAM") {
+        const char *separator = defines.empty() ? "" : ", ";
+        if (strcmp(type, "PROGRAM") != 0) {
             glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
             if (!success) {
                 glGetShaderInfoLog(shader, 1024, NULL, infoLog);
-                std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+                LOG_ERROR("Shader compilation error of type %s (%s%s%s):\n%s", type, path, separator, defines.c_str(), infoLog);
             }
         }
         else {
             glGetProgramiv(shader, GL_LINK_STATUS, &success);
             if (!success) {
                 glGetProgramInfoLog(shader, 1024, NULL, infoLog);
-                std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+                LOG_ERROR("Program linking error of type %s (%s%s%s):\n%s", type, path, separator, defines.c_str(), infoLog);
             }
         }
+        return success != 0;
     }
 };
 #endif
\ No newline at end of file
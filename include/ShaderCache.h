@@ -0,0 +1,142 @@
+#ifndef SHADERCACHE_H
+#define SHADERCACHE_H
+
+#include <glad/glad.h>
+
+#include "Log.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// On-disk cache of linked program binaries (GL_ARB_get_program_binary), one file per program in
+// 'directory'. A program's key hashes its preprocessed sources together with the GL vendor,
+// renderer and version strings, so a driver update or another GPU simply misses. A binary the
+// driver rejects anyway (the format is opaque and may change under the same strings) is deleted
+// and the program compiled from source.
+// Also asks the driver for background compiler threads (GL_KHR_parallel_shader_compile), which
+// Shader relies on by issuing compiles up front and checking their status only on first use.
+// Get() must first be called with a GL context current; Shader does that.
+class ShaderCache {
+public:
+    bool enabled = true;
+    std::string directory = "shader_cache";
+
+    static ShaderCache& Get() {
+        static ShaderCache instance;
+        return instance;
+    }
+
+    bool Supported() const { return supported; }
+    bool ParallelCompile() const { return GLAD_GL_KHR_parallel_shader_compile != 0; }
+
+    uint64_t Key(const std::string &vertexCode, const std::string &fragmentCode) const {
+        uint64_t h = driverHash;
+        h = hash(h, vertexCode.data(), vertexCode.size());
+        h = hash(h, "\0", 1);
+        return hash(h, fragmentCode.data(), fragmentCode.size());
+    }
+
+    // Gives 'program' the cached binary for 'key'; false (nothing changed) on a miss or a rejected binary
+    bool Load(unsigned int program, uint64_t key) {
+        if (!enabled || !supported) return false;
+        std::string path = pathFor(key);
+        FILE *f = std::fopen(path.c_str(), "rb");
+        if (!f) { misses++; return false; }
+        Header header;
+        std::vector<char> binary;
+        bool ok = std::fread(&header, sizeof(header), 1, f) == 1 && header.magic == MAGIC && header.key == key && header.length > 0;
+        if (ok) {
+            binary.resize(header.length);
+            ok = std::fread(binary.data(), 1, binary.size(), f) == binary.size();
+        }
+        std::fclose(f);
+        GLint linked = GL_FALSE;
+        if (ok) {
+            glProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        }
+        if (!linked) {
+            LOG_WARN("Shader cache: %s rejected, compiling from source", path.c_str());
+            std::remove(path.c_str());
+            rejected++;
+            return false;
+        }
+        hits++;
+        return true;
+    }
+
+    // Call before linking a program that Store() will be given
+    void PrepareLink(unsigned int program) const {
+        if (enabled && supported) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    // Saves the binary of a successfully linked program
+    void Store(unsigned int program, uint64_t key) {
+        if (!enabled || !supported) return;
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) return;
+        std::vector<char> binary(length);
+        Header header;
+        header.key = key;
+        glGetProgramBinary(program, length, &length, &header.format, binary.data());
+        header.length = (uint32_t)length;
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        std::string path = pathFor(key);
+        FILE *f = std::fopen(path.c_str(), "wb");
+        if (!f) { LOG_WARN("Shader cache: cannot write %s", path.c_str()); return; }
+        bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1 && std::fwrite(binary.data(), 1, header.length, f) == header.length;
+        if (std::fclose(f) != 0 || !ok) { std::remove(path.c_str()); return; }
+        stores++;
+    }
+
+    unsigned int Hits() const { return hits; }
+    unsigned int Misses() const { return misses; }
+    unsigned int Rejected() const { return rejected; }
+    unsigned int Stores() const { return stores; }
+
+private:
+    static const uint32_t MAGIC = 0x42505347; // "GSPB"
+    struct Header {
+        uint32_t magic = MAGIC;
+        GLenum format = 0;
+        uint64_t key = 0;
+        uint32_t length = 0;
+        uint32_t reserved = 0;
+    };
+
+    bool supported = false;
+    uint64_t driverHash = 0;
+    unsigned int hits = 0, misses = 0, rejected = 0, stores = 0;
+
+    ShaderCache() {
+        const char *strings[] = { (const char*)glGetString(GL_VENDOR), (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION) };
+        driverHash = 14695981039346656037ull;
+        for (const char *s : strings) {
+            if (s) driverHash = hash(driverHash, s, std::char_traits<char>::length(s));
+            driverHash = hash(driverHash, "\0", 1);
+        }
+        GLint formats = 0;
+        if (GLAD_GL_ARB_get_program_binary) glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        supported = formats > 0;
+        if (GLAD_GL_KHR_parallel_shader_compile) glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu); // as many as the driver likes
+        LOG_INFO("Shader cache %s, parallel compile %s", supported ? "available" : "unavailable (no program binary formats)",
+            GLAD_GL_KHR_parallel_shader_compile ? "on" : "unavailable");
+    }
+
+    static uint64_t hash(uint64_t h, const char *data, size_t size) {
+        for (size_t i = 0; i < size; i++) h = (h ^ (unsigned char)data[i]) * 1099511628211ull;
+        return h;
+    }
+
+    std::string pathFor(uint64_t key) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/%016llx.bin", (unsigned long long)key);
+        return directory + name;
+    }
+};
+#endif
@@ -0,0 +1,122 @@
+#ifndef SHADERVARIANTS_H
+#define SHADERVARIANTS_H
+
+#include "Shader.h"
+#include "Profiler.h"
+#include "Log.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// Compile-time specialized versions of one vertex/fragment pair.
+// Each feature is a small unsigned field packed into a 32-bit key and reaches the GLSL as
+// "#define NAME value", so the shader picks code paths with #if instead of branching on uniforms.
+// Variants are compiled the first time Get() asks for them, or earlier with Prepare(), which only
+// issues the compile (see Shader) so many variants can build in parallel. Get() on a variant it
+// returned before is a short linear search and never allocates.
+//   ShaderVariants post("screen.vert", "screen.frag", { { "EFFECT", 3 } });
+//   post.Get(post.Field(0, effect)).use();
+struct ShaderFeature {
+    const char *name; // macro name
+    int bits;         // width of the value in the key
+};
+
+class ShaderVariants {
+public:
+    ShaderVariants(const char *vertexPath, const char *fragmentPath, std::initializer_list<ShaderFeature> features)
+        : vertexPath(vertexPath), fragmentPath(fragmentPath), features(features) {
+        int shift = 0;
+        for (const ShaderFeature &f : this->features) { shifts.push_back(shift); shift += f.bits; }
+        if (shift > 32) LOG_ERROR("%s: shader features need %d key bits, only 32 available", fragmentPath, shift);
+        variants.reserve(16);
+    }
+
+    ~ShaderVariants() { for (Variant &v : variants) delete v.shader; }
+
+    // 'value' of feature 'feature', positioned in the key; OR the fields of all features together
+    uint32_t Field(int feature, uint32_t value) const {
+        uint32_t mask = (1u << features[feature].bits) - 1;
+        if (value > mask) value = mask;
+        return value << shifts[feature];
+    }
+    uint32_t Value(uint32_t key, int feature) const { return (key >> shifts[feature]) & ((1u << features[feature].bits) - 1); }
+
+    // Sampler uniforms to point at texture units in every variant, when it is compiled
+    void BindSampler(const char *name, int unit) { samplers.push_back(Sampler{ name, unit }); }
+
+    // Starts building the variant without waiting for it
+    void Prepare(uint32_t key) {
+        for (Variant &v : variants) if (v.key == key) return;
+        issue(key);
+    }
+
+    Shader& Get(uint32_t key) {
+        for (Variant &v : variants) if (v.key == key) return v.configured ? *v.shader : configure(v);
+        return configure(issue(key));
+    }
+
+    // "#define NAME value" lines for 'key'
+    std::string Defines(uint32_t key) const {
+        std::string defines;
+        char line[96];
+        for (int i = 0; i < (int)features.size(); i++) {
+            snprintf(line, sizeof(line), "#define %s %u\n", features[i].name, Value(key, i));
+            defines += line;
+        }
+        return defines;
+    }
+
+    size_t Compiled() const { return variants.size(); }
+    // Finishes the prepared variants whose build is done (all of them when the driver cannot tell,
+    // see Shader::Ready()), so their binaries reach the cache before anything draws with them.
+    // Returns how many are still building.
+    size_t Collect() {
+        size_t pending = 0;
+        for (Variant &v : variants) {
+            if (v.configured) continue;
+            if (v.shader->Ready()) configure(v);
+            else pending++;
+        }
+        return pending;
+    }
+
+private:
+    struct Variant {
+        uint32_t key;
+        Shader *shader;
+        bool configured; // finished and given its samplers
+    };
+    struct Sampler {
+        const char *name;
+        int unit;
+    };
+
+    const char *vertexPath, *fragmentPath;
+    std::vector<ShaderFeature> features;
+    std::vector<int> shifts;
+    std::vector<Sampler> samplers;
+    std::vector<Variant> variants;
+
+    Variant& issue(uint32_t key) {
+        PROFILE_SCOPE("Shader variant compile");
+        std::string defines = Defines(key);
+        Shader *shader = new Shader(vertexPath, fragmentPath, defines.c_str());
+        variants.push_back(Variant{ key, shader, false });
+        char description[256] = "";
+        for (int i = 0, at = 0; i < (int)features.size() && at < (int)sizeof(description); i++)
+            at += snprintf(description + at, sizeof(description) - at, "%s%s=%u", i ? " " : "", features[i].name, Value(key, i));
+        LOG_DEBUG("%s variant %s: %s", fragmentPath, description, shader->FromCache() ? "cached binary" : "compiling");
+        return variants.back();
+    }
+
+    Shader& configure(Variant &v) {
+        v.shader->use(); // waits for the build
+        for (const Sampler &s : samplers) v.shader->setInt(s.name, s.unit);
+        v.configured = true;
+        return *v.shader;
+    }
+};
+#endif
@@ -0,0 +1,232 @@
+#ifndef SHADOWATLAS_H
+#define SHADOWATLAS_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// Point-light shadows share one square depth atlas: every shadowed light gets six square tiles,
+// the faces of a cube map, which stay where they are and keep their contents across frames.
+//  - Placement: lights are placed in order of importance (how much of the screen their range
+//    covers), each at the tile size its coverage asks for, or smaller when the atlas is full, or
+//    not at all. A light keeps its tiles until it wants a size two or more steps away from the
+//    one it was placed for, so sizes don't flip back and forth.
+//  - Caching: a face only needs rendering after it was placed, after its light moved, or after a
+//    caster moved inside it (Invalidate() with the caster's bounds before and after).
+//  - Budget: at most maxUpdates faces are rendered per frame, the stale faces of the most
+//    important lights first; a light that keeps waiting gains priority every frame. A light is
+//    only looked up once each of its faces has been rendered since it was placed.
+// Tiles come from a quadtree allocator over the atlas (sizes are powers of two), which merges
+// free siblings back as tiles are released. Only bookkeeping here: the renderer draws the faces.
+class ShadowAtlas {
+public:
+    static constexpr int FACES = 6;      // +X, -X, +Y, -Y, +Z, -Z, the cube map order
+    static constexpr int MAX_LIGHTS = 32;
+
+    struct Tile { int x = 0, y = 0, size = 0; }; // texels; size 0 = no tile
+
+    int maxUpdates = 6; // faces rendered per frame at most
+
+    // Atlas and tile sizes in texels, powers of two. Drops every placement.
+    void Init(int atlasSize, int maxTileSize, int minTileSize) {
+        size = atlasSize;
+        maxTile = std::min(maxTileSize, atlasSize);
+        minTile = std::min(minTileSize, maxTile);
+        levels = 0;
+        while ((size >> levels) > minTile) levels++;
+        freeTiles.assign(levels + 1, std::vector<Tile>());
+        for (int level = 0; level <= levels; level++) freeTiles[level].reserve(std::min(1 << (2 * level), 4096));
+        Tile whole; whole.size = size;
+        freeTiles[0].push_back(whole);
+        for (Light &l : lights) l = Light();
+        count = 0;
+    }
+
+    int Size() const { return size; }
+    int Lights() const { return count; }
+    int LastUpdates() const { return lastUpdates; }
+    bool Ready(int light) const { return lights[light].tileSize > 0 && lights[light].rendered == ALL_FACES; }
+    const Tile& FaceTile(int light, int face) const { return lights[light].tiles[face]; }
+    int TileSize(int light) const { return lights[light].tileSize; }
+
+    // The view of a face, matching the face basis shadow.glsl selects with the major axis
+    static glm::mat4 FaceView(const glm::vec3 &position, int face) {
+        static const glm::vec3 forward[FACES] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+        static const glm::vec3 up[FACES] = { { 0, -1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }, { 0, -1, 0 }, { 0, -1, 0 } };
+        return glm::lookAt(position, position + forward[face], up[face]);
+    }
+
+    // A sphere 'd' from the light is inside the face's 90 degree pyramid, or less than 'radius' outside one of its side planes
+    static bool SphereInFace(const glm::vec3 &d, float radius, int face) {
+        int axis = face / 2;
+        float forward = face % 2 ? -d[axis] : d[axis];
+        for (int k = 1; k <= 2; k++) {
+            float side = d[(axis + k) % 3];
+            // Planes through the light at 45 degrees: outward normals (+-1, -1) / sqrt(2)
+            if ((side - forward) * 0.70710678f > radius || (-side - forward) * 0.70710678f > radius) return false;
+        }
+        return true;
+    }
+
+    // Once per frame, before Invalidate() and Schedule(): the lights to shadow, with the fraction
+    // of the screen their range covers (0..1) and the range they are rendered out to
+    void Place(int lightCount, const glm::vec3 *positions, const float *coverage, float range) {
+        lightCount = std::min(std::max(lightCount, 0), MAX_LIGHTS);
+        for (int i = lightCount; i < count; i++) release(lights[i]);
+        count = lightCount;
+        int order[MAX_LIGHTS];
+        for (int i = 0; i < count; i++) {
+            Light &l = lights[i];
+            if (l.position != positions[i] || l.range != range) {
+                l.position = positions[i];
+                l.range = range;
+                l.dirty = ALL_FACES;
+            }
+            l.coverage = std::min(std::max(coverage[i], 0.0f), 1.0f);
+            // Against the size asked for at placement, which the tiles may be smaller than when the atlas was full
+            int wanted = tileFor(l.coverage);
+            if (l.tileSize && (wanted >= 4 * l.placedFor || 4 * wanted <= l.placedFor)) release(l);
+            l.stale = l.dirty ? l.stale + 1 : 0;
+            order[i] = i;
+        }
+        std::sort(order, order + count, [this](int a, int b) { return lights[a].coverage > lights[b].coverage; });
+        for (int i = 0; i < count; i++) {
+            Light &l = lights[order[i]];
+            if (l.tileSize) continue;
+            int wanted = tileFor(l.coverage);
+            for (int s = wanted; s >= minTile && !l.tileSize; s /= 2) place(l, s);
+            if (l.tileSize) l.placedFor = wanted;
+        }
+    }
+
+    // A caster's bounding sphere, where it was or where it is now: the faces it touches go stale
+    void Invalidate(const glm::vec3 &center, float radius) {
+        for (int i = 0; i < count; i++) {
+            Light &l = lights[i];
+            if (!l.tileSize || l.dirty == ALL_FACES) continue;
+            glm::vec3 d = center - l.position;
+            if (glm::dot(d, d) > (l.range + radius) * (l.range + radius)) continue;
+            for (int face = 0; face < FACES; face++)
+                if (SphereInFace(d, radius, face)) l.dirty |= 1 << face;
+        }
+    }
+
+    void InvalidateAll() {
+        for (int i = 0; i < count; i++) lights[i].dirty = ALL_FACES;
+    }
+
+    // The faces to render this frame (at most maxUpdates), which count as current from here on
+    int Schedule(int *lightOut, int *faceOut) {
+        int n = 0;
+        while (n < maxUpdates) {
+            int best = -1;
+            float bestPriority = -1.0f;
+            for (int i = 0; i < count; i++) {
+                const Light &l = lights[i];
+                if (!l.tileSize || !l.dirty) continue;
+                // Lights not shown yet go first, then coverage weighted by how long they waited
+                float priority = (l.rendered != ALL_FACES ? 1e6f : 0.0f) + (l.coverage + 0.01f) * (float)(1 + l.stale);
+                if (priority > bestPriority) { best = i; bestPriority = priority; }
+            }
+            if (best < 0) break;
+            Light &l = lights[best];
+            for (int face = 0; face < FACES && n < maxUpdates; face++) {
+                if (!(l.dirty & (1 << face))) continue;
+                lightOut[n] = best; faceOut[n] = face; n++;
+                l.dirty &= ~(1 << face);
+                l.rendered |= 1 << face;
+            }
+            if (!l.dirty) l.stale = 0;
+        }
+        lastUpdates = n;
+        return n;
+    }
+
+private:
+    static constexpr int ALL_FACES = (1 << FACES) - 1;
+
+    struct Light {
+        glm::vec3 position = glm::vec3(0.0f);
+        float range = -1.0f;
+        float coverage = 0.0f;
+        int placedFor = 0;          // tile size asked for when placed
+        int tileSize = 0;           // 0 = not in the atlas
+        Tile tiles[FACES];
+        int dirty = 0;              // faces to render (bit per face)
+        int rendered = 0;           // faces rendered since the tiles were placed
+        int stale = 0;              // frames some face has been waiting
+    };
+
+    int size = 0, maxTile = 0, minTile = 0, levels = 0;
+    std::vector<std::vector<Tile>> freeTiles; // per level, level 0 = the whole atlas
+    Light lights[MAX_LIGHTS];
+    int count = 0, lastUpdates = 0;
+
+    int tileFor(float coverage) const {
+        int s = maxTile;
+        while (s > minTile && coverage * maxTile <= s / 2) s /= 2;
+        return s;
+    }
+
+    int levelOf(int tileSize) const {
+        int level = 0;
+        while ((size >> level) > tileSize) level++;
+        return level;
+    }
+
+    void place(Light &l, int tileSize) {
+        for (int face = 0; face < FACES; face++) {
+            if (allocate(tileSize, l.tiles[face])) continue;
+            for (int f = 0; f < face; f++) free(l.tiles[f]);
+            return;
+        }
+        l.tileSize = tileSize;
+        l.dirty = ALL_FACES;
+        l.rendered = 0;
+    }
+
+    void release(Light &l) {
+        if (!l.tileSize) return;
+        for (int face = 0; face < FACES; face++) free(l.tiles[face]);
+        l.tileSize = 0;
+        l.rendered = 0;
+    }
+
+    bool allocate(int tileSize, Tile &out) {
+        int level = levelOf(tileSize), from = level;
+        while (from >= 0 && freeTiles[from].empty()) from--;
+        if (from < 0) return false;
+        Tile t = freeTiles[from].back();
+        freeTiles[from].pop_back();
+        // Split down to the size asked for, keeping the lower left quarter each time
+        for (; from < level; from++) {
+            int half = t.size / 2;
+            Tile q; q.size = half;
+            q.x = t.x + half; q.y = t.y;        freeTiles[from + 1].push_back(q);
+            q.x = t.x;        q.y = t.y + half; freeTiles[from + 1].push_back(q);
+            q.x = t.x + half; q.y = t.y + half; freeTiles[from + 1].push_back(q);
+            t.size = half;
+        }
+        out = t;
+        return true;
+    }
+
+    // Returns a tile, merged with its three siblings into their parent while they are all free
+    void free(Tile t) {
+        for (int level = levelOf(t.size); level > 0; level--) {
+            std::vector<Tile> &list = freeTiles[level];
+            int parent = t.size * 2;
+            int px = t.x - t.x % parent, py = t.y - t.y % parent;
+            int found[3], n = 0;
+            for (int i = 0; i < (int)list.size() && n < 3; i++)
+                if (list[i].x - list[i].x % parent == px && list[i].y - list[i].y % parent == py) found[n++] = i;
+            if (n < 3) { list.push_back(t); return; }
+            for (int k = 2; k >= 0; k--) { list[found[k]] = list.back(); list.pop_back(); }
+            t.x = px; t.y = py; t.size = parent;
+        }
+        freeTiles[0].push_back(t);
+    }
+};
+#endif
@@ -0,0 +1,319 @@
+#ifndef SYNCSTALLDETECTOR_H
+#define SYNCSTALLDETECTOR_H
+
+#include <glad/glad.h>
+#include "Profiler.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#if defined(__GLIBC__)
+#include <execinfo.h>
+#endif
+
+// Debug mode that times GL entry points known to synchronize the CPU with the driver or GPU.
+//  - SetEnabled(true) points the glad entry points in SYNC_STALL_CALLS at the wrappers below
+//    (on top of the ENGINE_GL_STATS wrappers, if installed); disabled, nothing is wrapped.
+//    Toggle it between frames, not while a FrameCapture is recording.
+//  - Each call is keyed by entry point, the innermost profiler zone and the return address of
+//    the caller, and the CPU time spent inside it is accumulated for the frame.
+//  - Calls that provably cannot wait are not counted: readbacks into a pack buffer, query
+//    results that are already available, and anything inside an Ignore scope.
+// Calls made through other loaders (ImGui's backend) are not seen.
+#define SYNC_STALL_CALLS(X) \
+    X(Finish) X(ReadPixels) X(GetTexImage) X(GetBufferSubData) \
+    X(GetQueryObjectiv) X(GetQueryObjectuiv) X(GetQueryObjecti64v) X(GetQueryObjectui64v) \
+    X(MapBuffer) X(MapBufferRange) X(ClientWaitSync) \
+    X(GetIntegerv) X(GetFloatv) X(GetBooleanv) X(GetError) \
+    X(GetUniformLocation) X(GetAttribLocation) X(CheckFramebufferStatus) X(GetProgramiv) X(GetShaderiv)
+
+enum SyncCall {
+#define SYNC_STALL_ENUM(name) SYNC_##name,
+    SYNC_STALL_CALLS(SYNC_STALL_ENUM)
+#undef SYNC_STALL_ENUM
+    SYNC_CALL_COUNT
+};
+
+// How bad a call is: a round trip to the driver (and its thread, on threaded drivers) versus
+// waiting for the GPU to finish earlier work
+enum SyncLevel { SYNC_ROUNDTRIP = 0, SYNC_BLOCKING = 1 };
+
+inline const char* SyncCallName(int call) {
+    static const char *names[] = {
+#define SYNC_STALL_NAME(name) "gl" #name,
+        SYNC_STALL_CALLS(SYNC_STALL_NAME)
+#undef SYNC_STALL_NAME
+    };
+    return call >= 0 && call < SYNC_CALL_COUNT ? names[call] : "unknown";
+}
+
+#if defined(__GNUC__)
+#define SYNC_CALL_SITE() __builtin_return_address(0)
+#else
+#define SYNC_CALL_SITE() ((void*)0)
+#endif
+
+class SyncStallDetector {
+public:
+    struct Site {
+        SyncCall call;
+        SyncLevel level;
+        const void *address;
+        const char *zone;   // innermost profiler zone, may be null
+        std::string symbol; // resolved once, when the site is first seen
+        // Last completed frame
+        uint32_t frameCalls = 0;
+        uint64_t frameNs = 0, frameMaxNs = 0;
+        // Since enabled
+        uint64_t calls = 0, totalNs = 0, maxNs = 0, frames = 0;
+    };
+
+    // Calls made while an Ignore is alive on the thread are not recorded (the detector's users'
+    // own deliberate waits, e.g. the benchmark's glFinish)
+    struct Ignore {
+        Ignore() { ignoreDepth()++; }
+        ~Ignore() { ignoreDepth()--; }
+    };
+
+    static SyncStallDetector& Get() {
+        static SyncStallDetector instance;
+        return instance;
+    }
+
+    void SetEnabled(bool on) {
+        if (on == enabled) return;
+        if (on) {
+#define SYNC_STALL_INSTALL(name) real.name = glad_gl##name; glad_gl##name = sync_##name;
+            SYNC_STALL_CALLS(SYNC_STALL_INSTALL)
+#undef SYNC_STALL_INSTALL
+            sites.clear();
+            pending.clear();
+            lastSite = loggedSites = 0;
+            lastFrameNs = 0;
+        } else {
+#define SYNC_STALL_RESTORE(name) glad_gl##name = real.name;
+            SYNC_STALL_CALLS(SYNC_STALL_RESTORE)
+#undef SYNC_STALL_RESTORE
+        }
+        enabled = on;
+    }
+    bool Enabled() const { return enabled; }
+
+    // Closes the frame: moves this frame's numbers into the Site::frame* fields and logs new
+    // call sites and frames that spent more than logThresholdMs blocked
+    void EndFrame() {
+        if (!enabled) return;
+        uint64_t frameNs = 0;
+        const Site *worst = nullptr;
+        for (size_t i = 0; i < sites.size(); i++) {
+            Site &s = sites[i];
+            s.frameCalls = pending[i].calls; s.frameNs = pending[i].ns; s.frameMaxNs = pending[i].maxNs;
+            pending[i] = Pending();
+            if (!s.frameCalls) continue;
+            s.frames++;
+            frameNs += s.frameNs;
+            if (!worst || s.frameNs > worst->frameNs) worst = &s;
+        }
+        lastFrameNs = frameNs;
+        for (size_t i = loggedSites; i < sites.size(); i++) {
+            const Site &s = sites[i];
+            LOG_WARN("GL sync call: %s (%s) in '%s' at %s", SyncCallName(s.call), s.level == SYNC_BLOCKING ? "blocking" : "round trip",
+                s.zone ? s.zone : "-", s.symbol.c_str());
+        }
+        loggedSites = sites.size();
+        if (worst && frameNs / 1e6 >= logThresholdMs)
+            LOG_WARN("Frame %llu: %.2f ms in GL sync calls, worst %s in '%s' (%u calls, %.2f ms)", (unsigned long long)Profiler::Get().FrameIndex(),
+                frameNs / 1e6, SyncCallName(worst->call), worst->zone ? worst->zone : "-", worst->frameCalls, worst->frameNs / 1e6);
+    }
+
+    // All sites seen since enabled; frame* fields describe the last EndFrame()
+    const std::vector<Site>& Sites() const { return sites; }
+    double LastFrameMs() const { return lastFrameNs / 1e6; }
+
+    float logThresholdMs = 1.0f;
+
+private:
+    struct RealCalls {
+#define SYNC_STALL_POINTER(name) decltype(glad_gl##name) name;
+        SYNC_STALL_CALLS(SYNC_STALL_POINTER)
+#undef SYNC_STALL_POINTER
+    };
+    // Running totals of the current frame, parallel to 'sites'
+    struct Pending {
+        uint32_t calls = 0;
+        uint64_t ns = 0, maxNs = 0;
+    };
+
+    RealCalls real;
+    bool enabled = false;
+    std::vector<Site> sites;
+    std::vector<Pending> pending;
+    size_t lastSite = 0, loggedSites = 0;
+    uint64_t lastFrameNs = 0;
+
+    SyncStallDetector() {}
+
+    static int& ignoreDepth() {
+        thread_local int d = 0;
+        return d;
+    }
+
+    static std::string symbolize(const void *address) {
+        char text[32];
+        snprintf(text, sizeof(text), "%p", address);
+#if defined(__GLIBC__)
+        // "binary(function+offset) [address]"; without -rdynamic only "binary(+offset)", which addr2line resolves
+        void *frames[1] = { const_cast<void*>(address) };
+        if (char **names = backtrace_symbols(frames, 1)) {
+            std::string s = names[0];
+            free(names);
+            return s;
+        }
+#endif
+        return text;
+    }
+
+    // Consecutive calls usually come from the same site, so the last hit is tried first
+    void record(SyncCall call, SyncLevel level, const void *address, uint64_t ns) {
+        if (ignoreDepth() > 0) return;
+        const char *zone = Profiler::CurrentZone();
+        size_t i = lastSite;
+        if (i >= sites.size() || sites[i].call != call || sites[i].level != level || sites[i].address != address || sites[i].zone != zone) {
+            for (i = 0; i < sites.size(); i++)
+                if (sites[i].call == call && sites[i].level == level && sites[i].address == address && sites[i].zone == zone) break;
+            if (i == sites.size()) {
+                Site s;
+                s.call = call; s.level = level; s.address = address; s.zone = zone;
+                s.symbol = symbolize(address);
+                sites.push_back(s);
+                pending.resize(sites.size());
+            }
+            lastSite = i;
+        }
+        Site &s = sites[i];
+        Pending &p = pending[i];
+        p.calls++; p.ns += ns; p.maxNs = std::max(p.maxNs, ns);
+        s.calls++; s.totalNs += ns; s.maxNs = std::max(s.maxNs, ns);
+    }
+
+    // Times the wrapped call from construction to the end of the wrapper
+    struct Timed {
+        SyncCall call; SyncLevel level; const void *address; uint64_t start;
+        Timed(SyncCall call, SyncLevel level, const void *address) : call(call), level(level), address(address), start(Profiler::Now()) {}
+        ~Timed() { Get().record(call, level, address, Profiler::Now() - start); }
+    };
+
+    static bool packBufferBound() { GLint b = 0; Get().real.GetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &b); return b != 0; }
+    // Asking for a query result only waits if the GPU has not produced it yet
+    static bool queryPending(GLuint id, GLenum pname) {
+        if (pname != GL_QUERY_RESULT) return false;
+        GLint available = 0;
+        Get().real.GetQueryObjectiv(id, GL_QUERY_RESULT_AVAILABLE, &available);
+        return !available;
+    }
+
+    // --- Wrappers; SYNC_CALL_SITE() must be taken here, in the function the engine called ---
+
+    static void APIENTRY sync_Finish() {
+        Timed t(SYNC_Finish, SYNC_BLOCKING, SYNC_CALL_SITE());
+        Get().real.Finish();
+    }
+    static void APIENTRY sync_ReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels) {
+        SyncStallDetector &d = Get();
+        if (packBufferBound()) { d.real.ReadPixels(x, y, width, height, format, type, pixels); return; } // asynchronous copy
+        Timed t(SYNC_ReadPixels, SYNC_BLOCKING, SYNC_CALL_SITE());
+        d.real.ReadPixels(x, y, width, height, format, type, pixels);
+    }
+    static void APIENTRY sync_GetTexImage(GLenum target, GLint level, GLenum format, GLenum type, void *pixels) {
+        SyncStallDetector &d = Get();
+        if (packBufferBound()) { d.real.GetTexImage(target, level, format, type, pixels); return; }
+        Timed t(SYNC_GetTexImage, SYNC_BLOCKING, SYNC_CALL_SITE());
+        d.real.GetTexImage(target, level, format, type, pixels);
+    }
+    static void APIENTRY sync_GetBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, void *data) {
+        Timed t(SYNC_GetBufferSubData, SYNC_BLOCKING, SYNC_CALL_SITE());
+        Get().real.GetBufferSubData(target, offset, size, data);
+    }
+    static void APIENTRY sync_GetQueryObjectiv(GLuint id, GLenum pname, GLint *params) {
+        SyncStallDetector &d = Get();
+        if (!queryPending(id, pname)) { d.real.GetQueryObjectiv(id, pname, params); return; }
+        Timed t(SYNC_GetQueryObjectiv, SYNC_BLOCKING, SYNC_CALL_SITE());
+        d.real.GetQueryObjectiv(id, pname, params);
+    }
+    static void APIENTRY sync_GetQueryObjectuiv(GLuint id, GLenum pname, GLuint *params) {
+        SyncStallDetector &d = Get();
+        if (!queryPending(id, pname)) { d.real.GetQueryObjectuiv(id, pname, params); return; }
+        Timed t(SYNC_GetQueryObjectuiv, SYNC_BLOCKING, SYNC_CALL_SITE());
+        d.real.GetQueryObjectuiv(id, pname, params);
+    }
+    static void APIENTRY sync_GetQueryObjecti64v(GLuint id, GLenum pname, GLint64 *params) {
+        SyncStallDetector &d = Get();
+        if (!queryPending(id, pname)) { d.real.GetQueryObjecti64v(id, pname, params); return; }
+        Timed t(SYNC_GetQueryObjecti64v, SYNC_BLOCKING, SYNC_CALL_SITE());
+        d.real.GetQueryObjecti64v(id, pname, params);
+    }
+    static void APIENTRY sync_GetQueryObjectui64v(GLuint id, GLenum pname, GLuint64 *params) {
+        SyncStallDetector &d = Get();
+        if (!queryPending(id, pname)) { d.real.GetQueryObjectui64v(id, pname, params); return; }
+        Timed t(SYNC_GetQueryObjectui64v, SYNC_BLOCKING, SYNC_CALL_SITE());
+        d.real.GetQueryObjectui64v(id, pname, params);
+    }
+    // Mapping waits for pending GPU access to the buffer unless the caller opts out
+    static void* APIENTRY sync_MapBuffer(GLenum target, GLenum access) {
+        Timed t(SYNC_MapBuffer, SYNC_BLOCKING, SYNC_CALL_SITE());
+        return Get().real.MapBuffer(target, access);
+    }
+    static void* APIENTRY sync_MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+        SyncStallDetector &d = Get();
+        if (access & GL_MAP_UNSYNCHRONIZED_BIT) return d.real.MapBufferRange(target, offset, length, access);
+        Timed t(SYNC_MapBufferRange, SYNC_BLOCKING, SYNC_CALL_SITE());
+        return d.real.MapBufferRange(target, offset, length, access);
+    }
+    // A zero timeout only polls (and may flush)
+    static GLenum APIENTRY sync_ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+        Timed t(SYNC_ClientWaitSync, timeout > 0 ? SYNC_BLOCKING : SYNC_ROUNDTRIP, SYNC_CALL_SITE());
+        return Get().real.ClientWaitSync(sync, flags, timeout);
+    }
+    static void APIENTRY sync_GetIntegerv(GLenum pname, GLint *data) {
+        Timed t(SYNC_GetIntegerv, SYNC_ROUNDTRIP, SYNC_CALL_SITE());
+        Get().real.GetIntegerv(pname, data);
+    }
+    static void APIENTRY sync_GetFloatv(GLenum pname, GLfloat *data) {
+        Timed t(SYNC_GetFloatv, SYNC_ROUNDTRIP, SYNC_CALL_SITE());
+        Get().real.GetFloatv(pname, data);
+    }
+    static void APIENTRY sync_GetBooleanv(GLenum pname, GLboolean *data) {
+        Timed t(SYNC_GetBooleanv, SYNC_ROUNDTRIP, SYNC_CALL_SITE());
+        Get().real.GetBooleanv(pname, data);
+    }
+    static GLenum APIENTRY sync_GetError() {
+        Timed t(SYNC_GetError, SYNC_ROUNDTRIP, SYNC_CALL_SITE());
+        return Get().real.GetError();
+    }
+    static GLint APIENTRY sync_GetUniformLocation(GLuint program, const GLchar *name) {
+        Timed t(SYNC_GetUniformLocation, SYNC_ROUNDTRIP, SYNC_CALL_SITE());
+        return Get().real.GetUniformLocation(program, name);
+    }
+    static GLint APIENTRY sync_GetAttribLocation(GLuint program, const GLchar *name) {
+        Timed t(SYNC_GetAttribLocation, SYNC_ROUNDTRIP, SYNC_CALL_SITE());
+        return Get().real.GetAttribLocation(program, name);
+    }
+    static GLenum APIENTRY sync_CheckFramebufferStatus(GLenum target) {
+        Timed t(SYNC_CheckFramebufferStatus, SYNC_ROUNDTRIP, SYNC_CALL_SITE());
+        return Get().real.CheckFramebufferStatus(target);
+    }
+    // Status queries wait for the (possibly background) compile or link to finish
+    static void APIENTRY sync_GetProgramiv(GLuint program, GLenum pname, GLint *params) {
+        Timed t(SYNC_GetProgramiv, SYNC_ROUNDTRIP, SYNC_CALL_SITE());
+        Get().real.GetProgramiv(program, pname, params);
+    }
+    static void APIENTRY sync_GetShaderiv(GLuint shader, GLenum pname, GLint *params) {
+        Timed t(SYNC_GetShaderiv, SYNC_ROUNDTRIP, SYNC_CALL_SITE());
+        Get().real.GetShaderiv(shader, pname, params);
+    }
+};
+#endif
@@ -3,7 +3,7 @@
 
 #include <glad/glad.h>
 #include "stb_image.h"
-#include <iostream>
+#include "Log.h"
 
 class Texture {
 public:
@@ -39,7 +39,7 @@ public:
             stbi_image_free(data);
         }
         else {
-            std::cout << "Texture failed to load at path: " << path << std::endl;
+            LOG_WARN("Texture failed to load at path: %s", path);
             stbi_image_free(data);
         }
     }
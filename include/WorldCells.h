@@ -0,0 +1,121 @@
+#ifndef WORLDCELLS_H
+#define WORLDCELLS_H
+
+#include "SceneFile.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <cmath>
+#include <cstdint>
+
+// On-disk layout of a partitioned world: a directory holding one binary scene per grid cell
+// (cells are square in XZ, unbounded in Y) plus a small text index listing the non-empty cells.
+//
+//   world.index:   WORLD_PARTITION 1
+//                  <cellSize>
+//                  <cellCount>
+//                  <x> <z> <objectCount> <file>     one line per cell
+
+const char* const WORLD_INDEX_FILE = "world.index";
+
+struct WorldCellInfo {
+    int x = 0, z = 0;
+    uint32_t objectCount = 0;
+    std::string file; // relative to the world directory
+};
+
+struct WorldIndex {
+    float cellSize = 32.0f;
+    std::vector<WorldCellInfo> cells;
+};
+
+inline int64_t WorldCellKey(int x, int z) {
+    return (int64_t)(((uint64_t)(uint32_t)x << 32) | (uint32_t)z);
+}
+
+inline int WorldCellCoord(float v, float cellSize) {
+    return (int)std::floor(v / cellSize);
+}
+
+inline std::string WorldCellFileName(int x, int z) {
+    return "cell_" + std::to_string(x) + "_" + std::to_string(z) + ".scene";
+}
+
+inline bool ReadWorldIndex(const std::string &dir, WorldIndex &index) {
+    std::ifstream in(dir + "/" + WORLD_INDEX_FILE);
+    if (!in.is_open()) return false;
+    std::string tag; int version = 0;
+    in >> tag >> version;
+    if (tag != "WORLD_PARTITION" || version != 1) return false;
+    size_t count = 0;
+    in >> index.cellSize >> count;
+    if (!in || index.cellSize <= 0.0f) return false;
+    index.cells.clear();
+    index.cells.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        WorldCellInfo cell;
+        if (!(in >> cell.x >> cell.z >> cell.objectCount >> cell.file)) return false;
+        index.cells.push_back(cell);
+    }
+    return true;
+}
+
+inline bool WriteWorldIndex(const std::string &dir, const WorldIndex &index) {
+    std::ofstream out(dir + "/" + WORLD_INDEX_FILE);
+    if (!out.is_open()) return false;
+    out << "WORLD_PARTITION 1\n" << index.cellSize << "\n" << index.cells.size() << "\n";
+    for (const WorldCellInfo &cell : index.cells)
+        out << cell.x << " " << cell.z << " " << cell.objectCount << " " << cell.file << "\n";
+    return out.good();
+}
+
+// Splits a scene into per-cell binary scenes inside 'dir' (which must exist) and writes the index.
+// Root objects are bucketed by position; children stay in their root's cell with their parent
+// indices remapped (parents still precede children), so local transforms keep their meaning.
+// Point lights go to the cell containing them. Each cell gets its own string and asset tables.
+inline bool PartitionScene(const SceneView &scene, float cellSize, const std::string &dir, WorldIndex &index) {
+    struct Bucket { std::vector<uint32_t> objects; std::vector<uint32_t> lights; };
+    std::map<int64_t, Bucket> buckets;
+    std::vector<int64_t> objectCell(scene.objectCount);
+    for (uint32_t i = 0; i < scene.objectCount; i++) {
+        uint32_t parent = scene.Parent(i);
+        const glm::vec3 &p = scene.transforms[i].position;
+        objectCell[i] = parent == SCENE_NO_PARENT ? WorldCellKey(WorldCellCoord(p.x, cellSize), WorldCellCoord(p.z, cellSize)) : objectCell[parent];
+        buckets[objectCell[i]].objects.push_back(i);
+    }
+    for (uint32_t i = 0; i < scene.lightCount; i++) {
+        const glm::vec3 &p = scene.lights[i].position;
+        buckets[WorldCellKey(WorldCellCoord(p.x, cellSize), WorldCellCoord(p.z, cellSize))].lights.push_back(i);
+    }
+
+    index.cellSize = cellSize;
+    index.cells.clear();
+    std::vector<uint32_t> cellIndex(scene.objectCount, SCENE_NO_PARENT); // object -> index inside its cell
+    for (std::map<int64_t, Bucket>::const_iterator it = buckets.begin(); it != buckets.end(); ++it) {
+        const Bucket &bucket = it->second;
+
+        WorldCellInfo cell;
+        cell.x = (int)(int32_t)(uint32_t)((uint64_t)it->first >> 32);
+        cell.z = (int)(int32_t)(uint32_t)(uint64_t)it->first;
+        cell.objectCount = (uint32_t)bucket.objects.size();
+        cell.file = WorldCellFileName(cell.x, cell.z);
+
+        SceneData data;
+        data.Reserve(bucket.objects.size());
+        data.sunDirection = scene.sunDirection;
+        data.sunColor = scene.sunColor;
+        for (uint32_t i : bucket.objects) {
+            uint32_t asset = scene.assets[i] < scene.assetCount ? data.AddAsset(scene.String(scene.assetPaths[scene.assets[i]])) : SCENE_NO_ASSET;
+            uint32_t parent = scene.Parent(i);
+            cellIndex[i] = (uint32_t)data.names.size();
+            data.AddObject(scene.String(scene.names[i]), asset, scene.transforms[i], parent == SCENE_NO_PARENT ? SCENE_NO_PARENT : cellIndex[parent]);
+        }
+        for (uint32_t i : bucket.lights) data.lights.push_back(scene.lights[i]);
+        if (!WriteSceneBinary((dir + "/" + cell.file).c_str(), data.View())) return false;
+        index.cells.push_back(cell);
+    }
+    return WriteWorldIndex(dir, index);
+}
+#endif
@@ -0,0 +1,264 @@
+#ifndef WORLDPARTITION_H
+#define WORLDPARTITION_H
+
+#include "WorldCells.h"
+#include "GameObject.h"
+#include "Model.h"
+#include "Shader.h"
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+// Streams the cells of a partitioned world (see WorldCells.h) around the camera.
+// A loader thread reads cell files and imports their models (Assimp, BVH build, image decode);
+// finished cells are handed back to the GL thread, which uploads new models a few per frame and
+// makes the cell visible. Cells that leave the streaming radius stay cached until the memory
+// budget is exceeded and are then evicted least-recently-used first.
+class WorldPartition {
+public:
+    float streamingRadius = 64.0f;
+    size_t memoryBudget = (size_t)256 << 20;
+    int uploadsPerFrame = 2; // cells made resident per Update()
+
+    ~WorldPartition() { Close(); }
+
+    bool Open(const std::string &dir) {
+        Close();
+        WorldIndex loaded;
+        if (!ReadWorldIndex(dir, loaded)) return false;
+        index = loaded;
+        directory = dir;
+        cellLookup.clear();
+        for (unsigned int i = 0; i < index.cells.size(); i++)
+            cellLookup[WorldCellKey(index.cells[i].x, index.cells[i].z)] = i;
+        stopping = false;
+        worker = std::thread(&WorldPartition::loaderThread, this);
+        return true;
+    }
+
+    void Close() {
+        if (worker.joinable()) {
+            { std::lock_guard<std::mutex> lock(mutex); stopping = true; requests.clear(); }
+            wake.notify_all();
+            worker.join();
+        }
+        completed.clear();
+        resident.clear(); // drops the last model references, releasing their GL objects
+        requested.clear();
+        wanted.clear();
+        index.cells.clear();
+        cellLookup.clear();
+        directory.clear();
+    }
+
+    bool IsOpen() const { return !directory.empty(); }
+
+    // Call once per frame on the GL thread
+    void Update(const glm::vec3 &cameraPos) {
+        if (!IsOpen()) return;
+        frame++;
+
+        // 1. Cells overlapping the streaming circle, nearest first
+        std::vector<std::pair<float, int64_t>> inRange;
+        int x0 = WorldCellCoord(cameraPos.x - streamingRadius, index.cellSize), x1 = WorldCellCoord(cameraPos.x + streamingRadius, index.cellSize);
+        int z0 = WorldCellCoord(cameraPos.z - streamingRadius, index.cellSize), z1 = WorldCellCoord(cameraPos.z + streamingRadius, index.cellSize);
+        for (int z = z0; z <= z1; z++) {
+            for (int x = x0; x <= x1; x++) {
+                int64_t key = WorldCellKey(x, z);
+                if (cellLookup.find(key) == cellLookup.end()) continue;
+                float dx = std::max(std::max(x * index.cellSize - cameraPos.x, cameraPos.x - (x + 1) * index.cellSize), 0.0f);
+                float dz = std::max(std::max(z * index.cellSize - cameraPos.z, cameraPos.z - (z + 1) * index.cellSize), 0.0f);
+                float dist2 = dx * dx + dz * dz;
+                if (dist2 <= streamingRadius * streamingRadius) inRange.push_back(std::make_pair(dist2, key));
+            }
+        }
+        std::sort(inRange.begin(), inRange.end());
+
+        // 2. Touch resident cells, request missing ones
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            wanted.clear();
+            for (unsigned int i = 0; i < inRange.size(); i++) {
+                int64_t key = inRange[i].second;
+                wanted.insert(key);
+                std::map<int64_t, std::unique_ptr<Cell>>::iterator it = resident.find(key);
+                if (it != resident.end()) it->second->lastUsed = frame;
+                else if (requested.insert(key).second) requests.push_back(key);
+            }
+        }
+        wake.notify_one();
+
+        // 3. Upload finished cells, a few per frame so streaming never causes a hitch
+        for (int n = 0; n < uploadsPerFrame; n++) {
+            std::unique_ptr<Cell> cell;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (completed.empty()) break;
+                cell = std::move(completed.front());
+                completed.pop_front();
+            }
+            requested.erase(cell->key);
+            if (cell->skipped) { n--; continue; }
+            for (unsigned int i = 0; i < cell->models.size(); i++) {
+                Model *model = cell->models[i].get();
+                if (uploaded.insert(model).second) {
+                    model->Upload();
+                    modelBytes += model->MemoryBytes();
+                }
+            }
+            cell->lastUsed = frame;
+            resident[cell->key] = std::move(cell);
+        }
+
+        // 4. Evict out-of-range cells, least recently used first, until within budget
+        while (MemoryUsed() > memoryBudget) {
+            std::map<int64_t, std::unique_ptr<Cell>>::iterator victim = resident.end();
+            for (std::map<int64_t, std::unique_ptr<Cell>>::iterator it = resident.begin(); it != resident.end(); ++it) {
+                if (wanted.count(it->first)) continue;
+                if (victim == resident.end() || it->second->lastUsed < victim->second->lastUsed) victim = it;
+            }
+            if (victim == resident.end()) break; // everything left is in range
+            resident.erase(victim);
+        }
+    }
+
+    void Draw(Shader &shader) {
+        ForEachObject([&shader](GameObject &obj) { obj.Draw(shader); });
+    }
+
+    // Visits every object of every resident cell
+    template <typename Fn>
+    void ForEachObject(Fn fn) {
+        for (std::map<int64_t, std::unique_ptr<Cell>>::iterator it = resident.begin(); it != resident.end(); ++it)
+            for (unsigned int i = 0; i < it->second->objects.size(); i++)
+                fn(it->second->objects[i]);
+    }
+
+    // Visits the point lights of every resident cell
+    template <typename Fn>
+    void ForEachLight(Fn fn) const {
+        for (std::map<int64_t, std::unique_ptr<Cell>>::const_iterator it = resident.begin(); it != resident.end(); ++it)
+            for (unsigned int i = 0; i < it->second->lights.size(); i++)
+                fn(it->second->lights[i]);
+    }
+
+    size_t MemoryUsed() const {
+        size_t bytes = modelBytes;
+        for (std::map<int64_t, std::unique_ptr<Cell>>::const_iterator it = resident.begin(); it != resident.end(); ++it)
+            bytes += it->second->bytes;
+        return bytes;
+    }
+    size_t ResidentCells() const { return resident.size(); }
+    size_t PendingCells() const { return requested.size(); }
+    size_t TotalCells() const { return index.cells.size(); }
+    float CellSize() const { return index.cellSize; }
+
+private:
+    struct Cell {
+        int64_t key = 0;
+        std::vector<GameObject> objects;
+        std::vector<SceneLight> lights;
+        std::vector<std::shared_ptr<Model>> models; // keeps the cell's models alive
+        size_t bytes = 0;
+        uint64_t lastUsed = 0;
+        bool skipped = false; // request dropped because the cell left the radius first
+    };
+
+    std::string directory;
+    WorldIndex index;
+    std::map<int64_t, unsigned int> cellLookup;
+    uint64_t frame = 0;
+
+    // GL thread only
+    std::map<int64_t, std::unique_ptr<Cell>> resident;
+    std::set<int64_t> requested;
+    std::set<Model*> uploaded;
+    size_t modelBytes = 0;
+
+    // Shared with the loader thread, guarded by 'mutex'
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<int64_t> requests;
+    std::deque<std::unique_ptr<Cell>> completed;
+    std::set<int64_t> wanted;
+    bool stopping = false;
+    std::thread worker;
+
+    // Loader thread only. Weak so evicted models can die; a live entry is shared by new cells.
+    std::map<std::string, std::weak_ptr<Model>> modelCache;
+
+    std::shared_ptr<Model> acquireModel(const std::string &path) {
+        std::shared_ptr<Model> model = modelCache[path].lock();
+        if (model) return model;
+        // The last reference is always dropped on the GL thread (resident cells), so releasing GL objects here is safe
+        model = std::shared_ptr<Model>(new Model(path, false, true), [this](Model *m) {
+            if (uploaded.erase(m)) { modelBytes -= m->MemoryBytes(); m->Release(); }
+            delete m;
+        });
+        modelCache[path] = model;
+        return model;
+    }
+
+    void loaderThread() {
+        for (;;) {
+            int64_t key;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stopping || !requests.empty(); });
+                if (stopping) return;
+                key = requests.front();
+                requests.pop_front();
+                if (!wanted.count(key)) { // left the radius before we got to it
+                    completed.emplace_back(new Cell());
+                    completed.back()->key = key;
+                    completed.back()->skipped = true;
+                    continue;
+                }
+            }
+
+            PROFILE_SCOPE("WorldPartition::loadCell");
+            std::unique_ptr<Cell> cell(new Cell());
+            cell->key = key;
+            const WorldCellInfo &info = index.cells[cellLookup[key]];
+            PROFILE_MARK("world", "cell " + info.file);
+            MappedFile file; SceneView view;
+            if (file.Open((directory + "/" + info.file).c_str()) && OpenSceneBinary(file, view)) {
+                std::vector<Model*> assetModels(view.assetCount);
+                for (uint32_t i = 0; i < view.assetCount; i++) {
+                    cell->models.push_back(acquireModel(view.String(view.assetPaths[i])));
+                    assetModels[i] = cell->models.back().get();
+                }
+                cell->objects.reserve(view.objectCount);
+                for (uint32_t i = 0; i < view.objectCount; i++) {
+                    uint32_t asset = view.assets[i];
+                    cell->objects.emplace_back(view.String(view.names[i]), asset < assetModels.size() ? assetModels[asset] : nullptr);
+                    GameObject &obj = cell->objects.back();
+                    obj.position = view.transforms[i].position;
+                    obj.rotation = view.transforms[i].rotation;
+                    obj.scale = view.transforms[i].scale;
+                    uint32_t parent = view.Parent(i);
+                    obj.parent = parent == SCENE_NO_PARENT ? -1 : (int)parent;
+                }
+                UpdateHierarchy(cell->objects); // cells are static: once is enough
+                cell->lights.assign(view.lights, view.lights + view.lightCount);
+                cell->bytes = file.Size() + view.objectCount * sizeof(GameObject) + view.lightCount * sizeof(SceneLight);
+            }
+
+            // Always hand the cell over, even when stopping, so model references are dropped on the GL thread
+            std::lock_guard<std::mutex> lock(mutex);
+            completed.push_back(std::move(cell));
+            if (stopping) return;
+        }
+    }
+};
+#endif
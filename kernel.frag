@@ -0,0 +1,43 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D screenTexture;
+uniform vec2 texelSize; // one texel of the target this pass renders
+
+// 3x3 convolution, compiled once per kernel (ShaderVariants): 0=Sharpen, 1=Edge Detect
+#ifndef KERNEL
+#define KERNEL 0
+#endif
+
+void main()
+{
+    vec2 offsets[9] = vec2[](
+        vec2(-1.0,  1.0), vec2(0.0,  1.0), vec2(1.0,  1.0),
+        vec2(-1.0,  0.0), vec2(0.0,  0.0), vec2(1.0,  0.0),
+        vec2(-1.0, -1.0), vec2(0.0, -1.0), vec2(1.0, -1.0)
+    );
+
+#if KERNEL == 0
+    // Sharpen
+    const float kernel[9] = float[](
+        -1, -1, -1,
+        -1,  9, -1,
+        -1, -1, -1
+    );
+#else
+    // Edge Detection
+    const float kernel[9] = float[](
+        1,  1,  1,
+        1, -8,  1,
+        1,  1,  1
+    );
+#endif
+
+    vec3 sum = vec3(0.0);
+    for(int i = 0; i < 9; i++)
+        sum += texture(screenTexture, TexCoords + offsets[i] * texelSize).rgb * kernel[i];
+
+    FragColor = vec4(sum, 1.0);
+}
@@ -1,8 +1,14 @@
 #version 330 core
-out vec4 FragColor;
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out uint ObjectID;
+layout (location = 2) out vec2 Velocity;
+in vec4 CurrentClip;
+in vec4 PreviousClip;
 uniform vec3 lightColor;
 
 void main()
 {
     FragColor = vec4(lightColor, 1.0); // Always output bright color
+    ObjectID = 0u; // Lamps are not pickable
+    Velocity = (CurrentClip.xy / CurrentClip.w - PreviousClip.xy / PreviousClip.w) * 0.5;
 }
\ No newline at end of file
@@ -0,0 +1,11 @@
+#version 330 core
+in vec3 WorldPos;
+
+uniform vec3 lightPos;
+uniform float far;
+
+void main()
+{
+    // Distance to the light instead of the face's depth: the lookup needs no face projection
+    gl_FragDepth = length(WorldPos - lightPos) / far;
+}
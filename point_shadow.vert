@@ -0,0 +1,13 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+
+out vec3 WorldPos;
+
+uniform mat4 lightSpaceMatrix; // one cube face of the light
+uniform mat4 model;
+
+void main()
+{
+    WorldPos = vec3(model * vec4(aPos, 1.0));
+    gl_Position = lightSpaceMatrix * vec4(WorldPos, 1.0);
+}
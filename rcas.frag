@@ -0,0 +1,29 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D screenTexture; // upscaled image, same size as the target
+uniform float sharpness;         // FSR1's linear sharpness: exp2(-stops)
+
+// Robust contrast-adaptive sharpening after FSR1's RCAS: a negative-lobed cross filter whose
+// lobe is limited so the result stays within the neighbourhood, which keeps it from ringing.
+void main()
+{
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    ivec2 last = textureSize(screenTexture, 0) - 1;
+    vec3 b = texelFetch(screenTexture, clamp(p + ivec2(0, 1), ivec2(0), last), 0).rgb;
+    vec3 d = texelFetch(screenTexture, clamp(p + ivec2(-1, 0), ivec2(0), last), 0).rgb;
+    vec3 e = texelFetch(screenTexture, p, 0).rgb;
+    vec3 f = texelFetch(screenTexture, clamp(p + ivec2(1, 0), ivec2(0), last), 0).rgb;
+    vec3 h = texelFetch(screenTexture, clamp(p + ivec2(0, -1), ivec2(0), last), 0).rgb;
+
+    vec3 mn = min(min(b, d), min(f, h));
+    vec3 mx = max(max(b, d), max(f, h));
+    vec3 hitMin = min(mn, e) / (4.0 * mx + 1e-5);
+    vec3 hitMax = (1.0 - max(mx, e)) / (4.0 * mn - 4.0 - 1e-5);
+    vec3 lobes = max(-hitMin, hitMax);
+    float lobe = max(-0.1875, min(max(lobes.r, max(lobes.g, lobes.b)), 0.0)) * sharpness;
+
+    FragColor = vec4((lobe * (b + d + f + h) + e) / (4.0 * lobe + 1.0), 1.0);
+}
@@ -0,0 +1,138 @@
+// Shadow lookups, included by the lit shaders (1.0 = shadow, 0.0 = no shadow): the sun's, then the point lights'
+// PCF_RADIUS: the filter covers (2 * PCF_RADIUS + 1)^2 texels, specialized by ShaderVariants
+// SHADOW_FILTER: how the map is filtered (Renderer's ShadowFilter)
+//   0 manual: a depth fetch and compare per texel of the filter
+//   1 hardware: comparison sampler, every tap is a bilinear 2x2 PCF, so (PCF_RADIUS + 1)^2 taps
+//     cover the same area
+//   2 poisson: 8 comparison taps on a Poisson disk, rotated per pixel (the noise is left to TAA or
+//     reads as grain), scaled to the PCF_RADIUS footprint
+//   3 evsm: exponential variance shadow map, prefiltered (blurred and mipmapped) once per update;
+//     one filtered fetch per pixel
+// Point lights look their shadow up in the atlas of cube faces (Renderer's ShadowAtlas) with one
+// bilinear comparison, whatever SHADOW_FILTER is.
+#ifndef PCF_RADIUS
+#define PCF_RADIUS 1
+#endif
+#ifndef SHADOW_FILTER
+#define SHADOW_FILTER 0
+#endif
+
+#if SHADOW_FILTER == 1 || SHADOW_FILTER == 2
+uniform sampler2DShadow shadowMap; // The Depth Texture, compared by the sampler
+#else
+uniform sampler2D shadowMap; // The Depth Texture (moments with EVSM)
+#endif
+#if SHADOW_FILTER == 3
+uniform vec2 evsmExponents; // positive and negative warp, bounded by the moments' format
+#endif
+
+#if SHADOW_FILTER == 2
+const vec2 POISSON_DISK[8] = vec2[](
+    vec2(-0.7071, 0.7071), vec2(-0.0000, -0.8750), vec2(0.5303, 0.5303), vec2(-0.6250, -0.0000),
+    vec2(0.3062, -0.3062), vec2(-0.0000, 0.3750), vec2(-0.1768, -0.1768), vec2(0.1250, 0.0000));
+#endif
+
+#if SHADOW_FILTER == 3
+// Upper bound on the lit fraction from the moments (Chebyshev), with light bleeding cut off
+float chebyshev(vec2 moments, float depth, float minVariance)
+{
+    if (depth <= moments.x) return 1.0;
+    float variance = max(moments.y - moments.x * moments.x, minVariance);
+    float d = depth - moments.x;
+    float pMax = variance / (variance + d * d);
+    return clamp((pMax - 0.2) / 0.8, 0.0, 1.0);
+}
+#endif
+
+float ShadowCalculation(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir)
+{
+    // perform perspective divide
+    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
+    // transform to [0,1] range
+    projCoords = projCoords * 0.5 + 0.5;
+
+    // Keep the shadow at 0.0 when outside the far_plane region of the light's frustum.
+    if(projCoords.z > 1.0)
+        return 0.0;
+
+    // get depth of current fragment from light's perspective
+    float currentDepth = projCoords.z;
+
+    // Shadow Bias (removes "Shadow Acne" patterns)
+    float bias = max(0.05 * (1.0 - dot(normal, lightDir)), 0.005);
+    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
+
+#if SHADOW_FILTER == 1
+    // Taps two texels apart, each filtering the 2x2 around it
+    float lit = 0.0;
+    for(int x = 0; x <= PCF_RADIUS; ++x)
+        for(int y = 0; y <= PCF_RADIUS; ++y)
+            lit += texture(shadowMap, vec3(projCoords.xy + (vec2(x, y) * 2.0 - float(PCF_RADIUS)) * texelSize, currentDepth - bias));
+    return 1.0 - lit / float((PCF_RADIUS + 1) * (PCF_RADIUS + 1));
+#elif SHADOW_FILTER == 2
+    // Interleaved gradient noise picks the disk's rotation
+    float angle = 6.2831853 * fract(52.9829189 * fract(dot(gl_FragCoord.xy, vec2(0.06711056, 0.00583715))));
+    mat2 rotation = mat2(cos(angle), sin(angle), -sin(angle), cos(angle));
+    float radius = float(PCF_RADIUS) + 1.0;
+    float lit = 0.0;
+    for(int i = 0; i < 8; ++i)
+        lit += texture(shadowMap, vec3(projCoords.xy + rotation * POISSON_DISK[i] * radius * texelSize, currentDepth - bias));
+    return 1.0 - lit / 8.0;
+#elif SHADOW_FILTER == 3
+    // The map's border is not "unshadowed" for moments; outside it nothing is
+    if(any(lessThan(projCoords.xy, vec2(0.0))) || any(greaterThan(projCoords.xy, vec2(1.0))))
+        return 0.0;
+    vec4 moments = texture(shadowMap, projCoords.xy);
+    float depth = (currentDepth - bias * 0.1) * 2.0 - 1.0;
+    vec2 warped = vec2(exp(evsmExponents.x * depth), -exp(-evsmExponents.y * depth));
+    vec2 slope = evsmExponents * warped; // d(warped)/d(depth): the variance floor scales with it
+    float lit = min(chebyshev(moments.xy, warped.x, 1e-5 * slope.x * slope.x), chebyshev(moments.zw, warped.y, 1e-5 * slope.y * slope.y));
+    return 1.0 - lit;
+#else
+    // PCF (Percentage-closer filtering) for softer edges
+    float shadow = 0.0;
+    for(int x = -PCF_RADIUS; x <= PCF_RADIUS; ++x)
+    {
+        for(int y = -PCF_RADIUS; y <= PCF_RADIUS; ++y)
+        {
+            float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
+            shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
+        }
+    }
+    return shadow / float((2 * PCF_RADIUS + 1) * (2 * PCF_RADIUS + 1));
+#endif
+}
+
+#if NR_POINT_LIGHTS > 0
+uniform sampler2DShadow pointShadowAtlas; // distance to the light / pointShadowFar, compared by the sampler
+// Per light and face: the tile's corner and size in atlas UV, and half a texel of the tile in
+// face UV. A size of 0 on the first face: the light has no shadow (yet).
+uniform vec4 pointShadowTiles[NR_POINT_LIGHTS * 6];
+uniform float pointShadowFar;
+
+// Face basis of ShadowAtlas::FaceView
+const vec3 FACE_FORWARD[6] = vec3[](vec3(1, 0, 0), vec3(-1, 0, 0), vec3(0, 1, 0), vec3(0, -1, 0), vec3(0, 0, 1), vec3(0, 0, -1));
+const vec3 FACE_UP[6] = vec3[](vec3(0, -1, 0), vec3(0, -1, 0), vec3(0, 0, 1), vec3(0, 0, -1), vec3(0, -1, 0), vec3(0, -1, 0));
+
+float PointShadowCalculation(int light, vec3 lightPos, vec3 fragPos, vec3 normal)
+{
+    vec3 d = fragPos - lightPos;
+    float distance = length(d);
+    if (pointShadowTiles[light * 6].z == 0.0 || distance >= pointShadowFar)
+        return 0.0;
+
+    // The face is the major axis, its UV the face camera's projection
+    vec3 a = abs(d);
+    int face = a.x >= a.y && a.x >= a.z ? (d.x > 0.0 ? 0 : 1) : a.y >= a.z ? (d.y > 0.0 ? 2 : 3) : (d.z > 0.0 ? 4 : 5);
+    vec3 forward = FACE_FORWARD[face];
+    vec3 right = normalize(cross(forward, FACE_UP[face]));
+    vec3 up = cross(right, forward);
+    vec2 uv = vec2(dot(d, right), dot(d, up)) / dot(d, forward) * 0.5 + 0.5;
+    vec4 tile = pointShadowTiles[light * 6 + face];
+    uv = tile.xy + clamp(uv, vec2(tile.w), vec2(1.0 - tile.w)) * tile.z; // the bilinear taps stay in the tile
+
+    // Bias in world units, more at grazing angles
+    float bias = 0.05 + 0.1 * (1.0 - max(dot(normal, -d / distance), 0.0));
+    return 1.0 - texture(pointShadowAtlas, vec3(uv, (distance - bias) / pointShadowFar));
+}
+#endif
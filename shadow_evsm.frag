@@ -0,0 +1,35 @@
+#version 330 core
+out vec4 FragColor;
+
+uniform sampler2D source;  // the depth map, then (vertical) the moments
+uniform int vertical;
+uniform vec2 viewSize;     // the corner of the map the shadow pass drew into
+uniform int radius;        // Gaussian of 'radius' texels on either side
+uniform vec2 exponents;    // EVSM warp, see shadow.glsl
+
+// One axis of the EVSM prefilter, at the map's texels (gl_FragCoord) so it works on the
+// shadow pass's corner: the first pass turns depth into the warped moments while blurring
+// horizontally, the second blurs them vertically.
+
+vec4 moments(float depth)
+{
+    depth = depth * 2.0 - 1.0;
+    float positive = exp(exponents.x * depth), negative = -exp(-exponents.y * depth);
+    return vec4(positive, positive * positive, negative, negative * negative);
+}
+
+void main()
+{
+    ivec2 center = ivec2(gl_FragCoord.xy), axis = vertical != 0 ? ivec2(0, 1) : ivec2(1, 0);
+    float sigma = max(float(radius), 0.5) * 0.5;
+    vec4 sum = vec4(0.0);
+    float total = 0.0;
+    for (int i = -radius; i <= radius; i++) {
+        ivec2 p = clamp(center + axis * i, ivec2(0), ivec2(viewSize) - 1);
+        vec4 texel = texelFetch(source, p, 0);
+        float w = exp(-float(i * i) / (2.0 * sigma * sigma));
+        sum += (vertical != 0 ? texel : moments(texel.r)) * w;
+        total += w;
+    }
+    FragColor = sum / total;
+}
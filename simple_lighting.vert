@@ -7,11 +7,16 @@ out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
 out vec4 FragPosLightSpace; // NEW: Position seen from the sun
+out vec4 CurrentClip;       // this frame and the last one without the TAA jitter, for the velocity buffer
+out vec4 PreviousClip;
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 uniform mat4 lightSpaceMatrix; // NEW: Transform matrix
+uniform mat4 prevModel;
+uniform mat4 currentViewProjection;
+uniform mat4 previousViewProjection;
 
 void main()
 {
@@ -21,5 +26,7 @@ void main()
     // Transform the vertex into light space for shadow checking later
     FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
     
+    CurrentClip = currentViewProjection * vec4(FragPos, 1.0);
+    PreviousClip = previousViewProjection * prevModel * vec4(aPos, 1.0);
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
\ No newline at end of file
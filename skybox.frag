@@ -1,11 +1,18 @@
 #version 330 core
-out vec4 FragColor;
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out uint ObjectID;
+layout (location = 2) out vec2 Velocity;
 
 in vec3 TexCoords;
+in vec4 CurrentClip;
+in vec4 PreviousClip;
 
 uniform samplerCube skybox;
+uniform float lodBias; // mip bias, raised by the quality governor
 
 void main()
 {    
-    FragColor = texture(skybox, TexCoords);
+    FragColor = texture(skybox, TexCoords, lodBias);
+    ObjectID = 0u;
+    Velocity = (CurrentClip.xy / CurrentClip.w - PreviousClip.xy / PreviousClip.w) * 0.5;
 }
\ No newline at end of file
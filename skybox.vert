@@ -2,13 +2,19 @@
 layout (location = 0) in vec3 aPos;
 
 out vec3 TexCoords;
+out vec4 CurrentClip;  // without the TAA jitter, for the velocity buffer
+out vec4 PreviousClip;
 
 uniform mat4 projection;
 uniform mat4 view;
+uniform mat4 currentViewProjection;  // rotation-only views, like 'view'
+uniform mat4 previousViewProjection;
 
 void main()
 {
     TexCoords = aPos;
+    CurrentClip = currentViewProjection * vec4(aPos, 1.0);
+    PreviousClip = previousViewProjection * vec4(aPos, 1.0);
     vec4 pos = projection * view * vec4(aPos, 1.0);
     // Optimization: Set z to w so the resulting depth is always 1.0 (maximum distance)
     gl_Position = pos.xyww;
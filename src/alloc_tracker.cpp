@@ -0,0 +1,151 @@
+// Global operator new/delete replacements that count allocations for AllocTracker.h.
+// Link into an executable at most once; the counters cost two atomic adds per allocation.
+#include "AllocTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+#if defined(__GLIBC__)
+#include <execinfo.h>
+#endif
+
+static std::atomic<uint64_t> processAllocations{0}, processFrees{0}, processBytes{0};
+static thread_local AllocCounters threadCounters;
+
+static std::atomic<uint32_t> sampleRate{0};
+static const uint32_t SAMPLE_RING = 4096;
+// A sample is published by storing its address last; the reader takes it by swapping in null.
+// Under contention a sample may land in the next batch, which is fine for a histogram.
+struct SampleSlot {
+    std::atomic<const void*> address{nullptr};
+    size_t size = 0;
+};
+static SampleSlot sampleRing[SAMPLE_RING];
+static std::atomic<uint32_t> sampleHead{0};
+
+#if defined(__GNUC__)
+#define ALLOC_CALL_SITE() __builtin_return_address(0)
+#else
+#define ALLOC_CALL_SITE() ((void*)0)
+#endif
+
+static inline void countAllocation(size_t size, const void *site) {
+    uint64_t n = processAllocations.fetch_add(1, std::memory_order_relaxed);
+    processBytes.fetch_add(size, std::memory_order_relaxed);
+    threadCounters.allocations++;
+    threadCounters.bytes += size;
+    uint32_t rate = sampleRate.load(std::memory_order_relaxed);
+    if (rate == 0 || n % rate != 0) return;
+    uint32_t slot = sampleHead.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= SAMPLE_RING) return; // full until the next AllocTakeSamples()
+    sampleRing[slot].size = size;
+    sampleRing[slot].address.store(site, std::memory_order_release);
+}
+
+static inline void countFree(void *p) {
+    if (!p) return;
+    processFrees.fetch_add(1, std::memory_order_relaxed);
+    threadCounters.frees++;
+}
+
+static void* allocate(size_t size) {
+    if (size == 0) size = 1;
+    for (;;) {
+        if (void *p = std::malloc(size)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+static void* allocateAligned(size_t size, size_t alignment) {
+    if (size == 0) size = 1;
+    for (;;) {
+#if defined(_WIN32)
+        if (void *p = _aligned_malloc(size, alignment)) return p;
+#else
+        void *p = nullptr;
+        if (posix_memalign(&p, alignment < sizeof(void*) ? sizeof(void*) : alignment, size) == 0) return p;
+#endif
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+static void freeAligned(void *p) {
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+AllocCounters AllocProcessCounters() {
+    AllocCounters c;
+    c.allocations = processAllocations.load(std::memory_order_relaxed);
+    c.frees = processFrees.load(std::memory_order_relaxed);
+    c.bytes = processBytes.load(std::memory_order_relaxed);
+    return c;
+}
+
+AllocCounters AllocThreadCounters() { return threadCounters; }
+
+void AllocSetSampleRate(uint32_t everyN) { sampleRate.store(everyN, std::memory_order_relaxed); }
+uint32_t AllocSampleRate() { return sampleRate.load(std::memory_order_relaxed); }
+
+size_t AllocTakeSamples(std::vector<AllocSample> &out) {
+    uint32_t taken = sampleHead.exchange(0, std::memory_order_relaxed);
+    uint32_t n = taken < SAMPLE_RING ? taken : SAMPLE_RING;
+    for (uint32_t i = 0; i < n; i++) {
+        const void *address = sampleRing[i].address.exchange(nullptr, std::memory_order_acquire);
+        if (!address) continue;
+        AllocSample s = { address, sampleRing[i].size };
+        out.push_back(s);
+    }
+    return taken - n;
+}
+
+void AllocTracker::Symbolize() {
+    for (Site &s : sites) {
+        if (!s.symbol.empty()) continue;
+        char text[32];
+        std::snprintf(text, sizeof(text), "%p", s.address);
+        s.symbol = text;
+#if defined(__GLIBC__)
+        // Without -rdynamic only "binary(+offset)", which addr2line resolves
+        void *frames[1] = { const_cast<void*>(s.address) };
+        if (char **names = backtrace_symbols(frames, 1)) {
+            s.symbol = names[0];
+            std::free(names);
+        }
+#endif
+    }
+}
+
+// --- Replacements; the call site is taken here, in the function the program called ---
+
+void* operator new(size_t size) { countAllocation(size, ALLOC_CALL_SITE()); return allocate(size); }
+void* operator new[](size_t size) { countAllocation(size, ALLOC_CALL_SITE()); return allocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    countAllocation(size, ALLOC_CALL_SITE());
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    countAllocation(size, ALLOC_CALL_SITE());
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new(size_t size, std::align_val_t alignment) { countAllocation(size, ALLOC_CALL_SITE()); return allocateAligned(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { countAllocation(size, ALLOC_CALL_SITE()); return allocateAligned(size, (size_t)alignment); }
+
+void operator delete(void *p) noexcept { countFree(p); std::free(p); }
+void operator delete[](void *p) noexcept { countFree(p); std::free(p); }
+void operator delete(void *p, size_t) noexcept { countFree(p); std::free(p); }
+void operator delete[](void *p, size_t) noexcept { countFree(p); std::free(p); }
+void operator delete(void *p, const std::nothrow_t&) noexcept { countFree(p); std::free(p); }
+void operator delete[](void *p, const std::nothrow_t&) noexcept { countFree(p); std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { countFree(p); freeAligned(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { countFree(p); freeAligned(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { countFree(p); freeAligned(p); }
+void operator delete[](void *p, size_t, std::align_val_t) noexcept { countFree(p); freeAligned(p); }
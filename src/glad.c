@@ -7,22 +7,27 @@
     APIs: gl=3.3
     Profile: core
     Extensions:
-        
+        GL_ARB_get_program_binary,
+        GL_KHR_parallel_shader_compile
     Loader: True
     Local files: False
     Omit khrplatform: False
     Reproducible: False
 
     Commandline:
-        --profile="core" --api="gl=3.3" --generator="c" --spec="gl" --extensions=""
+        --profile="core" --api="gl=3.3" --generator="c" --spec="gl" --extensions="GL_ARB_get_program_binary,GL_KHR_parallel_shader_compile"
     Online:
-        https://glad.dav1d.de/#profile=core&language=c&specification=gl&loader=on&api=gl%3D3.3
+        https://glad.dav1d.de/#profile=core&language=c&specification=gl&extensions=GL_ARB_get_program_binary&extensions=GL_KHR_parallel_shader_compile&loader=on&api=gl%3D3.3
 */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <glad/glad.h>
+#ifdef ENGINE_GL_STATS
+#include "GLStats.h"
+static void gladStatsInstall(void);
+#endif
 
 static void* get_proc(const char *namez);
 
@@ -498,6 +503,12 @@ PFNGLSAMPLERPARAMETERIVPROC glad_glSamplerParameteriv = NULL;
 PFNGLSCISSORPROC glad_glScissor = NULL;
 PFNGLSECONDARYCOLORP3UIPROC glad_glSecondaryColorP3ui = NULL;
 PFNGLSECONDARYCOLORP3UIVPROC glad_glSecondaryColorP3uiv = NULL;
+int GLAD_GL_ARB_get_program_binary = 0;
+int GLAD_GL_KHR_parallel_shader_compile = 0;
+PFNGLGETPROGRAMBINARYPROC glad_glGetProgramBinary = NULL;
+PFNGLPROGRAMBINARYPROC glad_glProgramBinary = NULL;
+PFNGLPROGRAMPARAMETERIPROC glad_glProgramParameteri = NULL;
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glad_glMaxShaderCompilerThreadsKHR = NULL;
 PFNGLSHADERSOURCEPROC glad_glShaderSource = NULL;
 PFNGLSTENCILFUNCPROC glad_glStencilFunc = NULL;
 PFNGLSTENCILFUNCSEPARATEPROC glad_glStencilFuncSeparate = NULL;
@@ -1054,9 +1065,20 @@ static void load_GL_VERSION_3_3(GLADloadproc load) {
 	glad_glSecondaryColorP3ui = (PFNGLSECONDARYCOLORP3UIPROC)load("glSecondaryColorP3ui");
 	glad_glSecondaryColorP3uiv = (PFNGLSECONDARYCOLORP3UIVPROC)load("glSecondaryColorP3uiv");
 }
+static void load_GL_ARB_get_program_binary(GLADloadproc load) {
+	if(!GLAD_GL_ARB_get_program_binary) return;
+	glad_glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)load("glGetProgramBinary");
+	glad_glProgramBinary = (PFNGLPROGRAMBINARYPROC)load("glProgramBinary");
+	glad_glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)load("glProgramParameteri");
+}
+static void load_GL_KHR_parallel_shader_compile(GLADloadproc load) {
+	if(!GLAD_GL_KHR_parallel_shader_compile) return;
+	glad_glMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load("glMaxShaderCompilerThreadsKHR");
+}
 static int find_extensionsGL(void) {
 	if (!get_exts()) return 0;
-	(void)&has_ext;
+	GLAD_GL_ARB_get_program_binary = has_ext("GL_ARB_get_program_binary");
+	GLAD_GL_KHR_parallel_shader_compile = has_ext("GL_KHR_parallel_shader_compile");
 	free_exts();
 	return 1;
 }
@@ -1135,6 +1157,153 @@ int gladLoadGLLoader(GLADloadproc load) {
 	load_GL_VERSION_3_3(load);
 
 	if (!find_extensionsGL()) return 0;
+	load_GL_ARB_get_program_binary(load);
+	load_GL_KHR_parallel_shader_compile(load);
+#ifdef ENGINE_GL_STATS
+	gladStatsInstall();
+#endif
 	return GLVersion.major != 0 || GLVersion.minor != 0;
 }
 
+#ifdef ENGINE_GL_STATS
+/* Counting wrappers for the calls listed in GLStats.h (not part of the generated loader) */
+unsigned long long gladStatsCounters[GL_STATS_CATEGORY_COUNT];
+
+static unsigned long long gladStatsTriangles(GLenum mode, GLsizei count, GLsizei instances) {
+	unsigned long long perInstance = 0;
+	if (mode == GL_TRIANGLES) perInstance = (unsigned long long)count / 3;
+	else if ((mode == GL_TRIANGLE_STRIP || mode == GL_TRIANGLE_FAN) && count >= 3) perInstance = (unsigned long long)count - 2;
+	return perInstance * (unsigned long long)(instances > 0 ? instances : 0);
+}
+
+static PFNGLDRAWARRAYSPROC glad_stats_real_glDrawArrays;
+static void APIENTRY glad_stats_glDrawArrays(GLenum mode, GLint first, GLsizei count) { gladStatsCounters[GL_STATS_DRAW_CALLS]++; gladStatsCounters[GL_STATS_TRIANGLES] += gladStatsTriangles(mode, count, 1); glad_stats_real_glDrawArrays(mode, first, count); }
+static PFNGLDRAWELEMENTSPROC glad_stats_real_glDrawElements;
+static void APIENTRY glad_stats_glDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices) { gladStatsCounters[GL_STATS_DRAW_CALLS]++; gladStatsCounters[GL_STATS_TRIANGLES] += gladStatsTriangles(mode, count, 1); glad_stats_real_glDrawElements(mode, count, type, indices); }
+static PFNGLDRAWARRAYSINSTANCEDPROC glad_stats_real_glDrawArraysInstanced;
+static void APIENTRY glad_stats_glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount) { gladStatsCounters[GL_STATS_DRAW_CALLS]++; gladStatsCounters[GL_STATS_TRIANGLES] += gladStatsTriangles(mode, count, instancecount); glad_stats_real_glDrawArraysInstanced(mode, first, count, instancecount); }
+static PFNGLDRAWELEMENTSINSTANCEDPROC glad_stats_real_glDrawElementsInstanced;
+static void APIENTRY glad_stats_glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount) { gladStatsCounters[GL_STATS_DRAW_CALLS]++; gladStatsCounters[GL_STATS_TRIANGLES] += gladStatsTriangles(mode, count, instancecount); glad_stats_real_glDrawElementsInstanced(mode, count, type, indices, instancecount); }
+static PFNGLDRAWRANGEELEMENTSPROC glad_stats_real_glDrawRangeElements;
+static void APIENTRY glad_stats_glDrawRangeElements(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices) { gladStatsCounters[GL_STATS_DRAW_CALLS]++; gladStatsCounters[GL_STATS_TRIANGLES] += gladStatsTriangles(mode, count, 1); glad_stats_real_glDrawRangeElements(mode, start, end, count, type, indices); }
+static PFNGLDRAWELEMENTSBASEVERTEXPROC glad_stats_real_glDrawElementsBaseVertex;
+static void APIENTRY glad_stats_glDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void *indices, GLint basevertex) { gladStatsCounters[GL_STATS_DRAW_CALLS]++; gladStatsCounters[GL_STATS_TRIANGLES] += gladStatsTriangles(mode, count, 1); glad_stats_real_glDrawElementsBaseVertex(mode, count, type, indices, basevertex); }
+static PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC glad_stats_real_glDrawElementsInstancedBaseVertex;
+static void APIENTRY glad_stats_glDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount, GLint basevertex) { gladStatsCounters[GL_STATS_DRAW_CALLS]++; gladStatsCounters[GL_STATS_TRIANGLES] += gladStatsTriangles(mode, count, instancecount); glad_stats_real_glDrawElementsInstancedBaseVertex(mode, count, type, indices, instancecount, basevertex); }
+static PFNGLDRAWRANGEELEMENTSBASEVERTEXPROC glad_stats_real_glDrawRangeElementsBaseVertex;
+static void APIENTRY glad_stats_glDrawRangeElementsBaseVertex(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices, GLint basevertex) { gladStatsCounters[GL_STATS_DRAW_CALLS]++; gladStatsCounters[GL_STATS_TRIANGLES] += gladStatsTriangles(mode, count, 1); glad_stats_real_glDrawRangeElementsBaseVertex(mode, start, end, count, type, indices, basevertex); }
+static PFNGLUSEPROGRAMPROC glad_stats_real_glUseProgram;
+static void APIENTRY glad_stats_glUseProgram(GLuint program) { gladStatsCounters[GL_STATS_PROGRAM_BINDS]++; glad_stats_real_glUseProgram(program); }
+static PFNGLGETUNIFORMLOCATIONPROC glad_stats_real_glGetUniformLocation;
+static GLint APIENTRY glad_stats_glGetUniformLocation(GLuint program, const GLchar *name) { gladStatsCounters[GL_STATS_UNIFORM_LOOKUPS]++; return glad_stats_real_glGetUniformLocation(program, name); }
+static PFNGLBINDTEXTUREPROC glad_stats_real_glBindTexture;
+static void APIENTRY glad_stats_glBindTexture(GLenum target, GLuint texture) { gladStatsCounters[GL_STATS_TEXTURE_BINDS]++; glad_stats_real_glBindTexture(target, texture); }
+static PFNGLBINDBUFFERPROC glad_stats_real_glBindBuffer;
+static void APIENTRY glad_stats_glBindBuffer(GLenum target, GLuint buffer) { gladStatsCounters[GL_STATS_BUFFER_BINDS]++; glad_stats_real_glBindBuffer(target, buffer); }
+static PFNGLBINDVERTEXARRAYPROC glad_stats_real_glBindVertexArray;
+static void APIENTRY glad_stats_glBindVertexArray(GLuint array) { gladStatsCounters[GL_STATS_BUFFER_BINDS]++; glad_stats_real_glBindVertexArray(array); }
+static PFNGLBINDFRAMEBUFFERPROC glad_stats_real_glBindFramebuffer;
+static void APIENTRY glad_stats_glBindFramebuffer(GLenum target, GLuint framebuffer) { gladStatsCounters[GL_STATS_FRAMEBUFFER_BINDS]++; glad_stats_real_glBindFramebuffer(target, framebuffer); }
+static PFNGLENABLEPROC glad_stats_real_glEnable;
+static void APIENTRY glad_stats_glEnable(GLenum cap) { gladStatsCounters[GL_STATS_STATE_CHANGES]++; glad_stats_real_glEnable(cap); }
+static PFNGLDISABLEPROC glad_stats_real_glDisable;
+static void APIENTRY glad_stats_glDisable(GLenum cap) { gladStatsCounters[GL_STATS_STATE_CHANGES]++; glad_stats_real_glDisable(cap); }
+static PFNGLDEPTHFUNCPROC glad_stats_real_glDepthFunc;
+static void APIENTRY glad_stats_glDepthFunc(GLenum func) { gladStatsCounters[GL_STATS_STATE_CHANGES]++; glad_stats_real_glDepthFunc(func); }
+static PFNGLDEPTHMASKPROC glad_stats_real_glDepthMask;
+static void APIENTRY glad_stats_glDepthMask(GLboolean flag) { gladStatsCounters[GL_STATS_STATE_CHANGES]++; glad_stats_real_glDepthMask(flag); }
+static PFNGLBLENDFUNCPROC glad_stats_real_glBlendFunc;
+static void APIENTRY glad_stats_glBlendFunc(GLenum sfactor, GLenum dfactor) { gladStatsCounters[GL_STATS_STATE_CHANGES]++; glad_stats_real_glBlendFunc(sfactor, dfactor); }
+static PFNGLCULLFACEPROC glad_stats_real_glCullFace;
+static void APIENTRY glad_stats_glCullFace(GLenum mode) { gladStatsCounters[GL_STATS_STATE_CHANGES]++; glad_stats_real_glCullFace(mode); }
+static PFNGLVIEWPORTPROC glad_stats_real_glViewport;
+static void APIENTRY glad_stats_glViewport(GLint x, GLint y, GLsizei width, GLsizei height) { gladStatsCounters[GL_STATS_STATE_CHANGES]++; glad_stats_real_glViewport(x, y, width, height); }
+static PFNGLACTIVETEXTUREPROC glad_stats_real_glActiveTexture;
+static void APIENTRY glad_stats_glActiveTexture(GLenum texture) { gladStatsCounters[GL_STATS_STATE_CHANGES]++; glad_stats_real_glActiveTexture(texture); }
+static PFNGLCOLORMASKPROC glad_stats_real_glColorMask;
+static void APIENTRY glad_stats_glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) { gladStatsCounters[GL_STATS_STATE_CHANGES]++; glad_stats_real_glColorMask(red, green, blue, alpha); }
+static PFNGLPOLYGONMODEPROC glad_stats_real_glPolygonMode;
+static void APIENTRY glad_stats_glPolygonMode(GLenum face, GLenum mode) { gladStatsCounters[GL_STATS_STATE_CHANGES]++; glad_stats_real_glPolygonMode(face, mode); }
+static PFNGLBUFFERDATAPROC glad_stats_real_glBufferData;
+static void APIENTRY glad_stats_glBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) { gladStatsCounters[GL_STATS_BUFFER_UPLOADS]++; gladStatsCounters[GL_STATS_UPLOAD_BYTES] += (unsigned long long)size; glad_stats_real_glBufferData(target, size, data, usage); }
+static PFNGLBUFFERSUBDATAPROC glad_stats_real_glBufferSubData;
+static void APIENTRY glad_stats_glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) { gladStatsCounters[GL_STATS_BUFFER_UPLOADS]++; gladStatsCounters[GL_STATS_UPLOAD_BYTES] += (unsigned long long)size; glad_stats_real_glBufferSubData(target, offset, size, data); }
+static PFNGLTEXIMAGE2DPROC glad_stats_real_glTexImage2D;
+static void APIENTRY glad_stats_glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels) { gladStatsCounters[GL_STATS_TEXTURE_UPLOADS]++; glad_stats_real_glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels); }
+static PFNGLTEXSUBIMAGE2DPROC glad_stats_real_glTexSubImage2D;
+static void APIENTRY glad_stats_glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels) { gladStatsCounters[GL_STATS_TEXTURE_UPLOADS]++; glad_stats_real_glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels); }
+static PFNGLCLEARPROC glad_stats_real_glClear;
+static void APIENTRY glad_stats_glClear(GLbitfield mask) { gladStatsCounters[GL_STATS_CLEARS]++; glad_stats_real_glClear(mask); }
+static PFNGLUNIFORM1IPROC glad_stats_real_glUniform1i;
+static void APIENTRY glad_stats_glUniform1i(GLint location, GLint v0) { gladStatsCounters[GL_STATS_UNIFORM_UPLOADS]++; glad_stats_real_glUniform1i(location, v0); }
+static PFNGLUNIFORM1UIPROC glad_stats_real_glUniform1ui;
+static void APIENTRY glad_stats_glUniform1ui(GLint location, GLuint v0) { gladStatsCounters[GL_STATS_UNIFORM_UPLOADS]++; glad_stats_real_glUniform1ui(location, v0); }
+static PFNGLUNIFORM1FPROC glad_stats_real_glUniform1f;
+static void APIENTRY glad_stats_glUniform1f(GLint location, GLfloat v0) { gladStatsCounters[GL_STATS_UNIFORM_UPLOADS]++; glad_stats_real_glUniform1f(location, v0); }
+static PFNGLUNIFORM2FPROC glad_stats_real_glUniform2f;
+static void APIENTRY glad_stats_glUniform2f(GLint location, GLfloat v0, GLfloat v1) { gladStatsCounters[GL_STATS_UNIFORM_UPLOADS]++; glad_stats_real_glUniform2f(location, v0, v1); }
+static PFNGLUNIFORM3FPROC glad_stats_real_glUniform3f;
+static void APIENTRY glad_stats_glUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) { gladStatsCounters[GL_STATS_UNIFORM_UPLOADS]++; glad_stats_real_glUniform3f(location, v0, v1, v2); }
+static PFNGLUNIFORM4FPROC glad_stats_real_glUniform4f;
+static void APIENTRY glad_stats_glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) { gladStatsCounters[GL_STATS_UNIFORM_UPLOADS]++; glad_stats_real_glUniform4f(location, v0, v1, v2, v3); }
+static PFNGLUNIFORM1IVPROC glad_stats_real_glUniform1iv;
+static void APIENTRY glad_stats_glUniform1iv(GLint location, GLsizei count, const GLint *value) { gladStatsCounters[GL_STATS_UNIFORM_UPLOADS]++; glad_stats_real_glUniform1iv(location, count, value); }
+static PFNGLUNIFORM1FVPROC glad_stats_real_glUniform1fv;
+static void APIENTRY glad_stats_glUniform1fv(GLint location, GLsizei count, const GLfloat *value) { gladStatsCounters[GL_STATS_UNIFORM_UPLOADS]++; glad_stats_real_glUniform1fv(location, count, value); }
+static PFNGLUNIFORM2FVPROC glad_stats_real_glUniform2fv;
+static void APIENTRY glad_stats_glUniform2fv(GLint location, GLsizei count, const GLfloat *value) { gladStatsCounters[GL_STATS_UNIFORM_UPLOADS]++; glad_stats_real_glUniform2fv(location, count, value); }
+static PFNGLUNIFORM3FVPROC glad_stats_real_glUniform3fv;
+static void APIENTRY glad_stats_glUniform3fv(GLint location, GLsizei count, const GLfloat *value) { gladStatsCounters[GL_STATS_UNIFORM_UPLOADS]++; glad_stats_real_glUniform3fv(location, count, value); }
+static PFNGLUNIFORM4FVPROC glad_stats_real_glUniform4fv;
+static void APIENTRY glad_stats_glUniform4fv(GLint location, GLsizei count, const GLfloat *value) { gladStatsCounters[GL_STATS_UNIFORM_UPLOADS]++; glad_stats_real_glUniform4fv(location, count, value); }
+static PFNGLUNIFORMMATRIX3FVPROC glad_stats_real_glUniformMatrix3fv;
+static void APIENTRY glad_stats_glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) { gladStatsCounters[GL_STATS_UNIFORM_UPLOADS]++; glad_stats_real_glUniformMatrix3fv(location, count, transpose, value); }
+static PFNGLUNIFORMMATRIX4FVPROC glad_stats_real_glUniformMatrix4fv;
+static void APIENTRY glad_stats_glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) { gladStatsCounters[GL_STATS_UNIFORM_UPLOADS]++; glad_stats_real_glUniformMatrix4fv(location, count, transpose, value); }
+
+static void gladStatsInstall(void) {
+	glad_stats_real_glDrawArrays = glad_glDrawArrays; if (glad_glDrawArrays) glad_glDrawArrays = glad_stats_glDrawArrays;
+	glad_stats_real_glDrawElements = glad_glDrawElements; if (glad_glDrawElements) glad_glDrawElements = glad_stats_glDrawElements;
+	glad_stats_real_glDrawArraysInstanced = glad_glDrawArraysInstanced; if (glad_glDrawArraysInstanced) glad_glDrawArraysInstanced = glad_stats_glDrawArraysInstanced;
+	glad_stats_real_glDrawElementsInstanced = glad_glDrawElementsInstanced; if (glad_glDrawElementsInstanced) glad_glDrawElementsInstanced = glad_stats_glDrawElementsInstanced;
+	glad_stats_real_glDrawRangeElements = glad_glDrawRangeElements; if (glad_glDrawRangeElements) glad_glDrawRangeElements = glad_stats_glDrawRangeElements;
+	glad_stats_real_glDrawElementsBaseVertex = glad_glDrawElementsBaseVertex; if (glad_glDrawElementsBaseVertex) glad_glDrawElementsBaseVertex = glad_stats_glDrawElementsBaseVertex;
+	glad_stats_real_glDrawElementsInstancedBaseVertex = glad_glDrawElementsInstancedBaseVertex; if (glad_glDrawElementsInstancedBaseVertex) glad_glDrawElementsInstancedBaseVertex = glad_stats_glDrawElementsInstancedBaseVertex;
+	glad_stats_real_glDrawRangeElementsBaseVertex = glad_glDrawRangeElementsBaseVertex; if (glad_glDrawRangeElementsBaseVertex) glad_glDrawRangeElementsBaseVertex = glad_stats_glDrawRangeElementsBaseVertex;
+	glad_stats_real_glUseProgram = glad_glUseProgram; if (glad_glUseProgram) glad_glUseProgram = glad_stats_glUseProgram;
+	glad_stats_real_glGetUniformLocation = glad_glGetUniformLocation; if (glad_glGetUniformLocation) glad_glGetUniformLocation = glad_stats_glGetUniformLocation;
+	glad_stats_real_glBindTexture = glad_glBindTexture; if (glad_glBindTexture) glad_glBindTexture = glad_stats_glBindTexture;
+	glad_stats_real_glBindBuffer = glad_glBindBuffer; if (glad_glBindBuffer) glad_glBindBuffer = glad_stats_glBindBuffer;
+	glad_stats_real_glBindVertexArray = glad_glBindVertexArray; if (glad_glBindVertexArray) glad_glBindVertexArray = glad_stats_glBindVertexArray;
+	glad_stats_real_glBindFramebuffer = glad_glBindFramebuffer; if (glad_glBindFramebuffer) glad_glBindFramebuffer = glad_stats_glBindFramebuffer;
+	glad_stats_real_glEnable = glad_glEnable; if (glad_glEnable) glad_glEnable = glad_stats_glEnable;
+	glad_stats_real_glDisable = glad_glDisable; if (glad_glDisable) glad_glDisable = glad_stats_glDisable;
+	glad_stats_real_glDepthFunc = glad_glDepthFunc; if (glad_glDepthFunc) glad_glDepthFunc = glad_stats_glDepthFunc;
+	glad_stats_real_glDepthMask = glad_glDepthMask; if (glad_glDepthMask) glad_glDepthMask = glad_stats_glDepthMask;
+	glad_stats_real_glBlendFunc = glad_glBlendFunc; if (glad_glBlendFunc) glad_glBlendFunc = glad_stats_glBlendFunc;
+	glad_stats_real_glCullFace = glad_glCullFace; if (glad_glCullFace) glad_glCullFace = glad_stats_glCullFace;
+	glad_stats_real_glViewport = glad_glViewport; if (glad_glViewport) glad_glViewport = glad_stats_glViewport;
+	glad_stats_real_glActiveTexture = glad_glActiveTexture; if (glad_glActiveTexture) glad_glActiveTexture = glad_stats_glActiveTexture;
+	glad_stats_real_glColorMask = glad_glColorMask; if (glad_glColorMask) glad_glColorMask = glad_stats_glColorMask;
+	glad_stats_real_glPolygonMode = glad_glPolygonMode; if (glad_glPolygonMode) glad_glPolygonMode = glad_stats_glPolygonMode;
+	glad_stats_real_glBufferData = glad_glBufferData; if (glad_glBufferData) glad_glBufferData = glad_stats_glBufferData;
+	glad_stats_real_glBufferSubData = glad_glBufferSubData; if (glad_glBufferSubData) glad_glBufferSubData = glad_stats_glBufferSubData;
+	glad_stats_real_glTexImage2D = glad_glTexImage2D; if (glad_glTexImage2D) glad_glTexImage2D = glad_stats_glTexImage2D;
+	glad_stats_real_glTexSubImage2D = glad_glTexSubImage2D; if (glad_glTexSubImage2D) glad_glTexSubImage2D = glad_stats_glTexSubImage2D;
+	glad_stats_real_glClear = glad_glClear; if (glad_glClear) glad_glClear = glad_stats_glClear;
+	glad_stats_real_glUniform1i = glad_glUniform1i; if (glad_glUniform1i) glad_glUniform1i = glad_stats_glUniform1i;
+	glad_stats_real_glUniform1ui = glad_glUniform1ui; if (glad_glUniform1ui) glad_glUniform1ui = glad_stats_glUniform1ui;
+	glad_stats_real_glUniform1f = glad_glUniform1f; if (glad_glUniform1f) glad_glUniform1f = glad_stats_glUniform1f;
+	glad_stats_real_glUniform2f = glad_glUniform2f; if (glad_glUniform2f) glad_glUniform2f = glad_stats_glUniform2f;
+	glad_stats_real_glUniform3f = glad_glUniform3f; if (glad_glUniform3f) glad_glUniform3f = glad_stats_glUniform3f;
+	glad_stats_real_glUniform4f = glad_glUniform4f; if (glad_glUniform4f) glad_glUniform4f = glad_stats_glUniform4f;
+	glad_stats_real_glUniform1iv = glad_glUniform1iv; if (glad_glUniform1iv) glad_glUniform1iv = glad_stats_glUniform1iv;
+	glad_stats_real_glUniform1fv = glad_glUniform1fv; if (glad_glUniform1fv) glad_glUniform1fv = glad_stats_glUniform1fv;
+	glad_stats_real_glUniform2fv = glad_glUniform2fv; if (glad_glUniform2fv) glad_glUniform2fv = glad_stats_glUniform2fv;
+	glad_stats_real_glUniform3fv = glad_glUniform3fv; if (glad_glUniform3fv) glad_glUniform3fv = glad_stats_glUniform3fv;
+	glad_stats_real_glUniform4fv = glad_glUniform4fv; if (glad_glUniform4fv) glad_glUniform4fv = glad_stats_glUniform4fv;
+	glad_stats_real_glUniformMatrix3fv = glad_glUniformMatrix3fv; if (glad_glUniformMatrix3fv) glad_glUniformMatrix3fv = glad_stats_glUniformMatrix3fv;
+	glad_stats_real_glUniformMatrix4fv = glad_glUniformMatrix4fv; if (glad_glUniformMatrix4fv) glad_glUniformMatrix4fv = glad_stats_glUniformMatrix4fv;
+}
+#endif
+
@@ -1,5 +1,7 @@
 #version 330 core
-out vec4 FragColor;
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out uint ObjectID; // Picking ID, only stored when the ID attachment is enabled
+layout (location = 2) out vec2 Velocity; // Screen motion since the last frame in UV units, stored for TAA
 
 struct DirLight {
     vec3 direction;
@@ -22,50 +24,31 @@ in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoord;
 in vec4 FragPosLightSpace; // NEW
+in vec4 CurrentClip;
+in vec4 PreviousClip;
 
 uniform vec3 viewPos;
 uniform sampler2D texture_diffuse1;
-uniform sampler2D shadowMap; // NEW: The Depth Texture
+uniform float lodBias; // mip bias, raised by the quality governor
+uniform uint objectID;
 
+// Specialized per draw by ShaderVariants: the number of shaded point lights and whether the
+// object receives the sun's shadow. Defaults are for compiling the file on its own.
+#ifndef NR_POINT_LIGHTS
 #define NR_POINT_LIGHTS 4
+#endif
+#ifndef SHADOWS
+#define SHADOWS 1
+#endif
+
 uniform DirLight dirLight;
+#if NR_POINT_LIGHTS > 0
 uniform PointLight pointLights[NR_POINT_LIGHTS];
+#endif
 
-// NEW: Shadow Calculation
-float ShadowCalculation(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir)
-{
-    // perform perspective divide
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
-    // transform to [0,1] range
-    projCoords = projCoords * 0.5 + 0.5;
-    
-    // get closest depth value from light's perspective (using [0,1] range fragPosLight as coords)
-    float closestDepth = texture(shadowMap, projCoords.xy).r; 
-    // get depth of current fragment from light's perspective
-    float currentDepth = projCoords.z;
-    
-    // Shadow Bias (removes "Shadow Acne" patterns)
-    float bias = max(0.05 * (1.0 - dot(normal, lightDir)), 0.005);  
-
-    // PCF (Percentage-closer filtering) for softer edges
-    float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
-    for(int x = -1; x <= 1; ++x)
-    {
-        for(int y = -1; y <= 1; ++y)
-        {
-            float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r; 
-            shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;        
-        }    
-    }
-    shadow /= 9.0;
-    
-    // Keep the shadow at 0.0 when outside the far_plane region of the light's frustum.
-    if(projCoords.z > 1.0)
-        shadow = 0.0;
-        
-    return shadow;
-}
+#if SHADOWS
+#include "shadow.glsl"
+#endif
 
 vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir)
 {
@@ -74,18 +57,22 @@ vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir)
     vec3 reflectDir = reflect(-lightDir, normal);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
     
-    vec3 ambient = light.ambient * vec3(texture(texture_diffuse1, TexCoord));
-    vec3 diffuse = light.diffuse * diff * vec3(texture(texture_diffuse1, TexCoord));
-    vec3 specular = light.specular * spec * vec3(texture(texture_diffuse1, TexCoord));
+    vec3 ambient = light.ambient * vec3(texture(texture_diffuse1, TexCoord, lodBias));
+    vec3 diffuse = light.diffuse * diff * vec3(texture(texture_diffuse1, TexCoord, lodBias));
+    vec3 specular = light.specular * spec * vec3(texture(texture_diffuse1, TexCoord, lodBias));
     
+#if SHADOWS
     // Calculate Shadow (1.0 = shadow, 0.0 = no shadow)
     float shadow = ShadowCalculation(FragPosLightSpace, normal, lightDir);
     
     // Apply Shadow to Diffuse and Specular (Ambient is never shadowed)
     return (ambient + (1.0 - shadow) * (diffuse + specular));
+#else
+    return (ambient + diffuse + specular);
+#endif
 }
 
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+vec3 CalcPointLight(PointLight light, int index, vec3 normal, vec3 fragPos, vec3 viewDir)
 {
     vec3 lightDir = normalize(light.position - fragPos);
     float diff = max(dot(normal, lightDir), 0.0);
@@ -93,13 +80,18 @@ vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
     float distance = length(light.position - fragPos);
     float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));    
-    vec3 ambient = light.ambient * vec3(texture(texture_diffuse1, TexCoord));
-    vec3 diffuse = light.diffuse * diff * vec3(texture(texture_diffuse1, TexCoord));
-    vec3 specular = light.specular * spec * vec3(texture(texture_diffuse1, TexCoord));
+    vec3 ambient = light.ambient * vec3(texture(texture_diffuse1, TexCoord, lodBias));
+    vec3 diffuse = light.diffuse * diff * vec3(texture(texture_diffuse1, TexCoord, lodBias));
+    vec3 specular = light.specular * spec * vec3(texture(texture_diffuse1, TexCoord, lodBias));
     ambient *= attenuation;
     diffuse *= attenuation;
     specular *= attenuation;
+#if SHADOWS && NR_POINT_LIGHTS > 0
+    float shadow = PointShadowCalculation(index, light.position, fragPos, normal);
+    return (ambient + (1.0 - shadow) * (diffuse + specular));
+#else
     return (ambient + diffuse + specular);
+#endif
 }
 
 void main()
@@ -109,8 +101,12 @@ void main()
     
     vec3 result = CalcDirLight(dirLight, norm, viewDir);
     
+#if NR_POINT_LIGHTS > 0
     for(int i = 0; i < NR_POINT_LIGHTS; i++)
-        result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);    
+        result += CalcPointLight(pointLights[i], i, norm, FragPos, viewDir);    
+#endif
     
     FragColor = vec4(result, 1.0);
+    ObjectID = objectID;
+    Velocity = (CurrentClip.xy / CurrentClip.w - PreviousClip.xy / PreviousClip.w) * 0.5;
 }
\ No newline at end of file
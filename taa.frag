@@ -0,0 +1,81 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D screenTexture;  // this frame, drawn jittered into its lower left renderSize texels
+uniform sampler2D velocityBuffer; // same layout: UV motion since the last frame
+uniform sampler2D sceneDepth;     // same layout
+uniform sampler2D history;        // last frame's result at the output size
+uniform vec2 renderSize;
+uniform vec2 jitter;              // this frame's offset in scene pixels
+uniform float historyValid;       // 0 after a reset: take the current frame as is
+
+// Temporal anti-aliasing and upsampling. The output pixel is reconstructed from the 3x3 scene
+// texels around it (each at its jittered position), the history is fetched where the pixel was
+// last frame and clamped to the colors of that neighborhood, so anything it disagrees with
+// (disocclusion, lighting changes) is rejected instead of ghosting. The history has the output's
+// size whatever the render scale, so a lower scale still converges to a full resolution image.
+
+vec3 fetch(ivec2 p) { return texelFetch(screenTexture, clamp(p, ivec2(0), ivec2(renderSize) - 1), 0).rgb; }
+
+// Catmull-Rom history fetch from 5 bilinear taps (the corners' weights are negligible)
+vec3 sampleHistory(vec2 uv)
+{
+    vec2 size = vec2(textureSize(history, 0));
+    vec2 pos = uv * size;
+    vec2 center = floor(pos - 0.5) + 0.5;
+    vec2 f = pos - center;
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+    vec2 w12 = w1 + w2;
+    vec2 tc0 = (center - 1.0) / size, tc3 = (center + 2.0) / size;
+    vec2 tc12 = (center + w2 / w12) / size;
+    vec3 result = texture(history, vec2(tc12.x, tc0.y)).rgb * (w12.x * w0.y)
+                + texture(history, vec2(tc0.x, tc12.y)).rgb * (w0.x * w12.y)
+                + texture(history, tc12).rgb * (w12.x * w12.y)
+                + texture(history, vec2(tc3.x, tc12.y)).rgb * (w3.x * w12.y)
+                + texture(history, vec2(tc12.x, tc3.y)).rgb * (w12.x * w3.y);
+    float total = w12.x * w0.y + w0.x * w12.y + w12.x * w12.y + w3.x * w12.y + w12.x * w3.y;
+    return max(result / total, vec3(0.0));
+}
+
+void main()
+{
+    // The output pixel in scene pixels, and the scene texel whose jittered sample is nearest
+    vec2 pos = TexCoords * renderSize;
+    ivec2 center = ivec2(floor(pos + jitter));
+
+    vec3 sum = vec3(0.0), lo = vec3(1e9), hi = vec3(-1e9);
+    float total = 0.0, nearest = 0.0, closestDepth = 2.0;
+    ivec2 closest = center;
+    for (int y = -1; y <= 1; y++) {
+        for (int x = -1; x <= 1; x++) {
+            ivec2 p = center + ivec2(x, y);
+            vec3 c = fetch(p);
+            vec2 d = vec2(p) + 0.5 - jitter - pos;
+            float w = exp(-2.29 * dot(d, d)); // Blackman-Harris approximated by a Gaussian
+            sum += c * w;
+            total += w;
+            nearest = max(nearest, w);
+            lo = min(lo, c);
+            hi = max(hi, c);
+            // Motion of the nearest surface: edges of moving objects carry their own velocity
+            float depth = texelFetch(sceneDepth, clamp(p, ivec2(0), ivec2(renderSize) - 1), 0).r;
+            if (depth < closestDepth) { closestDepth = depth; closest = p; }
+        }
+    }
+    vec3 current = sum / total;
+
+    vec2 velocity = texelFetch(velocityBuffer, clamp(closest, ivec2(0), ivec2(renderSize) - 1), 0).rg;
+    vec2 previous = TexCoords - velocity;
+    float valid = historyValid * (all(greaterThanEqual(previous, vec2(0.0))) && all(lessThanEqual(previous, vec2(1.0))) ? 1.0 : 0.0);
+    vec3 past = clamp(sampleHistory(previous), lo, hi);
+
+    // A sample right on the pixel counts for 10%; the further the nearest one is (upsampling),
+    // the more the history is trusted
+    float blend = valid > 0.0 ? max(0.1 * nearest, 0.02) : 1.0;
+    FragColor = vec4(mix(past, current, blend), 1.0);
+}
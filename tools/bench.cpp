@@ -0,0 +1,454 @@
+// Headless, reproducible frame benchmark: renders a scene offscreen along a camera path and
+// reports frame-time percentiles, per-pass CPU/GPU timings and draw/state counters as JSON.
+// Runs without a window or GPU (EGL surfaceless, e.g. Mesa llvmpipe).
+//
+// Usage: MyGraphicsEngineBench --scene <file.scene> [options]
+//   --path <file.path>     camera path recorded in the editor (Tools > Record Camera Path);
+//                          without one the camera orbits the scene origin
+//   --frames N             measured frames (default 300), spread evenly over the path
+//   --warmup N             unmeasured frames first (default 30)
+//   --width W --height H   render resolution (default 1200x800)
+//   --out <file.json>      results file (default bench_results.json)
+//   --baseline <file.json> compare against an earlier run, exit code 2 on regression
+//   --threshold PCT        allowed slowdown in percent (default 10)
+//   --capture <file.glcap> also record the last warmup frame for MyGraphicsEngineReplay
+//   --hitch-budget MS      dump a trace of the preceding frames (hitch_<frame>.json) when a
+//                          measured frame takes longer than MS
+//   --fail-on-sync LEVEL   watch the measured frames for synchronizing GL calls and exit with
+//                          code 3 if any are made; LEVEL is "blocking" (waits on the GPU) or "all"
+//   --max-allocs N         steady-state allocation check: exit with code 4 if a measured frame
+//                          makes more than N heap allocations (0 = allocation-free frame loop)
+//   --post LIST            post-process chain, comma separated: invert, grayscale, sharpen, edge,
+//                          blur, grade, fxaa; sharpen, edge and blur take ":half" or ":quarter"
+//                          (e.g. blur:half,invert)
+//   --dynamic-res MS       scale the scene's resolution to keep GPU frame time within MS, upscaling
+//                          to the output size (the scale reached is in the results' info)
+//   --taa                  temporal anti-aliasing (with --dynamic-res it also does the upscale)
+//   --shadow-filter NAME   sun shadow filtering: pcf (default), hardware, poisson or evsm; run once
+//                          per tier and compare the Shadow, EVSM and Lighting pass timings
+//   --shadow-depth16       16-bit shadow depth (half float EVSM moments)
+//   --no-point-shadows     point lights cast no shadows
+//   --shadow-updates N     point-light shadow faces redrawn per frame at most (default 6); the
+//                          faces actually redrawn are counters.shadow_faces
+//   --quality-budget MS    let the quality governor lower settings to keep GPU frame time within MS
+//                          (the steps taken are logged; the settings reached are in the results' info).
+//                          A post effect resolution step rebuilds the render graph, which allocates,
+//                          so combine it with --max-allocs 0 only when the budget is met without one
+#include "HeadlessContext.h"
+#include "Renderer.h"
+#include "SceneLoader.h"
+#include "CameraPath.h"
+#include "Profiler.h"
+#include "GLStats.h"
+#include "FrameCapture.h"
+#include "SyncStallDetector.h"
+#include "AllocTracker.h"
+#include "Log.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+struct PassTiming {
+    double cpuMs = 0.0, gpuMs = 0.0;
+    int cpuSamples = 0, gpuSamples = 0;
+};
+
+struct BenchResults {
+    std::vector<double> frameMs;
+    std::map<std::string, PassTiming> passes;
+    double counters[7] = {};
+    std::map<std::string, double> glCounts; // "pass.category", ENGINE_GL_STATS builds only
+};
+
+static const char* COUNTER_NAMES[7] = { "draw_calls", "triangles", "objects", "program_binds", "texture_binds", "framebuffer_binds", "shadow_faces" };
+
+static double percentile(const std::vector<double> &sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = (size_t)std::ceil(q * sorted.size());
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+// Flat "section.key" -> value view of the results, shared by the writer and the comparison
+static std::map<std::string, double> flatten(const BenchResults &r) {
+    std::map<std::string, double> m;
+    std::vector<double> sorted = r.frameMs;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double v : sorted) sum += v;
+    m["frame_ms.mean"] = sorted.empty() ? 0.0 : sum / sorted.size();
+    m["frame_ms.p50"] = percentile(sorted, 0.50);
+    m["frame_ms.p90"] = percentile(sorted, 0.90);
+    m["frame_ms.p95"] = percentile(sorted, 0.95);
+    m["frame_ms.p99"] = percentile(sorted, 0.99);
+    m["frame_ms.max"] = sorted.empty() ? 0.0 : sorted.back();
+    for (std::map<std::string, PassTiming>::const_iterator it = r.passes.begin(); it != r.passes.end(); ++it) {
+        if (it->second.cpuSamples) m["passes." + it->first + ".cpu_ms"] = it->second.cpuMs / it->second.cpuSamples;
+        if (it->second.gpuSamples) m["passes." + it->first + ".gpu_ms"] = it->second.gpuMs / it->second.gpuSamples;
+    }
+    double frames = r.frameMs.empty() ? 1.0 : (double)r.frameMs.size();
+    for (int i = 0; i < 7; i++) m[std::string("counters.") + COUNTER_NAMES[i]] = r.counters[i] / frames;
+    for (std::map<std::string, double>::const_iterator it = r.glCounts.begin(); it != r.glCounts.end(); ++it) m["counters.gl." + it->first] = it->second / frames;
+    return m;
+}
+
+// Writes the flat map back as nested JSON objects (keys are sorted, so sections are contiguous)
+static bool writeJson(const std::string &path, const std::map<std::string, double> &values, const std::map<std::string, std::string> &info) {
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+    out << "{";
+    bool first = true;
+    for (std::map<std::string, std::string>::const_iterator it = info.begin(); it != info.end(); ++it) {
+        out << (first ? "" : ",") << "\n  \"" << it->first << "\": \"" << it->second << "\"";
+        first = false;
+    }
+    std::vector<std::string> open;
+    for (std::map<std::string, double>::const_iterator it = values.begin(); it != values.end(); ++it) {
+        std::vector<std::string> parts;
+        std::stringstream ss(it->first); std::string part;
+        while (std::getline(ss, part, '.')) parts.push_back(part);
+        size_t common = 0;
+        while (common < open.size() && common + 1 < parts.size() && open[common] == parts[common]) common++;
+        while (open.size() > common) { out << "\n" << std::string(2 * open.size(), ' ') << "}"; open.pop_back(); first = false; }
+        for (size_t i = common; i + 1 < parts.size(); i++) {
+            out << (first ? "" : ",") << "\n" << std::string(2 * open.size() + 2, ' ') << "\"" << parts[i] << "\": {";
+            open.push_back(parts[i]);
+            first = true;
+        }
+        char number[64];
+        std::snprintf(number, sizeof(number), "%.4f", it->second);
+        out << (first ? "" : ",") << "\n" << std::string(2 * open.size() + 2, ' ') << "\"" << parts.back() << "\": " << number;
+        first = false;
+    }
+    while (!open.empty()) { out << "\n" << std::string(2 * open.size(), ' ') << "}"; open.pop_back(); }
+    out << "\n}\n";
+    return out.good();
+}
+
+// Minimal reader for the files writeJson produces: nested objects of numbers and strings
+static bool readJson(const std::string &path, std::map<std::string, double> &values) {
+    std::ifstream in(path);
+    if (!in.is_open()) return false;
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<std::string> scope;
+    std::string key;
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (c == '"') {
+            size_t end = text.find('"', i + 1);
+            if (end == std::string::npos) return false;
+            std::string s = text.substr(i + 1, end - i - 1);
+            i = end;
+            size_t next = text.find_first_not_of(" \t\r\n", i + 1);
+            if (next != std::string::npos && text[next] == ':') key = s; // otherwise a string value, ignored
+        } else if (c == '{') {
+            if (!key.empty()) scope.push_back(key);
+            key.clear();
+        } else if (c == '}') {
+            if (!scope.empty()) scope.pop_back();
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            char *end = nullptr;
+            double v = std::strtod(text.c_str() + i, &end);
+            std::string full;
+            for (const std::string &s : scope) full += s + ".";
+            values[full + key] = v;
+            i = (size_t)(end - text.c_str()) - 1;
+        }
+    }
+    return true;
+}
+
+// Lower is better for everything we report; timings get a relative threshold plus a small
+// absolute floor so sub-0.05 ms passes do not flag on noise, counters must not grow at all.
+static int compareWithBaseline(const std::map<std::string, double> &current, const std::map<std::string, double> &baseline, double thresholdPct) {
+    int regressions = 0;
+    std::printf("\n%-36s %12s %12s %9s\n", "metric", "baseline", "current", "change");
+    for (std::map<std::string, double>::const_iterator it = current.begin(); it != current.end(); ++it) {
+        std::map<std::string, double>::const_iterator base = baseline.find(it->first);
+        if (base == baseline.end()) continue;
+        bool counter = it->first.compare(0, 9, "counters.") == 0;
+        double change = base->second != 0.0 ? (it->second - base->second) / base->second * 100.0 : 0.0;
+        bool regressed = counter ? it->second > base->second + 1e-6
+                                 : change > thresholdPct && it->second - base->second > 0.05;
+        if (regressed) regressions++;
+        std::printf("%-36s %12.4f %12.4f %+8.1f%% %s\n", it->first.c_str(), base->second, it->second, change, regressed ? "REGRESSION" : "");
+    }
+    return regressions;
+}
+
+// "blur:half,invert" -> chain effects; false on an unknown name
+static bool parsePostChain(const std::string &list, PostChain &chain) {
+    static const char *names[] = { "invert", "grayscale", "sharpen", "edge", "blur", "grade", "fxaa" };
+    std::stringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        size_t colon = item.find(':');
+        std::string name = item.substr(0, colon), scale = colon == std::string::npos ? "" : item.substr(colon + 1);
+        PostEffect effect;
+        int type = 0;
+        while (type < POST_EFFECT_TYPES && name != names[type]) type++;
+        if (type == POST_EFFECT_TYPES) return false;
+        effect.type = (PostEffectType)type;
+        if (scale == "half") effect.scale = POST_HALF;
+        else if (scale == "quarter") effect.scale = POST_QUARTER;
+        else if (!scale.empty()) return false;
+        chain.effects.push_back(effect);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string scenePath, pathFile, outPath = "bench_results.json", baselinePath, capturePath, failOnSync, postList;
+    double dynamicResMs = 0.0, qualityBudgetMs = 0.0;
+    int frames = 300, warmup = 30, width = 1200, height = 800;
+    double threshold = 10.0, hitchBudget = 0.0;
+    long long maxAllocs = -1;
+    bool taa = false, shadowDepth16 = false, pointShadows = true;
+    int shadowUpdates = 6;
+    int shadowFilter = SHADOW_FILTER_PCF;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--scene" && hasValue) scenePath = argv[++i];
+        else if (arg == "--path" && hasValue) pathFile = argv[++i];
+        else if (arg == "--frames" && hasValue) frames = std::atoi(argv[++i]);
+        else if (arg == "--warmup" && hasValue) warmup = std::atoi(argv[++i]);
+        else if (arg == "--width" && hasValue) width = std::atoi(argv[++i]);
+        else if (arg == "--height" && hasValue) height = std::atoi(argv[++i]);
+        else if (arg == "--out" && hasValue) outPath = argv[++i];
+        else if (arg == "--baseline" && hasValue) baselinePath = argv[++i];
+        else if (arg == "--threshold" && hasValue) threshold = std::atof(argv[++i]);
+        else if (arg == "--capture" && hasValue) capturePath = argv[++i];
+        else if (arg == "--hitch-budget" && hasValue) hitchBudget = std::atof(argv[++i]);
+        else if (arg == "--fail-on-sync" && hasValue) failOnSync = argv[++i];
+        else if (arg == "--max-allocs" && hasValue) maxAllocs = std::atoll(argv[++i]);
+        else if (arg == "--post" && hasValue) postList = argv[++i];
+        else if (arg == "--dynamic-res" && hasValue) dynamicResMs = std::atof(argv[++i]);
+        else if (arg == "--quality-budget" && hasValue) qualityBudgetMs = std::atof(argv[++i]);
+        else if (arg == "--taa") taa = true;
+        else if (arg == "--shadow-filter" && hasValue) {
+            std::string name = argv[++i];
+            const char *names[] = { "pcf", "hardware", "poisson", "evsm" };
+            shadowFilter = -1;
+            for (int f = 0; f < SHADOW_FILTER_COUNT; f++) if (name == names[f]) shadowFilter = f;
+            if (shadowFilter < 0) { std::printf("Unknown shadow filter: %s\n", name.c_str()); return 1; }
+        }
+        else if (arg == "--shadow-depth16") shadowDepth16 = true;
+        else if (arg == "--no-point-shadows") pointShadows = false;
+        else if (arg == "--shadow-updates" && hasValue) shadowUpdates = std::atoi(argv[++i]);
+        else { std::printf("Unknown or incomplete option: %s\n", arg.c_str()); return 1; }
+    }
+    if (scenePath.empty() || frames <= 0 || width <= 0 || height <= 0 || (!failOnSync.empty() && failOnSync != "blocking" && failOnSync != "all")) {
+        std::printf("Usage: %s --scene <file.scene> [--path <file.path>] [--frames N] [--warmup N] [--width W] [--height H] [--out <file.json>] [--baseline <file.json>] [--threshold PCT] [--capture <file.glcap>] [--hitch-budget MS] [--fail-on-sync blocking|all] [--max-allocs N] [--post LIST] [--dynamic-res MS] [--quality-budget MS] [--taa] [--shadow-filter pcf|hardware|poisson|evsm] [--shadow-depth16] [--no-point-shadows] [--shadow-updates N]\n", argv[0]);
+        return 1;
+    }
+
+    HeadlessContext context;
+    if (!context.Create()) return 1;
+    Profiler::Get().EnableGpu();
+    std::printf("Renderer: %s\n", context.Renderer());
+
+    Renderer renderer;
+    if (!renderer.Init(width, height)) return 1;
+    renderer.writeObjectIDs = false; // no picking in the benchmark
+    if (!parsePostChain(postList, renderer.post)) { std::printf("Unknown post effect in: %s\n", postList.c_str()); return 1; }
+    renderer.taa = taa;
+    renderer.shadowFilter = (ShadowFilter)shadowFilter;
+    renderer.shadowDepth16 = shadowDepth16;
+    renderer.pointShadows = pointShadows;
+    renderer.pointShadowAtlas.maxUpdates = shadowUpdates;
+    if (dynamicResMs > 0.0) {
+        renderer.resolution.enabled = true;
+        renderer.resolution.budgetMs = (float)dynamicResMs;
+    }
+    if (qualityBudgetMs > 0.0) {
+        renderer.quality.enabled = true;
+        renderer.quality.budgetMs = (float)qualityBudgetMs;
+    }
+
+    // Present into an offscreen target, there is no window framebuffer
+    unsigned int outputFBO, outputTexture;
+    glGenFramebuffers(1, &outputFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFBO);
+    glGenTextures(1, &outputTexture);
+    glBindTexture(GL_TEXTURE_2D, outputTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, outputTexture, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    ModelLibrary library;
+    std::vector<GameObject> objects;
+    std::vector<SceneLight> pointLights = DefaultPointLights();
+    RenderScene scene;
+    scene.objects = &objects;
+    auto loadStart = std::chrono::steady_clock::now();
+    if (!LoadSceneObjects(scenePath.c_str(), library, library.Get("cube.obj"), objects, scene.sunDirection, scene.sunColor, &pointLights)) {
+        std::printf("Failed to load scene %s\n", scenePath.c_str());
+        return 1;
+    }
+    scene.pointLights = pointLights.data();
+    scene.pointLightCount = (int)pointLights.size();
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+    Log::Get().Flush(); // asset warnings before our own output
+    std::printf("Loaded %zu objects in %.1f ms\n", objects.size(), loadMs);
+
+    CameraPath path;
+    if (!pathFile.empty() && !path.Load(pathFile)) { std::printf("Failed to load camera path %s\n", pathFile.c_str()); return 1; }
+    if (path.keys.empty()) {
+        // Default flythrough: one orbit around the origin, looking at it
+        for (int i = 0; i <= 32; i++) {
+            float a = i / 32.0f * 6.2831853f;
+            CameraKey key = { (float)i, glm::vec3(std::cos(a) * 8.0f, 3.0f, std::sin(a) * 8.0f), glm::degrees(a) + 180.0f, -20.0f, ZOOM };
+            path.keys.push_back(key);
+        }
+    }
+
+    Camera camera;
+    BenchResults results;
+    Profiler &profiler = Profiler::Get();
+    SyncStallDetector &sync = SyncStallDetector::Get();
+    AllocTracker &allocs = AllocTracker::Get();
+    uint64_t allocTotal = 0, allocWorst = 0;
+    int allocFailures = 0;
+    results.frameMs.reserve(frames);
+    if (hitchBudget > 0.0) profiler.SetHitchRecorder(Profiler::HISTORY, (float)hitchBudget, "hitch_");
+    uint64_t firstMeasured = 0, lastMeasured = 0;
+    int total = warmup + frames;
+    int captureFrame = std::max(warmup - 1, 0); // capturing slows its frame down, keep it out of the results if we can
+    // Two extra frames at the end only collect the last GPU timer results
+    for (int f = 0; f < total + 2; f++) {
+        bool drain = f >= total;
+        if (f == warmup && !failOnSync.empty()) sync.SetEnabled(true); // measured frames only
+        if (f == warmup && maxAllocs >= 0) AllocSetSampleRate(1);
+        allocs.BeginFrame();
+        profiler.BeginFrame();
+        GLStats::Get().BeginFrame();
+        if (f == captureFrame && !capturePath.empty()) FrameCapture::Get().Request(capturePath, width, height);
+        FrameCapture::Get().BeginFrame();
+        auto start = std::chrono::steady_clock::now();
+        if (!drain) {
+            int measured = std::max(f - warmup, 0);
+            path.Sample(frames > 1 ? path.Duration() * measured / (frames - 1) : 0.0f, camera);
+            glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)width / (float)height, 0.1f, 100.0f);
+            renderer.DrawFrame(scene, camera.Position, camera.GetViewMatrix(), projection, outputFBO, width, height);
+            FrameCapture::Get().EndFrame();
+            SyncStallDetector::Ignore ownWait;
+            glFinish(); // no swap chain to throttle us: time the frame to completion
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        profiler.SetHitchBudget(f >= warmup ? (float)hitchBudget : 0.0f); // warmup frames never count as hitches
+        sync.EndFrame();
+        if (f == total - 1) sync.SetEnabled(false);
+        GLStats::Get().EndFrame();
+        profiler.EndFrame();
+        allocs.EndFrame();
+
+        bool measuring = !drain && f >= warmup;
+        if (measuring) {
+            uint64_t n = allocs.LastFrame().allocations;
+            allocTotal += n;
+            allocWorst = std::max(allocWorst, n);
+            if (maxAllocs >= 0 && n > (uint64_t)maxAllocs) allocFailures++;
+            if (f == warmup) firstMeasured = profiler.FrameIndex();
+            lastMeasured = profiler.FrameIndex();
+            results.frameMs.push_back(ms);
+            const RenderCounters &c = renderer.counters;
+            results.counters[0] += c.drawCalls; results.counters[1] += c.triangles; results.counters[2] += c.objects;
+            results.counters[3] += c.programBinds; results.counters[4] += c.textureBinds; results.counters[5] += c.framebufferBinds;
+            results.counters[6] += c.shadowFaces;
+            for (const GLStats::Pass &p : GLStats::Get().LastFrame())
+                for (int i = 0; i < GL_STATS_CATEGORY_COUNT; i++) results.glCounts[std::string(p.name) + "." + GLStatsCategoryName(i)] += (double)p.counts[i];
+            for (const ProfileEvent &e : profiler.LastFrameEvents()) {
+                if (e.thread != 0 || e.depth != 0) continue;
+                PassTiming &t = results.passes[e.name];
+                t.cpuMs += e.duration / 1e6; t.cpuSamples++;
+            }
+        }
+        for (const ProfileEvent &e : profiler.LastGpuEvents()) {
+            if (firstMeasured == 0 || e.frame < firstMeasured || e.frame > lastMeasured) continue;
+            PassTiming &t = results.passes[e.name];
+            t.gpuMs += e.duration / 1e6; t.gpuSamples++;
+        }
+    }
+
+    std::map<std::string, double> values = flatten(results);
+    uint64_t syncCalls = 0;
+    int syncFailures = 0;
+    for (const SyncStallDetector::Site &s : sync.Sites()) {
+        syncCalls += s.calls;
+        if (failOnSync == "all" || s.level == SYNC_BLOCKING) syncFailures++;
+    }
+    if (!failOnSync.empty()) values["counters.sync_calls"] = (double)syncCalls / frames;
+    values["counters.heap_allocations"] = (double)allocTotal / frames;
+    values["scene.objects"] = (double)objects.size();
+    values["scene.load_ms"] = loadMs;
+    std::map<std::string, std::string> info;
+    info["renderer"] = context.Renderer();
+    info["scene_file"] = scenePath;
+    info["resolution"] = std::to_string(width) + "x" + std::to_string(height);
+    info["frames"] = std::to_string(frames);
+    info["shadow_filter"] = std::string(ShadowFilterName(renderer.shadowFilter)) + (renderer.shadowDepth16 ? ", 16-bit depth" : "");
+    info["point_shadows"] = renderer.pointShadows ? "on, " + std::to_string(renderer.pointShadowAtlas.maxUpdates) + " faces per frame" : "off";
+    if (renderer.resolution.enabled) {
+        char text[64];
+        std::snprintf(text, sizeof(text), "scale %.2f (%dx%d)", renderer.resolution.Scale(), renderer.SceneWidth(), renderer.SceneHeight());
+        info["dynamic_resolution"] = text;
+    }
+    if (renderer.quality.enabled) {
+        std::string steps;
+        for (int i = 0; i < renderer.quality.Knobs(); i++)
+            if (renderer.quality.Drop(i)) steps += (steps.empty() ? "" : ", ") + std::string(renderer.quality.Name(i)) + " -" + std::to_string(renderer.quality.Drop(i));
+        info["quality_steps"] = steps.empty() ? "none" : steps;
+    }
+    if (!writeJson(outPath, values, info)) { std::printf("Failed to write %s\n", outPath.c_str()); return 1; }
+
+    std::printf("%d frames: mean %.3f ms  p50 %.3f  p95 %.3f  p99 %.3f  max %.3f\n", frames,
+        values["frame_ms.mean"], values["frame_ms.p50"], values["frame_ms.p95"], values["frame_ms.p99"], values["frame_ms.max"]);
+    for (std::map<std::string, PassTiming>::const_iterator it = results.passes.begin(); it != results.passes.end(); ++it)
+        std::printf("  %-12s cpu %8.3f ms  gpu %8.3f ms\n", it->first.c_str(),
+            it->second.cpuSamples ? it->second.cpuMs / it->second.cpuSamples : 0.0, it->second.gpuSamples ? it->second.gpuMs / it->second.gpuSamples : 0.0);
+    if (!sync.Sites().empty()) {
+        std::printf("GL sync calls in measured frames (per frame):\n");
+        for (const SyncStallDetector::Site &s : sync.Sites())
+            std::printf("  %-24s %-10s %-14s %8.1f calls %8.3f ms  %s\n", SyncCallName(s.call), s.level == SYNC_BLOCKING ? "blocking" : "round trip",
+                s.zone ? s.zone : "-", (double)s.calls / frames, s.totalNs / 1e6 / frames, s.symbol.c_str());
+    }
+    if (renderer.resolution.enabled) std::printf("Dynamic resolution: %s\n", info["dynamic_resolution"].c_str());
+    if (renderer.quality.enabled) std::printf("Quality steps down: %s\n", info["quality_steps"].c_str());
+    std::printf("Heap allocations per frame: mean %.1f  max %llu\n", (double)allocTotal / frames, (unsigned long long)allocWorst);
+    if (allocFailures) {
+        // Sampling took every allocation of the measured frames
+        allocs.Symbolize();
+        std::vector<AllocTracker::Site> sites = allocs.Sites();
+        std::sort(sites.begin(), sites.end(), [](const AllocTracker::Site &a, const AllocTracker::Site &b) { return a.samples > b.samples; });
+        std::printf("Allocation sites in measured frames (per frame):\n");
+        for (size_t i = 0; i < sites.size() && i < 20; i++)
+            std::printf("  %8.1f allocs %10.1f bytes  %s\n", (double)sites[i].samples / frames, (double)sites[i].bytes / frames, sites[i].symbol.c_str());
+    }
+    if (profiler.HitchDumps()) std::printf("%d hitch trace(s) written, last %s\n", profiler.HitchDumps(), profiler.LastHitchFile().c_str());
+    std::printf("Results written to %s\n", outPath.c_str());
+
+    if (!baselinePath.empty()) {
+        std::map<std::string, double> baseline;
+        if (!readJson(baselinePath, baseline)) { std::printf("Failed to read baseline %s\n", baselinePath.c_str()); return 1; }
+        // Scene facts are not performance; only compare like with like
+        values.erase("scene.objects"); values.erase("scene.load_ms");
+        int regressions = compareWithBaseline(values, baseline, threshold);
+        if (regressions) { std::printf("\n%d regression(s) against %s (threshold %.1f%%)\n", regressions, baselinePath.c_str(), threshold); return 2; }
+        std::printf("\nNo regressions against %s\n", baselinePath.c_str());
+    }
+    if (allocFailures) { std::printf("\n%d frame(s) over --max-allocs %lld\n", allocFailures, maxAllocs); return 4; }
+    if (syncFailures) { std::printf("\n%d GL sync call site(s) in the measured frames (--fail-on-sync %s)\n", syncFailures, failOnSync.c_str()); return 3; }
+    return 0;
+}
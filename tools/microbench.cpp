@@ -0,0 +1,232 @@
+// Microbenchmarks for the engine's CPU hot paths, at sizes from 1 to ~1M.
+// No GL context is created: everything measured here is CPU-only work.
+// Usage: MyGraphicsEngineMicroBench [--filter=substring] [--min_time=seconds] [--json=out.json] [--baseline=old.json]
+#include "MicroBench.h"
+#include "GameObject.h"
+#include "Model.h"
+#include "SceneFile.h"
+#include "SceneLoader.h"
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+
+const int64_t MAX_SIZE = 1 << 20;
+
+// --- Fixtures ---
+
+static std::vector<GameObject> makeObjects(int64_t count, Model *model) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> pos(-50.0f, 50.0f), angle(0.0f, 360.0f), size(0.5f, 3.0f);
+    std::vector<GameObject> objects;
+    objects.reserve((size_t)count);
+    for (int64_t i = 0; i < count; i++) {
+        objects.emplace_back("Object", model);
+        objects.back().position = glm::vec3(pos(rng), pos(rng) * 0.1f, pos(rng));
+        objects.back().rotation = glm::vec3(0.0f, angle(rng), 0.0f);
+        objects.back().scale = glm::vec3(size(rng));
+    }
+    return objects;
+}
+
+// A bumpy unit grid in XZ with (at least) 'triangles' triangles, built without GL
+static Model* makeGridModel(int64_t triangles) {
+    int side = std::max(1, (int)std::ceil(std::sqrt((triangles + 1) / 2.0)));
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    vertices.reserve((size_t)(side + 1) * (side + 1));
+    for (int z = 0; z <= side; z++) {
+        for (int x = 0; x <= side; x++) {
+            Vertex v;
+            float fx = (float)x / side - 0.5f, fz = (float)z / side - 0.5f;
+            v.Position = glm::vec3(fx, 0.05f * std::sin(fx * 40.0f) * std::cos(fz * 40.0f), fz);
+            v.Normal = glm::vec3(0.0f, 1.0f, 0.0f);
+            v.TexCoords = glm::vec2(fx + 0.5f, fz + 0.5f);
+            vertices.push_back(v);
+        }
+    }
+    for (int z = 0; z < side && (int64_t)indices.size() < triangles * 3; z++) {
+        for (int x = 0; x < side && (int64_t)indices.size() < triangles * 3; x++) {
+            unsigned int i0 = z * (side + 1) + x, i1 = i0 + 1, i2 = i0 + side + 1, i3 = i2 + 1;
+            unsigned int quad[6] = { i0, i2, i1, i1, i2, i3 };
+            for (int k = 0; k < 6 && (int64_t)indices.size() < triangles * 3; k++) indices.push_back(quad[k]);
+        }
+    }
+    Model *model = new Model();
+    model->meshes.push_back(Mesh(vertices, indices, std::vector<TextureStruct>(), false));
+    return model;
+}
+
+// Stands in for cube.obj (12 triangles)
+static Model* sharedPickModel() {
+    static std::unique_ptr<Model> model(makeGridModel(12));
+    return model.get();
+}
+
+// --- GameObject::Draw transform build ---
+
+static void BM_GameObjectModelMatrix(BenchState &state) {
+    std::vector<GameObject> objects = makeObjects(state.range(), sharedPickModel());
+    for (auto _ : state) {
+        for (const GameObject &obj : objects) {
+            glm::mat4 m = obj.GetModelMatrix();
+            BenchDoNotOptimize(m);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range());
+}
+MICROBENCH(BM_GameObjectModelMatrix)->Range(1, MAX_SIZE);
+
+// --- IntersectRay picking ---
+
+// One ray against N objects, the editor's click-to-select loop
+static void BM_PickRayVsObjects(BenchState &state) {
+    std::vector<GameObject> objects = makeObjects(state.range(), sharedPickModel());
+    glm::vec3 origin(0.0f, 20.0f, 60.0f), dir = glm::normalize(glm::vec3(0.1f, -0.3f, -1.0f));
+    for (auto _ : state) {
+        RayHit hit; hit.distance = 1000.0f;
+        int hitIndex = -1;
+        for (size_t i = 0; i < objects.size(); i++)
+            if (objects[i].IntersectRay(origin, dir, hit)) hitIndex = (int)i;
+        BenchDoNotOptimize(hitIndex);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range());
+}
+MICROBENCH(BM_PickRayVsObjects)->Range(1, MAX_SIZE);
+
+// Random downward rays against one mesh of N triangles (per-mesh BVH traversal)
+static void BM_PickRayVsMesh(BenchState &state) {
+    std::unique_ptr<Model> model(makeGridModel(state.range()));
+    GameObject obj("Grid", model.get());
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> spot(-0.5f, 0.5f);
+    std::vector<glm::vec3> origins(256);
+    for (glm::vec3 &o : origins) o = glm::vec3(spot(rng), 2.0f, spot(rng));
+    size_t next = 0;
+    for (auto _ : state) {
+        RayHit hit;
+        bool found = obj.IntersectRay(origins[next++ & 255], glm::vec3(0.0f, -1.0f, 0.0f), hit);
+        BenchDoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+MICROBENCH(BM_PickRayVsMesh)->Range(1, MAX_SIZE);
+
+// --- Model::processMesh vertex conversion ---
+
+static void BM_ConvertMesh(BenchState &state) {
+    unsigned int count = (unsigned int)state.range();
+    // Allocated with new[] because aiMesh owns (and frees) its arrays
+    aiMesh mesh;
+    mesh.mNumVertices = count;
+    mesh.mVertices = new aiVector3D[count];
+    mesh.mNormals = new aiVector3D[count];
+    mesh.mTextureCoords[0] = new aiVector3D[count];
+    for (unsigned int i = 0; i < count; i++) {
+        mesh.mVertices[i].x = (float)i; mesh.mVertices[i].y = 1.0f; mesh.mVertices[i].z = 2.0f;
+        mesh.mNormals[i].x = 0.0f; mesh.mNormals[i].y = 1.0f; mesh.mNormals[i].z = 0.0f;
+        mesh.mTextureCoords[0][i].x = 0.5f; mesh.mTextureCoords[0][i].y = 0.5f; mesh.mTextureCoords[0][i].z = 0.0f;
+    }
+    mesh.mNumFaces = count / 3;
+    mesh.mFaces = new aiFace[mesh.mNumFaces > 0 ? mesh.mNumFaces : 1];
+    for (unsigned int f = 0; f < mesh.mNumFaces; f++) {
+        mesh.mFaces[f].mNumIndices = 3;
+        mesh.mFaces[f].mIndices = new unsigned int[3];
+        for (unsigned int k = 0; k < 3; k++) mesh.mFaces[f].mIndices[k] = f * 3 + k;
+    }
+    for (auto _ : state) {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        Model::ConvertMesh(&mesh, vertices, indices);
+        BenchDoNotOptimize(vertices.data());
+        BenchDoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range());
+}
+MICROBENCH(BM_ConvertMesh)->Range(1, MAX_SIZE);
+
+// --- TextureFromFile decode (the CPU half; the upload needs GL) ---
+
+static const char* TEXTURE_FILES[] = { "wall.jpg", "right.jpg", "top.jpg" };
+
+static void BM_DecodeTexture(BenchState &state) {
+    const char *file = TEXTURE_FILES[state.range()];
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        TextureData data = DecodeTexture(file, ".");
+        bytes = (int64_t)data.width * data.height * data.nrComponents;
+        if (data.pixels) stbi_image_free(data.pixels);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.SetLabel(file);
+}
+MICROBENCH(BM_DecodeTexture)->Arg(0)->Arg(1)->Arg(2);
+
+// --- loadScene parsing ---
+
+// Writes (once per size and format) a scene with 'count' objects and returns its path
+static std::string sceneFile(int64_t count, bool text) {
+    std::string path = std::string("microbench_") + std::to_string(count) + (text ? ".txt.scene" : ".bin.scene");
+    static std::map<std::string, bool> written;
+    if (written[path]) return path;
+    SceneData scene;
+    scene.Reserve((size_t)count);
+    std::vector<GameObject> objects = makeObjects(count, nullptr);
+    for (const GameObject &obj : objects) {
+        SceneTransform t = { obj.position, obj.rotation, obj.scale };
+        scene.AddObject("Object", SCENE_NO_ASSET, t);
+    }
+    if (text) WriteSceneText(path.c_str(), scene.View());
+    else WriteSceneBinary(path.c_str(), scene.View());
+    written[path] = true;
+    return path;
+}
+
+// Parse plus GameObject instantiation, exactly what File > Load Scene does minus model import
+static void loadSceneBenchmark(BenchState &state, bool text) {
+    std::string path = sceneFile(state.range(), text);
+    ModelLibrary library;
+    std::vector<GameObject> objects;
+    glm::vec3 sunDirection, sunColor;
+    for (auto _ : state) {
+        bool ok = LoadSceneObjects(path.c_str(), library, sharedPickModel(), objects, sunDirection, sunColor);
+        BenchDoNotOptimize(ok);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range());
+}
+
+static void BM_LoadSceneText(BenchState &state) { loadSceneBenchmark(state, true); }
+static void BM_LoadSceneBinary(BenchState &state) { loadSceneBenchmark(state, false); }
+MICROBENCH(BM_LoadSceneText)->Range(1, MAX_SIZE);
+MICROBENCH(BM_LoadSceneBinary)->Range(1, MAX_SIZE);
+
+// --- Point-light uniform names (mirrors the loop in Renderer::setupLighting, without the GL calls) ---
+
+static void BM_PointLightUniformNames(BenchState &state) {
+    int lights = (int)state.range();
+    size_t total = 0;
+    for (auto _ : state) {
+        for(int i = 0; i < lights; i++) {
+            char name[48];
+            total += (size_t)snprintf(name, sizeof(name), "pointLights[%d].position", i);
+            total += (size_t)snprintf(name, sizeof(name), "pointLights[%d].ambient", i);
+            total += (size_t)snprintf(name, sizeof(name), "pointLights[%d].diffuse", i);
+            total += (size_t)snprintf(name, sizeof(name), "pointLights[%d].specular", i);
+            total += (size_t)snprintf(name, sizeof(name), "pointLights[%d].constant", i);
+            total += (size_t)snprintf(name, sizeof(name), "pointLights[%d].linear", i);
+            total += (size_t)snprintf(name, sizeof(name), "pointLights[%d].quadratic", i);
+            BenchDoNotOptimize(name[0]);
+        }
+        BenchDoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * lights);
+}
+MICROBENCH(BM_PointLightUniformNames)->Range(1, MAX_SIZE);
+
+MICROBENCH_MAIN()
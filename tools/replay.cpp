@@ -0,0 +1,653 @@
+// Offline replay of one captured frame (Tools > Capture GL Frame in the editor, or
+// MyGraphicsEngineBench --capture). Recreates the captured objects in a headless context and
+// re-executes the frame's GL calls in a loop, so driver and GPU cost can be measured and bisected
+// without the engine: no scene loading, culling or CPU-side work beyond issuing the calls.
+// The window framebuffer is replaced by an offscreen one of the captured size.
+//
+// Usage: MyGraphicsEngineReplay <capture.glcap> [options]
+//   --loops N          timed replays (default 100)
+//   --warmup N         untimed replays first (default 5)
+//   --skip RANGES      call indices to leave out, e.g. "120-480,512" (indices from --list)
+//   --per-call         time every call (GPU timer query and CPU submit time), prints the top 20
+//   --calls <file.csv> write the per-call timings (implies --per-call)
+//   --list             print the calls with their indices and exit
+#include "HeadlessContext.h"
+#include "GLCapture.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <algorithm>
+
+// Uniform value from a program snapshot, re-applied before every loop
+struct ReplayUniform {
+    std::string name;
+    GLenum type;
+    GLint location;
+    uint32_t words[16];
+};
+
+struct ReplayProgram {
+    GLuint id = 0;
+    std::vector<ReplayUniform> uniforms;
+    std::map<GLint, GLint> locations; // captured location -> replay location
+};
+
+struct ReplayState {
+    GLint viewport[4];
+    GLfloat clearColor[4];
+    std::vector<std::pair<GLenum, bool> > caps;
+    GLint depthFunc, depthMask, cullFace, frontFace, blendSrc, blendDst, polygonMode, packAlignment, unpackAlignment;
+    uint32_t colorMask[4];
+    uint32_t program, vertexArray, drawFramebuffer, readFramebuffer, arrayBuffer, packBuffer, unpackBuffer, activeTexture;
+    std::vector<uint32_t> units; // 2D, cube per unit
+};
+
+static void setUniform(GLint location, GLenum type, const uint32_t *words) {
+    const GLfloat *f = (const GLfloat*)words;
+    const GLint *i = (const GLint*)words;
+    switch (type) {
+    case GL_FLOAT: glUniform1fv(location, 1, f); break;
+    case GL_FLOAT_VEC2: glUniform2fv(location, 1, f); break;
+    case GL_FLOAT_VEC3: glUniform3fv(location, 1, f); break;
+    case GL_FLOAT_VEC4: glUniform4fv(location, 1, f); break;
+    case GL_FLOAT_MAT2: glUniformMatrix2fv(location, 1, GL_FALSE, f); break;
+    case GL_FLOAT_MAT3: glUniformMatrix3fv(location, 1, GL_FALSE, f); break;
+    case GL_FLOAT_MAT4: glUniformMatrix4fv(location, 1, GL_FALSE, f); break;
+    case GL_UNSIGNED_INT: glUniform1uiv(location, 1, (const GLuint*)words); break;
+    case GL_INT_VEC2: case GL_BOOL_VEC2: glUniform2iv(location, 1, i); break;
+    case GL_INT_VEC3: case GL_BOOL_VEC3: glUniform3iv(location, 1, i); break;
+    case GL_INT_VEC4: case GL_BOOL_VEC4: glUniform4iv(location, 1, i); break;
+    default: glUniform1iv(location, 1, i); break; // int, bool and samplers
+    }
+}
+
+// The window's buffers become the substitute framebuffer's color attachment
+static GLenum mapDrawBuffer(GLenum buffer) {
+    switch (buffer) {
+    case GL_BACK: case GL_FRONT: case GL_BACK_LEFT: case GL_FRONT_LEFT: case GL_FRONT_AND_BACK: return GL_COLOR_ATTACHMENT0;
+    default: return buffer;
+    }
+}
+
+class Replayer {
+public:
+    size_t resourceCount = 0;
+
+    bool Init(const CaptureFile &file) {
+        // Stand-in for the window framebuffer
+        glGenFramebuffers(1, &defaultFramebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebuffer);
+        glGenTextures(1, &defaultColor);
+        glBindTexture(GL_TEXTURE_2D, defaultColor);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, file.width, file.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, defaultColor, 0);
+        glGenRenderbuffers(1, &defaultDepth);
+        glBindRenderbuffer(GL_RENDERBUFFER, defaultDepth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, file.width, file.height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, defaultDepth);
+        framebuffers[0] = defaultFramebuffer;
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        bool ok = true;
+        for (const CaptureRecord &rec : file.records) {
+            if (rec.op >= CAP_FIRST_CALL) continue;
+            CaptureReader r(rec.payload, rec.size);
+            switch (rec.op) {
+            case CAP_TEXTURE: createTexture(r); break;
+            case CAP_BUFFER: createBuffer(r); break;
+            case CAP_VERTEX_ARRAY: createVertexArray(r); break;
+            case CAP_PROGRAM: ok = createProgram(r) && ok; break;
+            case CAP_RENDERBUFFER: createRenderbuffer(r); break;
+            case CAP_FRAMEBUFFER: createFramebuffer(r); break;
+            case CAP_STATE: readState(r); hasState = true; break;
+            default: break;
+            }
+            if (!r.ok) { std::printf("Truncated %s record\n", CaptureOpName(rec.op)); return false; }
+            resourceCount++;
+        }
+        return ok;
+    }
+
+    // Frame-start state and uniform values, applied before every loop
+    void Reset() {
+        for (std::map<uint64_t, GLsync>::iterator it = syncs.begin(); it != syncs.end(); ++it) glDeleteSync(it->second);
+        syncs.clear();
+        for (std::map<uint32_t, ReplayProgram>::iterator it = programs.begin(); it != programs.end(); ++it) {
+            glUseProgram(it->second.id);
+            for (const ReplayUniform &u : it->second.uniforms) setUniform(it->second.locations[u.location], u.type, u.words);
+        }
+        if (!hasState) { glUseProgram(0); currentProgram = 0; return; }
+        const ReplayState &s = state;
+        glViewport(s.viewport[0], s.viewport[1], s.viewport[2], s.viewport[3]);
+        glClearColor(s.clearColor[0], s.clearColor[1], s.clearColor[2], s.clearColor[3]);
+        for (const std::pair<GLenum, bool> &cap : s.caps) { if (cap.second) glEnable(cap.first); else glDisable(cap.first); }
+        glDepthFunc(s.depthFunc); glDepthMask((GLboolean)s.depthMask);
+        glCullFace(s.cullFace); glFrontFace(s.frontFace);
+        glBlendFunc(s.blendSrc, s.blendDst);
+        glColorMask(s.colorMask[0], s.colorMask[1], s.colorMask[2], s.colorMask[3]);
+        glPolygonMode(GL_FRONT_AND_BACK, s.polygonMode);
+        glPixelStorei(GL_PACK_ALIGNMENT, s.packAlignment); glPixelStorei(GL_UNPACK_ALIGNMENT, s.unpackAlignment);
+        currentProgram = s.program;
+        glUseProgram(find(programs, s.program));
+        glBindVertexArray(find(vertexArrays, s.vertexArray));
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, find(framebuffers, s.drawFramebuffer));
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, find(framebuffers, s.readFramebuffer));
+        glBindBuffer(GL_ARRAY_BUFFER, find(buffers, s.arrayBuffer));
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, find(buffers, s.packBuffer));
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, find(buffers, s.unpackBuffer));
+        for (size_t i = 0; i + 1 < s.units.size(); i += 2) {
+            glActiveTexture(GL_TEXTURE0 + (GLenum)(i / 2));
+            glBindTexture(GL_TEXTURE_2D, find(textures, s.units[i]));
+            glBindTexture(GL_TEXTURE_CUBE_MAP, find(textures, s.units[i + 1]));
+        }
+        glActiveTexture(s.activeTexture);
+    }
+
+    void Execute(const CaptureRecord &rec) {
+        CaptureReader r(rec.payload, rec.size);
+        switch (rec.op) {
+        case CAP_BindFramebuffer: { GLenum target = r.u32(); glBindFramebuffer(target, find(framebuffers, r.u32())); break; }
+        case CAP_Viewport: { GLint x = r.i32(), y = r.i32(), w = r.i32(), h = r.i32(); glViewport(x, y, w, h); break; }
+        case CAP_ClearColor: { float c[4]; r.raw(c, sizeof(c)); glClearColor(c[0], c[1], c[2], c[3]); break; }
+        case CAP_Clear: glClear(r.u32()); break;
+        case CAP_ClearBufferfv: { GLenum buffer = r.u32(); GLint drawbuffer = r.i32(); float v[4] = {}; r.raw(v, buffer == GL_COLOR ? 16 : 4); glClearBufferfv(buffer, drawbuffer, v); break; }
+        case CAP_ClearBufferuiv: { GLenum buffer = r.u32(); GLint drawbuffer = r.i32(); GLuint v[4]; r.raw(v, sizeof(v)); glClearBufferuiv(buffer, drawbuffer, v); break; }
+        case CAP_Enable: glEnable(r.u32()); break;
+        case CAP_Disable: glDisable(r.u32()); break;
+        case CAP_DepthFunc: glDepthFunc(r.u32()); break;
+        case CAP_DepthMask: glDepthMask((GLboolean)r.u32()); break;
+        case CAP_CullFace: glCullFace(r.u32()); break;
+        case CAP_BlendFunc: { GLenum s = r.u32(); glBlendFunc(s, r.u32()); break; }
+        case CAP_ColorMask: { uint32_t m[4]; r.raw(m, sizeof(m)); glColorMask(m[0], m[1], m[2], m[3]); break; }
+        case CAP_PolygonMode: { GLenum face = r.u32(); glPolygonMode(face, r.u32()); break; }
+        case CAP_UseProgram: currentProgram = r.u32(); glUseProgram(find(programs, currentProgram)); break;
+        case CAP_ActiveTexture: glActiveTexture(r.u32()); break;
+        case CAP_BindTexture: { GLenum target = r.u32(); glBindTexture(target, find(textures, r.u32())); break; }
+        case CAP_BindVertexArray: glBindVertexArray(find(vertexArrays, r.u32())); break;
+        case CAP_BindBuffer: { GLenum target = r.u32(); glBindBuffer(target, find(buffers, r.u32())); break; }
+        case CAP_DrawBuffer: glDrawBuffer(mapDrawBuffer(r.u32())); break;
+        case CAP_DrawBuffers: {
+            GLsizei n = std::min(r.i32(), 16);
+            GLenum bufs[16];
+            for (GLsizei i = 0; i < n; i++) bufs[i] = mapDrawBuffer(r.u32());
+            glDrawBuffers(n, bufs);
+            break;
+        }
+        case CAP_ReadBuffer: glReadBuffer(mapDrawBuffer(r.u32())); break;
+        case CAP_GetUniformLocation: {
+            uint32_t program = r.u32();
+            std::string name = r.str();
+            GLint captured = r.i32();
+            std::map<uint32_t, ReplayProgram>::iterator it = programs.find(program);
+            if (it == programs.end()) break;
+            it->second.locations[captured] = glGetUniformLocation(it->second.id, name.c_str());
+            break;
+        }
+        case CAP_Uniform1i: { GLint l = location(r.i32()); glUniform1i(l, r.i32()); break; }
+        case CAP_Uniform1ui: { GLint l = location(r.i32()); glUniform1ui(l, r.u32()); break; }
+        case CAP_Uniform1f: { GLint l = location(r.i32()); glUniform1f(l, r.f32()); break; }
+        case CAP_Uniform2f: { GLint l = location(r.i32()); float v[2]; r.raw(v, sizeof(v)); glUniform2f(l, v[0], v[1]); break; }
+        case CAP_Uniform3f: { GLint l = location(r.i32()); float v[3]; r.raw(v, sizeof(v)); glUniform3f(l, v[0], v[1], v[2]); break; }
+        case CAP_Uniform4f: { GLint l = location(r.i32()); float v[4]; r.raw(v, sizeof(v)); glUniform4f(l, v[0], v[1], v[2], v[3]); break; }
+        case CAP_Uniform1iv: case CAP_Uniform1fv: case CAP_Uniform2fv: case CAP_Uniform3fv: case CAP_Uniform4fv:
+        case CAP_UniformMatrix3fv: case CAP_UniformMatrix4fv: {
+            GLint l = location(r.i32());
+            GLsizei count = r.i32();
+            GLboolean transpose = (GLboolean)r.u32();
+            const void *v = r.p; // values run to the end of the record
+            switch (rec.op) {
+            case CAP_Uniform1iv: glUniform1iv(l, count, (const GLint*)v); break;
+            case CAP_Uniform1fv: glUniform1fv(l, count, (const GLfloat*)v); break;
+            case CAP_Uniform2fv: glUniform2fv(l, count, (const GLfloat*)v); break;
+            case CAP_Uniform3fv: glUniform3fv(l, count, (const GLfloat*)v); break;
+            case CAP_Uniform4fv: glUniform4fv(l, count, (const GLfloat*)v); break;
+            case CAP_UniformMatrix3fv: glUniformMatrix3fv(l, count, transpose, (const GLfloat*)v); break;
+            default: glUniformMatrix4fv(l, count, transpose, (const GLfloat*)v); break;
+            }
+            break;
+        }
+        case CAP_DrawArrays: { GLenum mode = r.u32(); GLint first = r.i32(); glDrawArrays(mode, first, r.i32()); break; }
+        case CAP_DrawElements: { GLenum mode = r.u32(); GLsizei count = r.i32(); GLenum type = r.u32(); glDrawElements(mode, count, type, (const void*)(uintptr_t)r.u64()); break; }
+        case CAP_DrawArraysInstanced: { GLenum mode = r.u32(); GLint first = r.i32(); GLsizei count = r.i32(); glDrawArraysInstanced(mode, first, count, r.i32()); break; }
+        case CAP_DrawElementsInstanced: {
+            GLenum mode = r.u32(); GLsizei count = r.i32(); GLenum type = r.u32();
+            const void *offset = (const void*)(uintptr_t)r.u64();
+            glDrawElementsInstanced(mode, count, type, offset, r.i32());
+            break;
+        }
+        case CAP_BufferData: {
+            GLenum target = r.u32(); GLsizeiptr size = (GLsizeiptr)r.u64(); GLenum usage = r.u32();
+            uint64_t n; const uint8_t *data = r.blob(n);
+            glBufferData(target, size, data, usage);
+            break;
+        }
+        case CAP_BufferSubData: {
+            GLenum target = r.u32(); GLintptr offset = (GLintptr)r.u64();
+            uint64_t n; const uint8_t *data = r.blob(n);
+            glBufferSubData(target, offset, (GLsizeiptr)n, data);
+            break;
+        }
+        case CAP_TexImage2D: {
+            GLenum target = r.u32(); GLint level = r.i32(), internalFormat = r.i32(), w = r.i32(), h = r.i32(), border = r.i32();
+            GLenum format = r.u32(), type = r.u32();
+            const void *pixels = pixelSource(r);
+            glTexImage2D(target, level, internalFormat, w, h, border, format, type, pixels);
+            break;
+        }
+        case CAP_TexSubImage2D: {
+            GLenum target = r.u32(); GLint level = r.i32(), x = r.i32(), y = r.i32(), w = r.i32(), h = r.i32();
+            GLenum format = r.u32(), type = r.u32();
+            const void *pixels = pixelSource(r);
+            glTexSubImage2D(target, level, x, y, w, h, format, type, pixels);
+            break;
+        }
+        case CAP_TexParameteri: { GLenum target = r.u32(); GLenum pname = r.u32(); glTexParameteri(target, pname, r.i32()); break; }
+        case CAP_GenerateMipmap: glGenerateMipmap(r.u32()); break;
+        case CAP_ReadPixels: {
+            GLint x = r.i32(), y = r.i32(), w = r.i32(), h = r.i32();
+            GLenum format = r.u32(), type = r.u32();
+            bool toBuffer = r.u32() != 0;
+            uint64_t offset = r.u64();
+            if (toBuffer) { glReadPixels(x, y, w, h, format, type, (void*)(uintptr_t)offset); break; }
+            GLint alignment = 4; glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+            scratch.resize(CaptureImageBytes(w, h, format, type, alignment));
+            glReadPixels(x, y, w, h, format, type, scratch.data());
+            break;
+        }
+        case CAP_FenceSync: {
+            GLenum condition = r.u32(); GLbitfield flags = r.u32();
+            uint64_t id = r.u64();
+            std::map<uint64_t, GLsync>::iterator it = syncs.find(id);
+            if (it != syncs.end()) glDeleteSync(it->second);
+            syncs[id] = glFenceSync(condition, flags);
+            break;
+        }
+        case CAP_ClientWaitSync: {
+            uint64_t id = r.u64(); GLbitfield flags = r.u32(); GLuint64 timeout = r.u64();
+            std::map<uint64_t, GLsync>::iterator it = syncs.find(id);
+            if (it != syncs.end()) glClientWaitSync(it->second, flags, timeout); // fences from before the frame don't exist here
+            break;
+        }
+        case CAP_DeleteSync: {
+            std::map<uint64_t, GLsync>::iterator it = syncs.find(r.u64());
+            if (it != syncs.end()) { glDeleteSync(it->second); syncs.erase(it); }
+            break;
+        }
+        case CAP_MapBufferRange: {
+            GLenum target = r.u32(); GLintptr offset = (GLintptr)r.u64(); GLsizeiptr length = (GLsizeiptr)r.u64(); GLbitfield access = r.u32();
+            mapped[target] = glMapBufferRange(target, offset, length, access);
+            break;
+        }
+        case CAP_UnmapBuffer: {
+            GLenum target = r.u32();
+            uint64_t n; const uint8_t *data = r.blob(n);
+            void *pointer = mapped[target];
+            if (pointer && data) std::memcpy(pointer, data, (size_t)n);
+            mapped[target] = nullptr;
+            glUnmapBuffer(target);
+            break;
+        }
+        case CAP_BlitFramebuffer: {
+            GLint v[8]; for (GLint &x : v) x = r.i32();
+            GLbitfield mask = r.u32();
+            glBlitFramebuffer(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], mask, r.u32());
+            break;
+        }
+        case CAP_Scissor: { GLint x = r.i32(), y = r.i32(), w = r.i32(), h = r.i32(); glScissor(x, y, w, h); break; }
+        default: break;
+        }
+    }
+
+    // Short argument summary for --list
+    static std::string Describe(const CaptureRecord &rec) {
+        CaptureReader r(rec.payload, rec.size);
+        char text[128] = "";
+        switch (rec.op) {
+        case CAP_DrawArrays: { r.u32(); r.i32(); std::snprintf(text, sizeof(text), "%d vertices", r.i32()); break; }
+        case CAP_DrawElements: case CAP_DrawElementsInstanced: { r.u32(); std::snprintf(text, sizeof(text), "%d indices", r.i32()); break; }
+        case CAP_DrawArraysInstanced: { r.u32(); r.i32(); int count = r.i32(); std::snprintf(text, sizeof(text), "%d vertices x %d", count, r.i32()); break; }
+        case CAP_UseProgram: case CAP_BindVertexArray: std::snprintf(text, sizeof(text), "%u", r.u32()); break;
+        case CAP_BindFramebuffer: case CAP_BindTexture: case CAP_BindBuffer: { uint32_t target = r.u32(); std::snprintf(text, sizeof(text), "0x%04x, %u", target, r.u32()); break; }
+        case CAP_GetUniformLocation: { r.u32(); std::snprintf(text, sizeof(text), "\"%s\"", r.str().c_str()); break; }
+        case CAP_Enable: case CAP_Disable: case CAP_Clear: std::snprintf(text, sizeof(text), "0x%04x", r.u32()); break;
+        default: break;
+        }
+        return text;
+    }
+
+private:
+    GLuint defaultFramebuffer = 0, defaultColor = 0, defaultDepth = 0;
+    std::map<uint32_t, GLuint> textures, buffers, vertexArrays, renderbuffers, framebuffers;
+    std::map<uint32_t, ReplayProgram> programs;
+    std::map<uint64_t, GLsync> syncs;
+    std::map<GLenum, void*> mapped;
+    ReplayState state;
+    bool hasState = false;
+    uint32_t currentProgram = 0;
+    std::vector<uint8_t> scratch;
+
+    // Captured name -> replay name; unknown names (objects the frame never referenced) become 0
+    static GLuint find(const std::map<uint32_t, GLuint> &names, uint32_t name) {
+        std::map<uint32_t, GLuint>::const_iterator it = names.find(name);
+        return it != names.end() ? it->second : 0;
+    }
+    static GLuint find(const std::map<uint32_t, ReplayProgram> &names, uint32_t name) {
+        std::map<uint32_t, ReplayProgram>::const_iterator it = names.find(name);
+        return it != names.end() ? it->second.id : 0;
+    }
+
+    GLint location(GLint captured) {
+        if (captured < 0) return -1;
+        std::map<uint32_t, ReplayProgram>::iterator it = programs.find(currentProgram);
+        if (it == programs.end()) return -1;
+        std::map<GLint, GLint>::iterator l = it->second.locations.find(captured);
+        return l != it->second.locations.end() ? l->second : -1;
+    }
+
+    const void* pixelSource(CaptureReader &r) {
+        if (r.u32()) return (const void*)(uintptr_t)r.u64(); // offset into the bound unpack buffer
+        uint64_t n;
+        return r.blob(n);
+    }
+
+    void createTexture(CaptureReader &r) {
+        uint32_t name = r.u32(); GLenum target = r.u32();
+        GLint internalFormat = r.i32(), w = r.i32(), h = r.i32();
+        GLint params[7];
+        for (int i = 0; i < 7; i++) params[i] = r.i32();
+        GLfloat border[4];
+        for (int i = 0; i < 4; i++) border[i] = r.f32();
+        uint32_t faces = r.u32();
+        GLuint id;
+        glGenTextures(1, &id);
+        glBindTexture(target, id);
+        GLenum format, type; int bytesPerPixel;
+        CaptureTextureTransfer(internalFormat, format, type, bytesPerPixel);
+        if (target == GL_TEXTURE_3D && w > 0 && h > 0) glTexImage3D(target, 0, internalFormat, w, h, faces, 0, format, type, NULL);
+        for (uint32_t f = 0; f < faces; f++) {
+            uint64_t n; const uint8_t *pixels = r.blob(n);
+            if (target == GL_TEXTURE_3D) { if (w > 0 && h > 0) glTexSubImage3D(target, 0, 0, 0, f, w, h, 1, format, type, pixels); continue; }
+            GLenum face = target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + f : target;
+            if (w > 0 && h > 0) glTexImage2D(face, 0, internalFormat, w, h, 0, format, type, pixels);
+        }
+        const GLenum names[] = { GL_TEXTURE_MIN_FILTER, GL_TEXTURE_MAG_FILTER, GL_TEXTURE_WRAP_S, GL_TEXTURE_WRAP_T, GL_TEXTURE_WRAP_R,
+                                 GL_TEXTURE_COMPARE_MODE, GL_TEXTURE_COMPARE_FUNC };
+        for (int i = 0; i < 7; i++) glTexParameteri(target, names[i], params[i]);
+        glTexParameterfv(target, GL_TEXTURE_BORDER_COLOR, border);
+        // Only level 0 is captured; rebuild the chain if the sampler uses it
+        if (w > 0 && h > 0 && params[0] != GL_NEAREST && params[0] != GL_LINEAR) glGenerateMipmap(target);
+        textures[name] = id;
+    }
+
+    void createBuffer(CaptureReader &r) {
+        uint32_t name = r.u32(); GLenum usage = r.i32();
+        uint64_t n; const uint8_t *data = r.blob(n);
+        GLuint id;
+        glGenBuffers(1, &id);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+        glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)n, data, usage);
+        buffers[name] = id;
+    }
+
+    void createVertexArray(CaptureReader &r) {
+        uint32_t name = r.u32(), elementBuffer = r.u32(), count = r.u32();
+        GLuint id;
+        glGenVertexArrays(1, &id);
+        glBindVertexArray(id);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, find(buffers, elementBuffer));
+        for (uint32_t a = 0; a < count; a++) {
+            GLuint index = r.u32();
+            GLint v[8];
+            for (int p = 0; p < 8; p++) v[p] = r.i32();
+            const void *offset = (const void*)(uintptr_t)r.u64();
+            // v: enabled, size, type, normalized, integer, stride, divisor, buffer
+            if (v[7]) {
+                glBindBuffer(GL_ARRAY_BUFFER, find(buffers, (uint32_t)v[7]));
+                if (v[4]) glVertexAttribIPointer(index, v[1], v[2], v[5], offset);
+                else glVertexAttribPointer(index, v[1], v[2], (GLboolean)v[3], v[5], offset);
+            }
+            glVertexAttribDivisor(index, v[6]);
+            if (v[0]) glEnableVertexAttribArray(index);
+        }
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        vertexArrays[name] = id;
+    }
+
+    bool createProgram(CaptureReader &r) {
+        uint32_t name = r.u32(), shaderCount = r.u32();
+        ReplayProgram &program = programs[name];
+        program.id = glCreateProgram();
+        bool ok = true;
+        for (uint32_t s = 0; s < shaderCount; s++) {
+            GLenum type = r.u32();
+            std::string source = r.str();
+            GLuint shader = glCreateShader(type);
+            const char *code = source.c_str();
+            glShaderSource(shader, 1, &code, NULL);
+            glCompileShader(shader);
+            glAttachShader(program.id, shader);
+            glDeleteShader(shader);
+        }
+        glLinkProgram(program.id);
+        GLint linked = 0;
+        glGetProgramiv(program.id, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            char log[1024];
+            glGetProgramInfoLog(program.id, sizeof(log), NULL, log);
+            std::printf("Program %u failed to link:\n%s\n", name, log);
+            ok = false;
+        }
+        uint32_t uniformCount = r.u32();
+        for (uint32_t u = 0; u < uniformCount && r.ok; u++) {
+            ReplayUniform uniform;
+            uniform.name = r.str();
+            uniform.type = r.u32();
+            uniform.location = r.i32();
+            uint32_t components = std::min(r.u32(), 16u);
+            std::memset(uniform.words, 0, sizeof(uniform.words));
+            r.raw(uniform.words, components * 4);
+            program.locations[uniform.location] = glGetUniformLocation(program.id, uniform.name.c_str());
+            program.uniforms.push_back(uniform);
+        }
+        return ok;
+    }
+
+    void createRenderbuffer(CaptureReader &r) {
+        uint32_t name = r.u32();
+        GLint format = r.i32(), w = r.i32(), h = r.i32(), samples = r.i32();
+        GLuint id;
+        glGenRenderbuffers(1, &id);
+        glBindRenderbuffer(GL_RENDERBUFFER, id);
+        if (samples > 0) glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, format, w, h);
+        else glRenderbufferStorage(GL_RENDERBUFFER, format, w, h);
+        renderbuffers[name] = id;
+    }
+
+    void createFramebuffer(CaptureReader &r) {
+        uint32_t name = r.u32(), count = r.u32();
+        GLuint id;
+        glGenFramebuffers(1, &id);
+        glBindFramebuffer(GL_FRAMEBUFFER, id);
+        for (uint32_t a = 0; a < count; a++) {
+            GLenum attachment = r.u32(), type = r.u32();
+            uint32_t object = r.u32();
+            GLint level = r.i32();
+            GLenum texTarget = r.u32();
+            if (type == GL_TEXTURE) glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, texTarget, find(textures, object), level);
+            else if (type == GL_RENDERBUFFER) glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, find(renderbuffers, object));
+        }
+        GLenum drawBuffers[CAPTURE_COLOR_ATTACHMENTS];
+        GLsizei used = 0;
+        for (int i = 0; i < CAPTURE_COLOR_ATTACHMENTS; i++) {
+            drawBuffers[i] = r.u32();
+            if (drawBuffers[i] != GL_NONE) used = i + 1;
+        }
+        if (used) glDrawBuffers(used, drawBuffers);
+        else glDrawBuffer(GL_NONE);
+        glReadBuffer(r.u32());
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) std::printf("Framebuffer %u is incomplete in the replay\n", name);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        framebuffers[name] = id;
+    }
+
+    void readState(CaptureReader &r) {
+        ReplayState &s = state;
+        for (int i = 0; i < 4; i++) s.viewport[i] = r.i32();
+        for (int i = 0; i < 4; i++) s.clearColor[i] = r.f32();
+        uint32_t caps = r.u32();
+        for (uint32_t i = 0; i < caps; i++) { GLenum cap = r.u32(); s.caps.push_back(std::make_pair(cap, r.u32() != 0)); }
+        s.depthFunc = r.i32(); s.depthMask = r.i32();
+        s.cullFace = r.i32(); s.frontFace = r.i32();
+        s.blendSrc = r.i32(); s.blendDst = r.i32();
+        for (int i = 0; i < 4; i++) s.colorMask[i] = r.u32();
+        s.polygonMode = r.i32();
+        s.packAlignment = r.i32(); s.unpackAlignment = r.i32();
+        s.program = r.u32(); s.vertexArray = r.u32(); s.drawFramebuffer = r.u32(); s.readFramebuffer = r.u32();
+        s.arrayBuffer = r.u32(); s.packBuffer = r.u32(); s.unpackBuffer = r.u32();
+        s.activeTexture = r.u32();
+        uint32_t units = r.u32();
+        for (uint32_t i = 0; i < units * 2; i++) s.units.push_back(r.u32());
+    }
+};
+
+// "10-20,35" -> flags over the call list
+static bool parseRanges(const std::string &text, std::vector<bool> &skip) {
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find(',', start);
+        if (end == std::string::npos) end = text.size();
+        std::string item = text.substr(start, end - start);
+        size_t dash = item.find('-');
+        char *stop = nullptr;
+        long first = std::strtol(item.c_str(), &stop, 10), last = first;
+        if (stop == item.c_str()) return false;
+        if (dash != std::string::npos) last = std::strtol(item.c_str() + dash + 1, &stop, 10);
+        for (long i = std::max(first, 0L); i <= last && i < (long)skip.size(); i++) skip[(size_t)i] = true;
+        start = end + 1;
+    }
+    return true;
+}
+
+struct CallTiming {
+    size_t index;
+    double cpuUs = 0.0, gpuUs = 0.0;
+};
+
+int main(int argc, char** argv) {
+    std::string capturePath, skipRanges, callsPath;
+    int loops = 100, warmup = 5;
+    bool perCall = false, list = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--loops" && hasValue) loops = std::atoi(argv[++i]);
+        else if (arg == "--warmup" && hasValue) warmup = std::atoi(argv[++i]);
+        else if (arg == "--skip" && hasValue) skipRanges = argv[++i];
+        else if (arg == "--per-call") perCall = true;
+        else if (arg == "--calls" && hasValue) { callsPath = argv[++i]; perCall = true; }
+        else if (arg == "--list") list = true;
+        else if (arg.compare(0, 2, "--") != 0 && capturePath.empty()) capturePath = arg;
+        else { std::printf("Unknown or incomplete option: %s\n", arg.c_str()); return 1; }
+    }
+    if (capturePath.empty() || loops <= 0) {
+        std::printf("Usage: %s <capture.glcap> [--loops N] [--warmup N] [--skip RANGES] [--per-call] [--calls <file.csv>] [--list]\n", argv[0]);
+        return 1;
+    }
+
+    CaptureFile file;
+    if (!file.Load(capturePath)) { std::printf("Failed to read capture %s\n", capturePath.c_str()); return 1; }
+    std::vector<const CaptureRecord*> calls;
+    size_t draws = 0;
+    for (const CaptureRecord &rec : file.records) {
+        if (rec.op < CAP_FIRST_CALL) continue;
+        calls.push_back(&rec);
+        if (rec.op >= CAP_DrawArrays && rec.op <= CAP_DrawElementsInstanced) draws++;
+    }
+    std::printf("Capture: %s, %ux%u, %zu calls (%zu draws), recorded on %s\n", capturePath.c_str(), file.width, file.height, calls.size(), draws, file.renderer.c_str());
+
+    if (list) {
+        for (size_t i = 0; i < calls.size(); i++) std::printf("%6zu  %-26s %s\n", i, CaptureOpName(calls[i]->op), Replayer::Describe(*calls[i]).c_str());
+        return 0;
+    }
+    std::vector<bool> skip(calls.size(), false);
+    if (!skipRanges.empty() && !parseRanges(skipRanges, skip)) { std::printf("Bad --skip ranges: %s\n", skipRanges.c_str()); return 1; }
+    size_t skipped = (size_t)std::count(skip.begin(), skip.end(), true);
+    if (skipped) std::printf("Skipping %zu calls\n", skipped);
+
+    HeadlessContext context;
+    if (!context.Create()) return 1;
+    std::printf("Replaying on: %s\n", context.Renderer());
+
+    Replayer replayer;
+    if (!replayer.Init(file)) return 1;
+    std::printf("Recreated %zu objects\n", replayer.resourceCount);
+
+    std::vector<GLuint> queries;
+    std::vector<CallTiming> timings(calls.size());
+    for (size_t i = 0; i < calls.size(); i++) timings[i].index = i;
+    if (perCall) { queries.resize(calls.size()); glGenQueries((GLsizei)queries.size(), queries.data()); }
+
+    std::vector<double> loopMs;
+    for (int loop = 0; loop < warmup + loops; loop++) {
+        bool measured = loop >= warmup;
+        replayer.Reset();
+        glFinish();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < calls.size(); i++) {
+            if (skip[i]) continue;
+            if (!perCall) { replayer.Execute(*calls[i]); continue; }
+            glBeginQuery(GL_TIME_ELAPSED, queries[i]);
+            auto callStart = std::chrono::steady_clock::now();
+            replayer.Execute(*calls[i]);
+            double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - callStart).count();
+            glEndQuery(GL_TIME_ELAPSED);
+            if (measured) timings[i].cpuUs += us;
+        }
+        glFinish();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (!measured) continue;
+        loopMs.push_back(ms);
+        if (perCall) {
+            for (size_t i = 0; i < calls.size(); i++) {
+                if (skip[i]) continue;
+                GLuint64 ns = 0;
+                glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &ns);
+                timings[i].gpuUs += ns / 1000.0;
+            }
+        }
+    }
+
+    std::vector<double> sorted = loopMs;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double v : sorted) sum += v;
+    size_t p95 = std::min(sorted.size() - 1, (size_t)(0.95 * sorted.size()));
+    std::printf("%d loops: mean %.3f ms  min %.3f  p95 %.3f  max %.3f%s\n", loops, sum / sorted.size(), sorted.front(), sorted[p95], sorted.back(),
+        perCall ? "  (with per-call queries)" : "");
+
+    if (perCall) {
+        for (CallTiming &t : timings) { t.cpuUs /= loops; t.gpuUs /= loops; }
+        if (!callsPath.empty()) {
+            std::ofstream csv(callsPath);
+            csv << "index,call,detail,cpu_us,gpu_us\n";
+            for (const CallTiming &t : timings)
+                csv << t.index << "," << CaptureOpName(calls[t.index]->op) << ",\"" << Replayer::Describe(*calls[t.index]) << "\"," << t.cpuUs << "," << t.gpuUs << "\n";
+            if (!csv.good()) { std::printf("Failed to write %s\n", callsPath.c_str()); return 1; }
+            std::printf("Per-call timings written to %s\n", callsPath.c_str());
+        }
+        std::vector<CallTiming> top = timings;
+        std::sort(top.begin(), top.end(), [](const CallTiming &a, const CallTiming &b) { return a.gpuUs + a.cpuUs > b.gpuUs + b.cpuUs; });
+        std::printf("\n%6s  %-26s %-24s %10s %10s\n", "index", "call", "detail", "cpu us", "gpu us");
+        for (size_t i = 0; i < top.size() && i < 20; i++)
+            std::printf("%6zu  %-26s %-24s %10.2f %10.2f\n", top[i].index, CaptureOpName(calls[top[i].index]->op), Replayer::Describe(*calls[top[i].index]).c_str(), top[i].cpuUs, top[i].gpuUs);
+        glDeleteQueries((GLsizei)queries.size(), queries.data());
+    }
+    return 0;
+}
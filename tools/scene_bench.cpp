@@ -0,0 +1,63 @@
+// Compares load times of the text and binary scene formats.
+// Usage: MyGraphicsEngineSceneBench [objectCount=1000000]
+#include "SceneFile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+static double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    unsigned int count = argc > 1 ? (unsigned int)std::strtoul(argv[1], NULL, 10) : 1000000u;
+    const char* textPath = "bench_scene.txt.scene";
+    const char* binaryPath = "bench_scene.bin.scene";
+
+    SceneData scene;
+    scene.Reserve(count);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> pos(-500.0f, 500.0f), angle(0.0f, 360.0f), size(0.5f, 3.0f);
+    const char* models[] = { "cube.obj", "crate.obj", "lamp.obj", "tree.obj" };
+    for (unsigned int i = 0; i < count; i++) {
+        SceneTransform t = { glm::vec3(pos(rng), pos(rng) * 0.1f, pos(rng)), glm::vec3(0.0f, angle(rng), 0.0f), glm::vec3(size(rng)) };
+        scene.AddObject("Object " + std::to_string(i), scene.AddAsset(models[i % 4]), t);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    WriteSceneText(textPath, scene.View());
+    double textWrite = msSince(start);
+
+    start = std::chrono::steady_clock::now();
+    WriteSceneBinary(binaryPath, scene.View());
+    double binaryWrite = msSince(start);
+
+    start = std::chrono::steady_clock::now();
+    SceneData parsed;
+    bool textOk = ReadSceneText(textPath, parsed);
+    double textRead = msSince(start);
+
+    // Touch every object so the binary timing includes faulting the pages in
+    start = std::chrono::steady_clock::now();
+    MappedFile mapped; SceneView view;
+    bool binaryOk = mapped.Open(binaryPath) && OpenSceneBinary(mapped, view);
+    glm::vec3 checksum(0.0f); size_t nameBytes = 0;
+    for (uint32_t i = 0; binaryOk && i < view.objectCount; i++) {
+        checksum += view.transforms[i].position;
+        nameBytes += view.String(view.names[i])[0] != 0;
+    }
+    double binaryRead = msSince(start);
+
+    if (!textOk || !binaryOk || parsed.names.size() != count || view.objectCount != count) {
+        std::printf("FAILED: text %d (%zu objects), binary %d (%u objects)\n", textOk, parsed.names.size(), binaryOk, view.objectCount);
+        return 1;
+    }
+    std::printf("%u objects (checksum %.1f, %zu names)\n", count, checksum.x + checksum.y + checksum.z, nameBytes);
+    std::printf("  text   write %9.2f ms   load %9.2f ms\n", textWrite, textRead);
+    std::printf("  binary write %9.2f ms   load %9.2f ms\n", binaryWrite, binaryRead);
+    std::remove(textPath);
+    std::remove(binaryPath);
+    return 0;
+}
@@ -0,0 +1,52 @@
+// Writes a reproducible stress scene for the benchmarks (same arguments, same file).
+// Usage: MyGraphicsEngineSceneGen <output.scene> [--count=N] [--seed=N] [--dist=uniform|city|interior]
+//        [--extent=units] [--models=cube.obj:3,crate.obj:1] [--lights=N] [--depth=N] [--children=N] [--text]
+#include "SceneGenerator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static void usage(const char* exe) {
+    std::printf("Usage: %s <output.scene> [--count=N] [--seed=N] [--dist=uniform|city|interior] [--extent=units]\n"
+                "       [--models=path:weight,...] [--lights=N] [--depth=N] [--children=N] [--text]\n", exe);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) { usage(argv[0]); return 1; }
+    std::string output = argv[1];
+    SceneGenSettings settings;
+    bool text = false;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq), value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if (key == "--count") settings.objectCount = (uint32_t)std::strtoul(value.c_str(), NULL, 10);
+        else if (key == "--seed") settings.seed = std::strtoull(value.c_str(), NULL, 10);
+        else if (key == "--dist") { if (!ParseSceneDistribution(value.c_str(), settings.distribution)) { usage(argv[0]); return 1; } }
+        else if (key == "--extent") settings.extent = (float)std::atof(value.c_str());
+        else if (key == "--models") settings.models = ParseSceneModelMix(value);
+        else if (key == "--lights") settings.lightCount = (uint32_t)std::strtoul(value.c_str(), NULL, 10);
+        else if (key == "--depth") settings.hierarchyDepth = std::atoi(value.c_str());
+        else if (key == "--children") settings.childrenPerNode = std::atoi(value.c_str());
+        else if (key == "--text") text = true;
+        else { usage(argv[0]); return 1; }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    SceneData scene;
+    GenerateScene(settings, scene);
+    double generateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    bool ok = text ? WriteSceneText(output.c_str(), scene.View()) : WriteSceneBinary(output.c_str(), scene.View());
+    double writeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (!ok) { std::printf("Failed to write %s\n", output.c_str()); return 1; }
+
+    std::printf("%s: %zu objects (%s, seed %llu, depth %d), %zu models, %zu lights\n", output.c_str(), scene.names.size(),
+                SceneDistributionName(settings.distribution), (unsigned long long)settings.seed, settings.hierarchyDepth,
+                scene.assetPaths.size(), scene.lights.size());
+    std::printf("  generate %.1f ms, write %.1f ms\n", generateMs, writeMs);
+    return 0;
+}
@@ -0,0 +1,35 @@
+// Splits a .scene file (text or binary) into a directory of streamable world cells.
+// Usage: MyGraphicsEngineWorldPartition <input.scene> <outputDir> [cellSize=32]
+#include "WorldCells.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::printf("Usage: %s <input.scene> <outputDir> [cellSize=32]\n", argv[0]);
+        return 1;
+    }
+    const char* input = argv[1];
+    std::string outputDir = argv[2];
+    float cellSize = argc > 3 ? (float)std::atof(argv[3]) : 32.0f;
+    if (cellSize <= 0.0f) { std::printf("Cell size must be positive\n"); return 1; }
+
+    MappedFile mapped; SceneData parsed; SceneView view;
+    if (IsBinarySceneFile(input)) {
+        if (!mapped.Open(input) || !OpenSceneBinary(mapped, view)) { std::printf("Failed to read %s\n", input); return 1; }
+    } else {
+        if (!ReadSceneText(input, parsed)) { std::printf("Failed to read %s\n", input); return 1; }
+        view = parsed.View();
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(outputDir, ec);
+    if (ec) { std::printf("Cannot create %s: %s\n", outputDir.c_str(), ec.message().c_str()); return 1; }
+
+    WorldIndex index;
+    if (!PartitionScene(view, cellSize, outputDir, index)) { std::printf("Failed to write cells to %s\n", outputDir.c_str()); return 1; }
+    std::printf("%u objects -> %zu cells of %.1f units in %s\n", view.objectCount, index.cells.size(), cellSize, outputDir.c_str());
+    return 0;
+}
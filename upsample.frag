@@ -0,0 +1,41 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D screenTexture; // low resolution result
+uniform sampler2D sceneDepth;    // full resolution depth buffer
+uniform vec2 lowSize;            // screenTexture's size in texels
+uniform vec2 depthParams;        // projection[2][2], projection[3][2]
+uniform vec2 depthScale;         // part of sceneDepth the scene covers (dynamic resolution)
+
+// Depth buffer value to view distance (perspective projection)
+float viewDistance(vec2 uv)
+{
+    float ndc = texture(sceneDepth, uv * depthScale).r * 2.0 - 1.0;
+    return depthParams.y / (ndc + depthParams.x);
+}
+
+// Joint bilateral upsample: the four low resolution texels around the pixel, with bilinear
+// weights scaled down by how far their depth is from the pixel's, so a blur at low resolution
+// does not smear foreground over background
+void main()
+{
+    vec2 pos = TexCoords * lowSize - 0.5;
+    vec2 base = floor(pos);
+    vec2 f = pos - base;
+    float center = viewDistance(TexCoords);
+
+    vec3 sum = vec3(0.0);
+    float total = 0.0;
+    for (int y = 0; y < 2; y++) {
+        for (int x = 0; x < 2; x++) {
+            vec2 uv = (base + vec2(x, y) + 0.5) / lowSize;
+            float w = (x == 1 ? f.x : 1.0 - f.x) * (y == 1 ? f.y : 1.0 - f.y);
+            w *= 1.0 / (0.01 + abs(viewDistance(uv) - center) / center);
+            sum += texture(screenTexture, uv).rgb * w;
+            total += w;
+        }
+    }
+    FragColor = vec4(total > 0.0 ? sum / total : texture(screenTexture, TexCoords).rgb, 1.0);
+}
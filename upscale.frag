@@ -0,0 +1,78 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D screenTexture; // the scene, drawn into its lower left renderSize texels
+uniform vec2 renderSize;
+
+// Edge-adaptive upscale after FSR1's EASU: a 12-tap Lanczos-2 window around the pixel, stretched
+// along the local edge direction and narrowed across it, then clamped to the nearest four texels
+// so the negative lobes cannot ring.
+
+float luma(vec3 c) { return dot(c, vec3(0.299, 0.587, 0.114)); }
+
+vec3 fetch(vec2 p) { return texelFetch(screenTexture, ivec2(clamp(p, vec2(0.0), renderSize - 1.0)), 0).rgb; }
+
+// Lanczos-2 approximation on the squared distance; 'lobe' sets the negative lobe (0.25 sharp .. 0.5 soft)
+float lanczos2(float x2, float lobe)
+{
+    x2 = min(x2, 1.0 / lobe);
+    float a = 2.0 / 5.0 * x2 - 1.0;
+    float b = lobe * x2 - 1.0;
+    a *= a;
+    b *= b;
+    return (25.0 / 16.0 * a - (25.0 / 16.0 - 1.0)) * b;
+}
+
+void main()
+{
+    if (renderSize == vec2(textureSize(screenTexture, 0))) { // full scale: nothing to reconstruct
+        FragColor = vec4(texelFetch(screenTexture, ivec2(gl_FragCoord.xy), 0).rgb, 1.0);
+        return;
+    }
+    vec2 pos = TexCoords * renderSize - 0.5;
+    vec2 base = floor(pos);
+    vec2 f = pos - base;
+
+    //      b c
+    //    e f g h
+    //    i j k l
+    //      n o
+    vec3 b = fetch(base + vec2(0, -1)), c = fetch(base + vec2(1, -1));
+    vec3 e = fetch(base + vec2(-1, 0)), fc = fetch(base), g = fetch(base + vec2(1, 0)), h = fetch(base + vec2(2, 0));
+    vec3 i = fetch(base + vec2(-1, 1)), j = fetch(base + vec2(0, 1)), k = fetch(base + vec2(1, 1)), l = fetch(base + vec2(2, 1));
+    vec3 n = fetch(base + vec2(0, 2)), o = fetch(base + vec2(1, 2));
+    float lb = luma(b), lc = luma(c), le = luma(e), lf = luma(fc), lg = luma(g), lh = luma(h);
+    float li = luma(i), lj = luma(j), lk = luma(k), ll = luma(l), ln = luma(n), lo = luma(o);
+
+    // Edge direction and strength from the gradients at the four center texels, bilinearly weighted
+    vec4 w = vec4((1.0 - f.x) * (1.0 - f.y), f.x * (1.0 - f.y), (1.0 - f.x) * f.y, f.x * f.y);
+    vec2 dir = w.x * vec2(lg - le, lj - lb) + w.y * vec2(lh - lf, lk - lc) + w.z * vec2(lk - li, ln - lf) + w.w * vec2(ll - lj, lo - lg);
+    float range = max(max(max(lf, lg), max(lj, lk)), max(max(lb, lc), max(le, lh))) - min(min(min(lf, lg), min(lj, lk)), min(min(lb, lc), min(le, lh)));
+    float len = clamp(length(dir) / max(range, 1.0 / 255.0), 0.0, 1.0);
+    len *= len;
+    dir = dot(dir, dir) > 1e-8 ? normalize(dir) : vec2(1.0, 0.0);
+
+    // Distances across the edge (along the gradient) count more, along it less: the window
+    // narrows across the edge and widens along it
+    float stretch = 1.0 / max(abs(dir.x), abs(dir.y));
+    vec2 axis = vec2(1.0 + (stretch - 1.0) * len, 1.0 - 0.5 * len);
+    float lobe = 0.5 - 0.29 * len;
+
+    vec2 offsets[12] = vec2[](vec2(0, -1), vec2(1, -1), vec2(-1, 0), vec2(0, 0), vec2(1, 0), vec2(2, 0),
+                              vec2(-1, 1), vec2(0, 1), vec2(1, 1), vec2(2, 1), vec2(0, 2), vec2(1, 2));
+    vec3 colors[12] = vec3[](b, c, e, fc, g, h, i, j, k, l, n, o);
+    vec3 sum = vec3(0.0);
+    float total = 0.0;
+    for (int t = 0; t < 12; t++) {
+        vec2 d = offsets[t] - f;
+        vec2 v = vec2(dot(d, dir), dot(d, vec2(-dir.y, dir.x))) * axis; // (across the edge, along it)
+        float weight = lanczos2(dot(v, v), lobe);
+        sum += colors[t] * weight;
+        total += weight;
+    }
+    vec3 result = sum / total;
+    result = clamp(result, min(min(fc, g), min(j, k)), max(max(fc, g), max(j, k)));
+    FragColor = vec4(result, 1.0);
+}